@@ -0,0 +1,294 @@
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <stdlib.h>
+// slcan
+#include "slcan.h"
+#include "slcan_master.h"
+#include "slcan_slave.h"
+#include "slcan_utils.h"
+#include "slcan_port_loopback.h"
+
+
+// Число передаваемых фреймов без эмуляции линии.
+#define FRAMES_COUNT 1000000
+
+// Число фреймов в пакете при пакетной передаче.
+#define BATCH_SIZE 32
+
+// Число передаваемых фреймов при эмуляции линии.
+#define EMU_FRAMES_COUNT 2000
+
+// Число измерений времени приёма-передачи.
+#define ROUNDS_COUNT 10000
+
+// Число измерений времени приёма-передачи при эмуляции линии.
+#define EMU_ROUNDS_COUNT 100
+
+// Эмулируемая скорость линии.
+#define EMU_BAUD_RATE 3000000
+
+// Эмулируемая задержка линии, нс.
+#define EMU_LATENCY_NS 50000
+
+// Эмулируемая задержка линии с буферизацией (USB), нс.
+#define EMU_USB_LATENCY_NS 2000000
+
+// Размер буфера запросов при адаптивном окне.
+#define WINDOW_MAX_SIZE 256
+
+
+//! Соединённые ведущее и ведомое устройства.
+typedef struct _Bench_Pair {
+    slcan_loopback_t lb; //!< Соединение.
+    slcan_t master_sc; //!< Интерфейс ведущего.
+    slcan_t slave_sc; //!< Интерфейс ведомого.
+    slcan_master_t master; //!< Ведущее устройство.
+    slcan_slave_t slave; //!< Ведомое устройство.
+} bench_pair_t;
+
+
+static int init_pair(bench_pair_t* pair, uint32_t baud_rate, uint64_t latency_ns)
+{
+    slcan_loopback_init(&pair->lb, baud_rate, latency_ns);
+
+    if(slcan_init(&pair->master_sc) != 0 || slcan_init(&pair->slave_sc) != 0){
+        printf("Cann't init slcan!\n");
+        return -1;
+    }
+
+    if(slcan_open_port(&pair->master_sc, SLCAN_LOOPBACK_PORT_A, &slcan_loopback_ops, &pair->lb) != 0 ||
+       slcan_open_port(&pair->slave_sc, SLCAN_LOOPBACK_PORT_B, &slcan_loopback_ops, &pair->lb) != 0){
+        printf("Cann't open loopback port!\n");
+        return -1;
+    }
+
+    if(slcan_master_init(&pair->master, &pair->master_sc) != 0 ||
+       slcan_slave_init(&pair->slave, &pair->slave_sc, NULL) != 0){
+        printf("Error init slcan master and slave!\n");
+        return -1;
+    }
+
+    slcan_slave_set_flags(&pair->slave,
+            slcan_slave_flags(&pair->slave) |
+            SLCAN_SLAVE_FLAG_OPENED |
+            SLCAN_SLAVE_FLAG_AUTO_POLL);
+
+    return 0;
+}
+
+static void deinit_pair(bench_pair_t* pair)
+{
+    slcan_master_deinit(&pair->master);
+    slcan_slave_deinit(&pair->slave);
+
+    slcan_close(&pair->master_sc);
+    slcan_close(&pair->slave_sc);
+
+    slcan_deinit(&pair->master_sc);
+    slcan_deinit(&pair->slave_sc);
+
+    slcan_loopback_deinit(&pair->lb);
+}
+
+static int poll_pair(bench_pair_t* pair)
+{
+    slcan_err_t err;
+
+    err = slcan_master_poll(&pair->master);
+    if(err != E_SLCAN_NO_ERROR && err != E_SLCAN_OVERFLOW && err != E_SLCAN_OVERRUN){
+        printf("slcan master err: %d\n", (int)err);
+        return -1;
+    }
+
+    err = slcan_slave_poll(&pair->slave);
+    if(err != E_SLCAN_NO_ERROR && err != E_SLCAN_OVERFLOW && err != E_SLCAN_OVERRUN){
+        printf("slcan slave err: %d\n", (int)err);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void make_can_msg(slcan_can_msg_t* msg, size_t n)
+{
+    size_t i;
+
+    msg->frame_type = SLCAN_CAN_FRAME_NORMAL;
+    msg->id_type = SLCAN_CAN_ID_NORMAL;
+    msg->id = n & 0x7ff;
+    msg->dlc = 8;
+    for(i = 0; i < 8; i ++){
+        msg->data[i] = (n + i) & 0xff;
+    }
+}
+
+static uint64_t timespec_to_ns(const struct timespec* tp)
+{
+    return (uint64_t)tp->tv_sec * 1000000000ULL + (uint64_t)tp->tv_nsec;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec tp;
+
+    slcan_clock_gettime(&tp);
+
+    return timespec_to_ns(&tp);
+}
+
+
+// batch_size - 0 для передачи по одному фрейму.
+// adaptive - адаптивное окно запросов до WINDOW_MAX_SIZE.
+// clock_source - источник времени интерфейсов.
+static int run_throughput(const char* name, uint32_t baud_rate, uint64_t latency_ns, size_t frames_count, size_t batch_size, bool adaptive,
+                          slcan_clock_source_t clock_source)
+{
+    static bench_pair_t pair;
+    static slcan_resp_out_t resp_buf[WINDOW_MAX_SIZE];
+
+    if(init_pair(&pair, baud_rate, latency_ns) != 0) return -1;
+
+    if(slcan_set_clock_source(&pair.master_sc, clock_source) != E_SLCAN_NO_ERROR ||
+       slcan_set_clock_source(&pair.slave_sc, clock_source) != E_SLCAN_NO_ERROR){
+        printf("%s: clock source is not supported\n", name);
+        deinit_pair(&pair);
+        return 0;
+    }
+
+    if(adaptive){
+        slcan_master_set_resp_buffer(&pair.master, resp_buf, WINDOW_MAX_SIZE);
+        slcan_master_set_window(&pair.master, SLCAN_RESP_OUT_FIFO_SIZE);
+        slcan_master_set_window_adaptive(&pair.master, true);
+    }
+
+    slcan_can_msg_t can_msg;
+    slcan_can_msg_t can_msgs[BATCH_SIZE];
+    size_t sent = 0, received = 0;
+    size_t batch_sent, i;
+    int res = 0;
+
+    uint64_t start_ns = now_ns();
+
+    while(received < frames_count){
+        if(batch_size == 0){
+            while(sent < frames_count && slcan_master_send_can_msgs_avail(&pair.master) != 0){
+                make_can_msg(&can_msg, sent);
+                slcan_master_send_can_msg(&pair.master, &can_msg, NULL);
+                sent ++;
+            }
+        }else{
+            for(batch_sent = 1; sent < frames_count && batch_sent != 0; sent += batch_sent){
+                batch_size = MIN(batch_size, frames_count - sent);
+                for(i = 0; i < batch_size; i ++){
+                    make_can_msg(&can_msgs[i], sent + i);
+                }
+                slcan_master_send_can_msgs(&pair.master, can_msgs, batch_size, &batch_sent, NULL);
+            }
+        }
+
+        if(poll_pair(&pair) != 0){
+            res = -1;
+            break;
+        }
+
+        while(slcan_slave_recv_can_msg(&pair.slave, &can_msg) == E_SLCAN_NO_ERROR){
+            received ++;
+        }
+    }
+
+    uint64_t time_ns = now_ns() - start_ns;
+
+    printf("%s: frames %u, time %u.%06u s, %.3f Mframes/s, %.1f ns/frame, window %u\n",
+           name, (unsigned int)received,
+           (unsigned int)(time_ns / 1000000000ULL), (unsigned int)((time_ns % 1000000000ULL) / 1000),
+           (double)received * 1000.0 / (double)(time_ns ? time_ns : 1),
+           (double)time_ns / (double)(received ? received : 1),
+           (unsigned int)slcan_master_window(&pair.master));
+
+    deinit_pair(&pair);
+
+    return res;
+}
+
+static int run_latency(const char* name, uint32_t baud_rate, uint64_t latency_ns, size_t rounds_count)
+{
+    static bench_pair_t pair;
+
+    if(init_pair(&pair, baud_rate, latency_ns) != 0) return -1;
+
+    slcan_can_msg_t can_msg;
+    uint64_t start_ns, rtt_ns;
+    uint64_t min_ns = UINT64_MAX, max_ns = 0, sum_ns = 0;
+    size_t rounds;
+    bool done;
+
+    for(rounds = 0; rounds < rounds_count; rounds ++){
+        make_can_msg(&can_msg, rounds);
+
+        start_ns = now_ns();
+
+        slcan_master_send_can_msg(&pair.master, &can_msg, NULL);
+
+        // master -> slave -> master.
+        for(done = false; !done;){
+            if(poll_pair(&pair) != 0) return -1;
+
+            while(slcan_slave_recv_can_msg(&pair.slave, &can_msg) == E_SLCAN_NO_ERROR){
+                slcan_slave_send_can_msg(&pair.slave, &can_msg, NULL);
+            }
+
+            while(slcan_master_recv_can_msg(&pair.master, &can_msg, NULL) == E_SLCAN_NO_ERROR){
+                done = true;
+            }
+        }
+
+        rtt_ns = now_ns() - start_ns;
+
+        min_ns = MIN(min_ns, rtt_ns);
+        max_ns = MAX(max_ns, rtt_ns);
+        sum_ns += rtt_ns;
+    }
+
+    printf("%s: rounds %u, rtt min %u ns, avg %u ns, max %u ns\n",
+           name, (unsigned int)rounds,
+           (unsigned int)min_ns, (unsigned int)(sum_ns / (rounds ? rounds : 1)), (unsigned int)max_ns);
+
+    deinit_pair(&pair);
+
+    return 0;
+}
+
+
+int main_bench_loopback(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    // library cost only.
+    if(run_throughput("loopback", 0, 0, FRAMES_COUNT, 0, false, SLCAN_CLOCK_SOURCE_MONOTONIC) != 0) return -1;
+    if(run_throughput("loopback batch", 0, 0, FRAMES_COUNT, BATCH_SIZE, false, SLCAN_CLOCK_SOURCE_MONOTONIC) != 0) return -1;
+    if(run_throughput("loopback, coarse clock", 0, 0, FRAMES_COUNT, 0, false, SLCAN_CLOCK_SOURCE_COARSE) != 0) return -1;
+    if(run_throughput("loopback, tsc clock", 0, 0, FRAMES_COUNT, 0, false, SLCAN_CLOCK_SOURCE_TSC) != 0) return -1;
+    if(run_latency("loopback", 0, 0, ROUNDS_COUNT) != 0) return -1;
+    // emulated line.
+    if(run_throughput("3 Mbaud", EMU_BAUD_RATE, 0, EMU_FRAMES_COUNT, 0, false, SLCAN_CLOCK_SOURCE_MONOTONIC) != 0) return -1;
+    if(run_throughput("3 Mbaud batch", EMU_BAUD_RATE, 0, EMU_FRAMES_COUNT, BATCH_SIZE, false, SLCAN_CLOCK_SOURCE_MONOTONIC) != 0) return -1;
+    if(run_throughput("3 Mbaud, 2 ms", EMU_BAUD_RATE, EMU_USB_LATENCY_NS, EMU_FRAMES_COUNT, 0, false, SLCAN_CLOCK_SOURCE_MONOTONIC) != 0) return -1;
+    if(run_throughput("3 Mbaud, 2 ms, adaptive", EMU_BAUD_RATE, EMU_USB_LATENCY_NS, EMU_FRAMES_COUNT, 0, true, SLCAN_CLOCK_SOURCE_MONOTONIC) != 0) return -1;
+    if(run_latency("3 Mbaud, 50 us", EMU_BAUD_RATE, EMU_LATENCY_NS, EMU_ROUNDS_COUNT) != 0) return -1;
+
+    printf("Done.\n");
+
+    return 0;
+}
+
+#if defined(EXAMPLE_BENCH_LOOPBACK) && EXAMPLE_BENCH_LOOPBACK == 1
+int main(int argc, char* argv[])
+{
+    return main_bench_loopback(argc, argv);
+}
+#endif
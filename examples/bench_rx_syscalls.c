@@ -0,0 +1,212 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+// slcan
+#include "slcan.h"
+#include "slcan_utils.h"
+
+
+// Число передаваемых фреймов.
+#define FRAMES_COUNT 10000
+
+// Передаваемый фрейм.
+#define FRAME "t1238AABBCCDDEEFF0011\r"
+
+// Число фреймов в блоке записи.
+#define WRITE_CHUNK_FRAMES 8
+
+// Пауза между блоками записи (эмуляция скорости линии), мкс.
+#define WRITE_CHUNK_DELAY_US 200
+
+// Размер большого буфера приёма.
+#define BIG_RXBUF_SIZE 65536
+
+// Число вызовов ввода-вывода выводится
+// при сборке с SLCAN_IO_STATS=1.
+#if defined(SLCAN_IO_STATS) && SLCAN_IO_STATS == 1
+#define BENCH_IO_STATS 1
+#else
+#define BENCH_IO_STATS 0
+#endif
+
+
+//! Параметры потока записи.
+typedef struct _Writer {
+    int fd; //!< Ведущая сторона псевдотерминала.
+    size_t frames_count; //!< Число фреймов.
+} writer_t;
+
+
+static void* writer_thread(void* arg)
+{
+    writer_t* writer = (writer_t*)arg;
+
+    const size_t frame_size = sizeof(FRAME) - 1;
+    const size_t frames_per_chunk = WRITE_CHUNK_FRAMES;
+
+    char buf[WRITE_CHUNK_FRAMES * (sizeof(FRAME) - 1)];
+
+    size_t frames = 0;
+    size_t n, i, size, written;
+    ssize_t res;
+
+    while(frames < writer->frames_count){
+        n = MIN(frames_per_chunk, writer->frames_count - frames);
+
+        for(i = 0; i < n; i ++){
+            memcpy(&buf[i * frame_size], FRAME, frame_size);
+        }
+
+        size = n * frame_size;
+        written = 0;
+
+        while(written < size){
+            res = write(writer->fd, &buf[written], size - written);
+            if(res < 0) return NULL;
+            written += (size_t)res;
+        }
+
+        frames += n;
+
+        usleep(WRITE_CHUNK_DELAY_US);
+    }
+
+    return NULL;
+}
+
+
+static int run_bench(const char* name, slcan_port_caps_t caps, uint8_t* rxbuf, size_t rxbuf_size)
+{
+    static slcan_t sc;
+
+    int master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if(master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0){
+        printf("Cann't open pty!\n");
+        return -1;
+    }
+
+    if(slcan_init(&sc) != 0){
+        printf("Cann't init slcan!\n");
+        close(master_fd);
+        return -1;
+    }
+
+    if(slcan_open(&sc, ptsname(master_fd)) != 0){
+        printf("Cann't open serial port: %s\n", ptsname(master_fd));
+        close(master_fd);
+        return -1;
+    }
+
+    slcan_port_conf_t port_conf;
+    slcan_get_default_port_config(&port_conf);
+
+    if(slcan_configure(&sc, &port_conf) != 0){
+        printf("Error configuring serial port!\n");
+        slcan_close(&sc);
+        close(master_fd);
+        return -1;
+    }
+
+    if(slcan_set_io_buffers(&sc, NULL, 0, rxbuf, rxbuf_size) != E_SLCAN_NO_ERROR){
+        printf("Error setting io buffers!\n");
+        slcan_close(&sc);
+        close(master_fd);
+        return -1;
+    }
+
+    slcan_set_port_caps(&sc, caps & slcan_port_caps(&sc));
+#if BENCH_IO_STATS == 1
+    slcan_io_stats_reset(&sc);
+#endif
+
+    writer_t writer;
+    writer.fd = master_fd;
+    writer.frames_count = FRAMES_COUNT;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, writer_thread, &writer);
+
+    struct timespec tp_start, tp_cur;
+    struct timespec tp_timeout = {1, 0};
+
+    slcan_cmd_t cmd;
+    slcan_err_t err;
+    size_t frames = 0;
+
+    slcan_clock_gettime(&tp_start);
+
+    while(frames < FRAMES_COUNT){
+        err = slcan_wait(&sc, &tp_timeout);
+        if(err != E_SLCAN_NO_ERROR){
+            printf("slcan wait err: %d\n", (int)err);
+            break;
+        }
+
+        while(slcan_get_cmd(&sc, &cmd) == E_SLCAN_NO_ERROR){
+            frames ++;
+        }
+    }
+
+    slcan_clock_gettime(&tp_cur);
+    slcan_timespec_sub(&tp_cur, &tp_start, &tp_cur);
+
+    pthread_join(thread, NULL);
+
+#if BENCH_IO_STATS == 1
+    slcan_io_stats_t* stats = slcan_io_stats(&sc);
+    unsigned long syscalls = stats->reads + stats->nbytes + stats->polls;
+
+    printf("%s: frames %u, reads %lu, ioctls %lu, polls %lu, "
+           "syscalls %lu (%.2f per 10k frames), time %u.%06u s\n",
+           name, (unsigned int)frames,
+           stats->reads, stats->nbytes, stats->polls,
+           syscalls, (double)syscalls * 10000.0 / (frames ? frames : 1),
+           (unsigned int)tp_cur.tv_sec, (unsigned int)(tp_cur.tv_nsec / 1000));
+#else
+    printf("%s: frames %u, time %u.%06u s (no SLCAN_IO_STATS)\n",
+           name, (unsigned int)frames,
+           (unsigned int)tp_cur.tv_sec, (unsigned int)(tp_cur.tv_nsec / 1000));
+#endif
+
+    slcan_close(&sc);
+    slcan_deinit(&sc);
+
+    close(master_fd);
+
+    return 0;
+}
+
+
+int main_bench_rx_syscalls(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    static uint8_t big_rxbuf[BIG_RXBUF_SIZE];
+
+    // TIOCINQ before every read.
+    if(run_bench("nbytes + read", SLCAN_PORT_CAP_NONE, NULL, 0) != 0) return -1;
+    // read until EAGAIN.
+    if(run_bench("nonblock read", SLCAN_PORT_CAP_NONBLOCK_READ, NULL, 0) != 0) return -1;
+    // read until EAGAIN into big fifo.
+    if(run_bench("nonblock read, 64 KiB fifo", SLCAN_PORT_CAP_NONBLOCK_READ, big_rxbuf, BIG_RXBUF_SIZE) != 0) return -1;
+
+    printf("Done.\n");
+
+    return 0;
+}
+
+#if defined(EXAMPLE_BENCH_RX_SYSCALLS) && EXAMPLE_BENCH_RX_SYSCALLS == 1
+int main(int argc, char* argv[])
+{
+    return main_bench_rx_syscalls(argc, argv);
+}
+#endif
@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <stdlib.h>
+// slcan
+#include "slcan.h"
+#include "slcan_utils.h"
+#include "slcan_scan.h"
+
+
+// Размер блока принятых данных.
+#define BLOCK_SIZE 4096
+
+// Максимальное число концов команд в блоке.
+#define ENDS_MAX BLOCK_SIZE
+
+// Число проходов по блоку.
+#define ROUNDS_COUNT 20000
+
+
+//! Реализация поиска.
+typedef struct _Bench_Scan_Impl {
+    const char* name; //!< Имя.
+    slcan_scan_ends_t scan; //!< Функция поиска.
+} bench_scan_impl_t;
+
+
+// Цикл, который выполнялся при приёме до поиска границ блоком.
+static size_t scan_ends_bytewise(const uint8_t* data, size_t size, size_t* ends, size_t max)
+{
+    slcan_cmd_buf_t buf;
+    size_t count = 0;
+    size_t i;
+    uint8_t byte;
+
+    slcan_cmd_buf_init(&buf);
+
+    for(i = 0; i < size && count < max; i ++){
+        byte = data[i];
+
+        if(slcan_cmd_buf_put(&buf, byte) == 0){
+            slcan_cmd_buf_reset(&buf);
+        }
+
+        if(byte == SLCAN_EOM_BYTE || byte == SLCAN_ERR_BYTE){
+            ends[count ++] = i;
+            slcan_cmd_buf_reset(&buf);
+        }
+    }
+
+    return count;
+}
+
+// Поиск двумя вызовами memchr на команду.
+static size_t scan_ends_memchr(const uint8_t* data, size_t size, size_t* ends, size_t max)
+{
+    const uint8_t* eom;
+    const uint8_t* err;
+    size_t pos = 0;
+    size_t count = 0;
+    size_t line_size;
+
+    while(pos < size && count < max){
+        line_size = size - pos;
+
+        eom = (const uint8_t*)memchr(&data[pos], SLCAN_EOM_BYTE, line_size);
+        if(eom != NULL) line_size = (size_t)(eom - &data[pos]);
+
+        err = (const uint8_t*)memchr(&data[pos], SLCAN_ERR_BYTE, line_size);
+        if(err != NULL) eom = err;
+
+        if(eom == NULL) break;
+
+        ends[count ++] = (size_t)(eom - data);
+        pos = ends[count - 1] + 1;
+    }
+
+    return count;
+}
+
+
+// Заполняет блок потоком ответов на опрос всех сообщений.
+static void fill_block(uint8_t* block)
+{
+    static const char* frames[] = {
+        "t1238AABBCCDDEEFF0011\r",
+        "T1234567880011223344556677\r",
+        "t7FF0\r",
+        "r1230\r",
+        "\a",
+        "\r",
+    };
+
+    size_t pos = 0;
+    size_t i = 0;
+    size_t len;
+
+    while(pos < BLOCK_SIZE){
+        len = strlen(frames[i]);
+        len = MIN(len, BLOCK_SIZE - pos);
+
+        memcpy(&block[pos], frames[i], len);
+        pos += len;
+
+        i = (i + 1) % (sizeof(frames) / sizeof(frames[0]));
+    }
+}
+
+static void run_impl(const bench_scan_impl_t* impl, const uint8_t* block, size_t* ends, size_t ref_count, const size_t* ref_ends)
+{
+    struct timespec tp_start, tp_cur;
+    size_t count = 0;
+    size_t checksum = 0;
+    size_t i;
+
+    // check result.
+    count = impl->scan(block, BLOCK_SIZE, ends, ENDS_MAX);
+    if(count != ref_count || memcmp(ends, ref_ends, count * sizeof(size_t)) != 0){
+        printf("%s: wrong result!\n", impl->name);
+        return;
+    }
+
+    slcan_clock_gettime(&tp_start);
+
+    for(i = 0; i < ROUNDS_COUNT; i ++){
+        count = impl->scan(block, BLOCK_SIZE, ends, ENDS_MAX);
+        checksum += ends[count - 1];
+    }
+
+    slcan_clock_gettime(&tp_cur);
+    slcan_timespec_sub(&tp_cur, &tp_start, &tp_cur);
+
+    double ns = (double)tp_cur.tv_sec * 1e9 + (double)tp_cur.tv_nsec;
+    double bytes = (double)BLOCK_SIZE * ROUNDS_COUNT;
+
+    printf("%-8s: %u ends per block, %.1f ns per block, %.2f GB/s (%u)\n",
+           impl->name, (unsigned int)count,
+           ns / ROUNDS_COUNT, bytes / ns,
+           (unsigned int)(checksum & 0xff));
+}
+
+
+int main_bench_scan(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    static uint8_t block[BLOCK_SIZE];
+    static size_t ends[ENDS_MAX];
+    static size_t ref_ends[ENDS_MAX];
+
+    const bench_scan_impl_t impls[] = {
+        {"bytewise", scan_ends_bytewise},
+        {"memchr", scan_ends_memchr},
+        {"scalar", slcan_scan_ends_scalar},
+#if SLCAN_SCAN_X86 == 1
+        {"sse2", slcan_scan_ends_sse2},
+        {"avx2", slcan_scan_ends_avx2},
+#endif
+        {"dispatch", slcan_scan_ends},
+    };
+
+    size_t i;
+
+    fill_block(block);
+
+    size_t ref_count = slcan_scan_ends_scalar(block, BLOCK_SIZE, ref_ends, ENDS_MAX);
+
+    printf("Selected implementation: %s\n", slcan_scan_impl_name());
+
+    for(i = 0; i < sizeof(impls) / sizeof(impls[0]); i ++){
+#if SLCAN_SCAN_X86 == 1
+        if(impls[i].scan == slcan_scan_ends_avx2 && !__builtin_cpu_supports("avx2")) continue;
+#endif
+        run_impl(&impls[i], block, ends, ref_count, ref_ends);
+    }
+
+    printf("Done.\n");
+
+    return 0;
+}
+
+#if defined(EXAMPLE_BENCH_SCAN) && EXAMPLE_BENCH_SCAN == 1
+int main(int argc, char* argv[])
+{
+    return main_bench_scan(argc, argv);
+}
+#endif
@@ -0,0 +1,324 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+// slcan
+#include "slcan.h"
+#include "slcan_utils.h"
+#include "slcan_port_uring.h"
+
+
+// Число портов.
+#define PORTS_COUNT 4
+
+// Число фреймов, передаваемых в каждый порт.
+#define FRAMES_COUNT 10000
+
+// Передаваемый фрейм.
+#define FRAME "t1238AABBCCDDEEFF0011\r"
+
+// Число фреймов в блоке записи.
+#define WRITE_CHUNK_FRAMES 8
+
+// Пауза между блоками записи (эмуляция скорости линии), мкс.
+#define WRITE_CHUNK_DELAY_US 200
+
+// Вызовы чтения при ожидании через epoll
+// учитываются при сборке с SLCAN_IO_STATS=1.
+#if defined(SLCAN_IO_STATS) && SLCAN_IO_STATS == 1
+#define BENCH_IO_STATS 1
+#else
+#define BENCH_IO_STATS 0
+#endif
+
+
+//! Параметры потока записи.
+typedef struct _Writer {
+    int fds[PORTS_COUNT]; //!< Ведущие стороны псевдотерминалов.
+    size_t frames_count; //!< Число фреймов на порт.
+} writer_t;
+
+
+static void* writer_thread(void* arg)
+{
+    writer_t* writer = (writer_t*)arg;
+
+    const size_t frame_size = sizeof(FRAME) - 1;
+
+    char buf[WRITE_CHUNK_FRAMES * (sizeof(FRAME) - 1)];
+
+    size_t frames = 0;
+    size_t n, i, size, written;
+    ssize_t res;
+
+    for(i = 0; i < WRITE_CHUNK_FRAMES; i ++){
+        memcpy(&buf[i * frame_size], FRAME, frame_size);
+    }
+
+    while(frames < writer->frames_count){
+        n = MIN(WRITE_CHUNK_FRAMES, writer->frames_count - frames);
+        size = n * frame_size;
+
+        for(i = 0; i < PORTS_COUNT; i ++){
+            written = 0;
+
+            while(written < size){
+                res = write(writer->fds[i], &buf[written], size - written);
+                if(res < 0) return NULL;
+                written += (size_t)res;
+            }
+        }
+
+        frames += n;
+
+        usleep(WRITE_CHUNK_DELAY_US);
+    }
+
+    return NULL;
+}
+
+
+static int open_ptys(int* fds)
+{
+    size_t i;
+
+    for(i = 0; i < PORTS_COUNT; i ++){
+        fds[i] = posix_openpt(O_RDWR | O_NOCTTY);
+        if(fds[i] < 0 || grantpt(fds[i]) != 0 || unlockpt(fds[i]) != 0){
+            printf("Cann't open pty!\n");
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static void close_ptys(int* fds)
+{
+    size_t i;
+
+    for(i = 0; i < PORTS_COUNT; i ++){
+        close(fds[i]);
+    }
+}
+
+static int configure_slcan(slcan_t* sc)
+{
+    slcan_port_conf_t port_conf;
+    slcan_get_default_port_config(&port_conf);
+
+    if(slcan_configure(sc, &port_conf) != 0){
+        printf("Error configuring serial port!\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static void print_result(const char* name, size_t frames, unsigned long syscalls, const struct timespec* tp)
+{
+    printf("%s: frames %u, syscalls %lu (%.2f per 10k frames), time %u.%06u s\n",
+           name, (unsigned int)frames,
+           syscalls, (double)syscalls * 10000.0 / (frames ? frames : 1),
+           (unsigned int)tp->tv_sec, (unsigned int)(tp->tv_nsec / 1000));
+}
+
+
+// Все порты через epoll и чтение до EAGAIN.
+static int run_poller(void)
+{
+    static slcan_t sc[PORTS_COUNT];
+    static int revents[PORTS_COUNT];
+
+    writer_t writer;
+    slcan_poller_handle_t poller;
+    slcan_poller_event_t events[PORTS_COUNT];
+    size_t i, count;
+
+    if(open_ptys(writer.fds) != 0) return -1;
+
+    if(slcan_poller_open(&poller) == SLCAN_IO_FAIL){
+        printf("Cann't open poller!\n");
+        return -1;
+    }
+
+    for(i = 0; i < PORTS_COUNT; i ++){
+        slcan_init(&sc[i]);
+
+        if(slcan_open(&sc[i], ptsname(writer.fds[i])) != 0 || configure_slcan(&sc[i]) != 0){
+            printf("Cann't open serial port: %s\n", ptsname(writer.fds[i]));
+            return -1;
+        }
+
+        slcan_set_port_caps(&sc[i], SLCAN_PORT_CAP_NONBLOCK_READ & slcan_port_caps(&sc[i]));
+#if BENCH_IO_STATS == 1
+        slcan_io_stats_reset(&sc[i]);
+#endif
+
+        slcan_poller_add(poller, slcan_serial_port(&sc[i]), SLCAN_POLLIN, &revents[i]);
+        revents[i] = SLCAN_POLLIN;
+    }
+
+    writer.frames_count = FRAMES_COUNT;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, writer_thread, &writer);
+
+    struct timespec tp_start, tp_cur;
+    slcan_cmd_t cmd;
+    size_t frames = 0;
+    unsigned long waits = 0;
+
+    slcan_clock_gettime(&tp_start);
+
+    while(frames < FRAMES_COUNT * PORTS_COUNT){
+        if(slcan_poller_wait(poller, events, PORTS_COUNT, &count, 1000) == SLCAN_IO_FAIL) break;
+        waits ++;
+
+        for(i = 0; i < count; i ++){
+            *(int*)events[i].user_data |= events[i].revents & SLCAN_POLLIN;
+        }
+
+        for(i = 0; i < PORTS_COUNT; i ++){
+            if(slcan_process_io(&sc[i], &revents[i]) != E_SLCAN_NO_ERROR) break;
+
+            while(slcan_get_cmd(&sc[i], &cmd) == E_SLCAN_NO_ERROR){
+                frames ++;
+            }
+        }
+    }
+
+    slcan_clock_gettime(&tp_cur);
+    slcan_timespec_sub(&tp_cur, &tp_start, &tp_cur);
+
+    pthread_join(thread, NULL);
+
+    unsigned long syscalls = waits;
+
+    for(i = 0; i < PORTS_COUNT; i ++){
+#if BENCH_IO_STATS == 1
+        syscalls += slcan_io_stats(&sc[i])->reads;
+#endif
+
+        slcan_poller_del(poller, slcan_serial_port(&sc[i]));
+        slcan_close(&sc[i]);
+        slcan_deinit(&sc[i]);
+    }
+
+#if BENCH_IO_STATS == 1
+    print_result("epoll + read", frames, syscalls, &tp_cur);
+#else
+    print_result("epoll + read (no SLCAN_IO_STATS, waits only)", frames, syscalls, &tp_cur);
+#endif
+
+    slcan_poller_close(poller);
+    close_ptys(writer.fds);
+
+    return 0;
+}
+
+// Все порты через один io_uring_enter на итерацию.
+static int run_uring(void)
+{
+    static slcan_t sc[PORTS_COUNT];
+    static slcan_uring_port_t ports[PORTS_COUNT];
+    static slcan_uring_t uring;
+
+    writer_t writer;
+    size_t i;
+    int revents;
+
+    if(open_ptys(writer.fds) != 0) return -1;
+
+    if(slcan_uring_init(&uring) != E_SLCAN_NO_ERROR){
+        printf("Cann't init io_uring!\n");
+        close_ptys(writer.fds);
+        return -1;
+    }
+
+    for(i = 0; i < PORTS_COUNT; i ++){
+        slcan_init(&sc[i]);
+        slcan_uring_port_init(&ports[i], &uring, NULL, NULL);
+
+        if(slcan_uring_open(&sc[i], ptsname(writer.fds[i]), &ports[i]) != 0 || configure_slcan(&sc[i]) != 0){
+            printf("Cann't open serial port: %s\n", ptsname(writer.fds[i]));
+            return -1;
+        }
+    }
+
+    writer.frames_count = FRAMES_COUNT;
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, writer_thread, &writer);
+
+    struct timespec tp_start, tp_cur;
+    struct timespec tp_timeout = {1, 0};
+    slcan_cmd_t cmd;
+    size_t frames = 0;
+
+    slcan_clock_gettime(&tp_start);
+
+    while(frames < FRAMES_COUNT * PORTS_COUNT){
+        if(slcan_uring_run(&uring, &tp_timeout) != E_SLCAN_NO_ERROR) break;
+
+        for(i = 0; i < PORTS_COUNT; i ++){
+            revents = slcan_uring_port_revents(&ports[i]);
+            if(revents & SLCAN_POLLERR){
+                printf("port %u error!\n", (unsigned int)i);
+                frames = FRAMES_COUNT * PORTS_COUNT;
+                break;
+            }
+
+            if(slcan_process_io(&sc[i], &revents) != E_SLCAN_NO_ERROR) break;
+
+            while(slcan_get_cmd(&sc[i], &cmd) == E_SLCAN_NO_ERROR){
+                frames ++;
+            }
+        }
+    }
+
+    slcan_clock_gettime(&tp_cur);
+    slcan_timespec_sub(&tp_cur, &tp_start, &tp_cur);
+
+    pthread_join(thread, NULL);
+
+    print_result("io_uring", frames, slcan_uring_stats(&uring)->enters, &tp_cur);
+
+    for(i = 0; i < PORTS_COUNT; i ++){
+        slcan_close(&sc[i]);
+        slcan_deinit(&sc[i]);
+    }
+
+    slcan_uring_deinit(&uring);
+    close_ptys(writer.fds);
+
+    return 0;
+}
+
+
+int main_bench_uring(int argc, char* argv[])
+{
+    (void) argc;
+    (void) argv;
+
+    if(run_poller() != 0) return -1;
+    if(run_uring() != 0) return -1;
+
+    printf("Done.\n");
+
+    return 0;
+}
+
+#if defined(EXAMPLE_BENCH_URING) && EXAMPLE_BENCH_URING == 1
+int main(int argc, char* argv[])
+{
+    return main_bench_uring(argc, argv);
+}
+#endif
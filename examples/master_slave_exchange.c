@@ -43,6 +43,14 @@ static int init_slcan_master(slcan_master_t* scm, slcan_t* sc, const char* seria
         return -1;
     }
 
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    if(slcan_start_io_thread(sc) != 0){
+        printf("Error starting io thread!\n");
+        slcan_deinit(sc);
+        return -1;
+    }
+#endif
+
     if(slcan_master_init(scm, sc) != 0){
         printf("Error init slcan master!\n");
         slcan_deinit(sc);
@@ -120,6 +128,12 @@ static slcan_err_t on_setup_uart(slcan_port_baud_t baud, void* user_data)
     return E_SLCAN_NO_ERROR;
 }
 
+static slcan_err_t on_setup_uart_custom(uint32_t baud_rate, void* user_data)
+{
+    printf("setup uart custom: %u\n", (unsigned int)baud_rate);
+    return E_SLCAN_NO_ERROR;
+}
+
 static slcan_err_t on_set_acceptance_mask(uint32_t value, void* user_data)
 {
     printf("acceptance mask: 0x%08x\n", (unsigned int)value);
@@ -191,6 +205,7 @@ int main_master_slave_exchange(int argc, char* argv[])
     scb.on_listen = on_listen;
     scb.on_close = on_close;
     scb.on_setup_uart = on_setup_uart;
+    scb.on_setup_uart_custom = on_setup_uart_custom;
     scb.on_set_acceptance_mask = on_set_acceptance_mask;
     scb.on_set_acceptance_filter = on_set_acceptance_filter;
 
@@ -245,6 +260,7 @@ int main_master_slave_exchange(int argc, char* argv[])
     slcan_master_cmd_read_version(&master, &hw_ver, &sw_ver, NULL);
     slcan_master_cmd_read_sn(&master, &sn, NULL);
     slcan_master_cmd_setup_uart(&master, SLCAN_PORT_BAUD_115200, NULL);
+    slcan_master_cmd_setup_uart_custom(&master, 500000, NULL);
     slcan_master_cmd_setup_can_std(&master, SLCAN_BIT_RATE_250Kbit, NULL);
     slcan_master_cmd_setup_can_btr(&master, 0x12, 0x34, NULL);
     slcan_master_cmd_set_auto_poll(&master, false, NULL);
@@ -272,12 +288,10 @@ int main_master_slave_exchange(int argc, char* argv[])
     struct timespec ts;
     ts.tv_sec = 0; ts.tv_nsec = 1000000; // 1 ms.
     while(--max_polls != 0){
-        slcan_master_poll(&master);
-        slcan_slave_poll(&slave);
+        slcan_master_wait(&master, &ts);
+        slcan_slave_wait(&slave, &ts);
 
         if(slcan_future_done(&future_master) && slcan_future_done(&future_slave)) break;
-
-        nanosleep(&ts, NULL);
     }
 
     printf("future master done: %u result: %d\n", (unsigned int)slcan_future_done(&future_master), SLCAN_FUTURE_RESULT_INT(slcan_future_result(&future_master)));
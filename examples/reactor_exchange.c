@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <stdlib.h>
+// slcan
+#include "slcan.h"
+#include "slcan_master.h"
+#include "slcan_slave.h"
+#include "slcan_reactor.h"
+#include "slcan_utils.h"
+
+
+#ifdef __linux
+// socat -d -d pty,rawer,echo=0,link=/tmp/ttyV0,perm=0777 pty,rawer,echo=0,link=/tmp/ttyV1,perm=0777
+#define MASTER_TTY "/tmp/ttyV0"
+#define SLAVE_TTY "/tmp/ttyV1"
+#else
+// cygwin + com0com
+#define MASTER_TTY "/dev/ttyS20"
+#define SLAVE_TTY "/dev/ttyS21"
+#endif
+
+
+// Максимальное число пар ведущий - ведомый.
+#define PAIRS_MAX (SLCAN_REACTOR_SIZE / 2)
+
+// Число сообщений, передаваемых каждым ведущим.
+#define MSGS_COUNT 1000
+
+
+static int init_slcan(slcan_t* sc, const char* serial_port_name)
+{
+    if(slcan_init(sc) != 0){
+        printf("Cann't init slcan!\n");
+        return -1;
+    }
+
+    if(slcan_open(sc, serial_port_name) != 0){
+        printf("Cann't open serial port: %s\n", serial_port_name);
+        return -1;
+    }
+
+    slcan_port_conf_t port_conf;
+    slcan_get_default_port_config(&port_conf);
+
+    if(slcan_configure(sc, &port_conf) != 0){
+        printf("Error configuring serial port!\n");
+        slcan_deinit(sc);
+        return -1;
+    }
+
+    return 0;
+}
+
+
+static void on_error(slcan_t* sc, slcan_err_t err, void* user_data)
+{
+    (void) sc;
+    (void) user_data;
+
+    printf("slcan error: %d\n", (int)err);
+}
+
+
+static void gen_can_msg(slcan_can_msg_t* msg)
+{
+    if(msg == NULL) return;
+
+    size_t dlc = rand() % 9;
+
+    size_t i;
+
+    msg->frame_type = SLCAN_CAN_FRAME_NORMAL;
+    msg->id_type = SLCAN_CAN_ID_NORMAL;
+    msg->id = rand() % 0x7ff;
+    msg->dlc = dlc;
+    for(i = 0; i < dlc; i ++){
+        msg->data[i] = rand() & 0xff;
+    }
+}
+
+
+int main_reactor_exchange(int argc, char* argv[])
+{
+    srand(time(NULL));
+
+    static slcan_t master_slcan[PAIRS_MAX];
+    static slcan_t slave_slcan[PAIRS_MAX];
+
+    static slcan_master_t master[PAIRS_MAX];
+    static slcan_slave_t slave[PAIRS_MAX];
+
+    static slcan_reactor_t reactor;
+
+    static size_t sent[PAIRS_MAX];
+    static size_t received[PAIRS_MAX];
+
+    // master0 slave0 [master1 slave1 ...].
+    size_t pairs_count = (argc > 2) ? (size_t)(argc - 1) / 2 : 1;
+    if(pairs_count > PAIRS_MAX) pairs_count = PAIRS_MAX;
+
+    if(slcan_reactor_init(&reactor) != E_SLCAN_NO_ERROR){
+        printf("Error init reactor!\n");
+        return -1;
+    }
+
+    slcan_reactor_set_on_error(&reactor, on_error, NULL);
+
+    size_t i;
+
+    for(i = 0; i < pairs_count; i ++){
+        const char* master_serial_port_name = (argc > 2) ? argv[1 + i * 2] : MASTER_TTY;
+        const char* slave_serial_port_name = (argc > 2) ? argv[2 + i * 2] : SLAVE_TTY;
+
+        if(init_slcan(&master_slcan[i], master_serial_port_name) == -1 ||
+           init_slcan(&slave_slcan[i], slave_serial_port_name) == -1){
+            printf("Error init slcan pair %u!\n", (unsigned int)i);
+            return -1;
+        }
+
+        slcan_master_init(&master[i], &master_slcan[i]);
+        slcan_slave_init(&slave[i], &slave_slcan[i], NULL);
+
+        slcan_slave_set_flags(&slave[i],
+                slcan_slave_flags(&slave[i]) |
+                SLCAN_SLAVE_FLAG_OPENED);
+
+        if(slcan_reactor_add_master(&reactor, &master[i]) != E_SLCAN_NO_ERROR ||
+           slcan_reactor_add_slave(&reactor, &slave[i]) != E_SLCAN_NO_ERROR){
+            printf("Error add slcan pair %u to reactor!\n", (unsigned int)i);
+            return -1;
+        }
+
+        sent[i] = 0;
+        received[i] = 0;
+    }
+
+    printf("Polling %u pairs...\n", (unsigned int)pairs_count);
+
+    struct timespec tp_start, tp_end, tp_cur;
+    struct timespec tp_timeout = {0, 100000000}; // 100 ms.
+    struct timespec tp_total = {10, 0}; // 10 s.
+
+    slcan_clock_gettime(&tp_start);
+    slcan_timespec_add(&tp_start, &tp_total, &tp_end);
+
+    slcan_can_msg_t can_msg;
+    size_t done;
+
+    for(;;){
+        done = 0;
+
+        for(i = 0; i < pairs_count; i ++){
+            // fill master tx fifo,
+            // messages are queued while there is space.
+            while(sent[i] < MSGS_COUNT && slcan_master_send_can_msgs_avail(&master[i]) != 0){
+                gen_can_msg(&can_msg);
+                slcan_master_send_can_msg(&master[i], &can_msg, NULL);
+                sent[i] ++;
+            }
+
+            // count messages received by slave.
+            while(slcan_slave_recv_can_msg(&slave[i], &can_msg) == E_SLCAN_NO_ERROR){
+                received[i] ++;
+            }
+
+            if(received[i] >= MSGS_COUNT) done ++;
+        }
+
+        if(done == pairs_count) break;
+
+        slcan_clock_gettime(&tp_cur);
+        if(slcan_timespec_cmp(&tp_cur, &tp_end, >)) break;
+
+        slcan_reactor_run_once(&reactor, &tp_timeout);
+    }
+
+    slcan_clock_gettime(&tp_cur);
+    slcan_timespec_sub(&tp_cur, &tp_start, &tp_cur);
+
+    for(i = 0; i < pairs_count; i ++){
+        printf("pair %u: sent %u received %u\n", (unsigned int)i, (unsigned int)sent[i], (unsigned int)received[i]);
+    }
+    printf("time: %u.%06u s\n", (unsigned int)tp_cur.tv_sec, (unsigned int)(tp_cur.tv_nsec / 1000));
+
+    printf("Done.\n");
+
+    for(i = 0; i < pairs_count; i ++){
+        slcan_reactor_remove(&reactor, &master_slcan[i]);
+        slcan_reactor_remove(&reactor, &slave_slcan[i]);
+
+        slcan_master_deinit(&master[i]);
+        slcan_slave_deinit(&slave[i]);
+
+        slcan_close(&master_slcan[i]);
+        slcan_close(&slave_slcan[i]);
+
+        slcan_deinit(&master_slcan[i]);
+        slcan_deinit(&slave_slcan[i]);
+    }
+
+    slcan_reactor_deinit(&reactor);
+
+    return 0;
+}
+
+#if defined(EXAMPLE_REACTOR_EXCHANGE) && EXAMPLE_REACTOR_EXCHANGE == 1
+int main(int argc, char* argv[])
+{
+    return main_reactor_exchange(argc, argv);
+}
+#endif
@@ -135,13 +135,11 @@ int main_slave_loopback(int argc, char* argv[])
     struct timespec ts;
     ts.tv_sec = 0; ts.tv_nsec = 1000000; // 1 ms.
     while(--max_polls != 0){
-        slcan_slave_poll(&slave);
+        slcan_slave_wait(&slave, &ts);
 
         while(slcan_slave_recv_can_msg(&slave, &can_msg) == E_SLCAN_NO_ERROR){
             slcan_slave_send_can_msg(&slave, &can_msg, NULL);
         }
-
-        nanosleep(&ts, NULL);
     }
 
     printf("Done.\n");
@@ -0,0 +1,110 @@
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <stdlib.h>
+// slcan
+#include "slcan.h"
+#include "slcan_slave.h"
+#include "slcan_port_socket.h"
+
+
+// Адрес сервера по-умолчанию.
+#define SERVER_ADDR "tcp-listen:5555"
+
+// Число обслуживаемых клиентов по-умолчанию.
+#define CLIENTS_COUNT 1
+
+
+static int init_slcan_slave(slcan_slave_t* scs, slcan_t* sc, slcan_socket_t* sock, const char* addr)
+{
+    if(slcan_init(sc) != 0){
+        printf("Cann't init slcan!\n");
+        return -1;
+    }
+
+    slcan_socket_init(sock);
+
+    if(slcan_socket_open(sc, addr, sock) != 0){
+        printf("Cann't open socket: %s\n", addr);
+        return -1;
+    }
+
+    if(slcan_slave_init(scs, sc, NULL) != 0){
+        printf("Error init slcan slave!\n");
+        slcan_close(sc);
+        slcan_deinit(sc);
+        return -1;
+    }
+
+    slcan_slave_set_flags(scs,
+            slcan_slave_flags(scs) |
+            SLCAN_SLAVE_FLAG_OPENED |
+            SLCAN_SLAVE_FLAG_AUTO_POLL);
+
+    return 0;
+}
+
+
+int main_slave_server(int argc, char* argv[])
+{
+    static slcan_t slave_slcan;
+    static slcan_slave_t slave;
+    static slcan_socket_t sock;
+
+    // [addr [clients]].
+    const char* addr = (argc > 1) ? argv[1] : SERVER_ADDR;
+    int clients = (argc > 2) ? atoi(argv[2]) : CLIENTS_COUNT;
+
+    slcan_can_msg_t can_msg;
+    slcan_err_t err;
+    size_t echoed;
+
+    struct timespec ts;
+    ts.tv_sec = 0; ts.tv_nsec = 100000000; // 100 ms.
+
+    for(; clients > 0; clients --){
+        printf("Listening %s...\n", addr);
+
+        if(init_slcan_slave(&slave, &slave_slcan, &sock, addr) == -1){
+            printf("Error init slave slcan!\n");
+            return -1;
+        }
+
+        printf("Serving...\n");
+
+        echoed = 0;
+
+        for(;;){
+            err = slcan_slave_wait(&slave, &ts);
+            // client disconnected.
+            if(err == E_SLCAN_IO_ERROR) break;
+
+            // echo only what can be sent.
+            while(slcan_slave_send_can_msgs_avail(&slave) != 0 &&
+                  slcan_slave_recv_can_msg(&slave, &can_msg) == E_SLCAN_NO_ERROR){
+                slcan_slave_send_can_msg(&slave, &can_msg, NULL);
+                echoed ++;
+            }
+        }
+
+        printf("Client done, echoed %u msgs\n", (unsigned int)echoed);
+
+        slcan_slave_deinit(&slave);
+        slcan_close(&slave_slcan);
+        slcan_deinit(&slave_slcan);
+    }
+
+    printf("Done.\n");
+
+    return 0;
+}
+
+#if defined(EXAMPLE_SLAVE_SERVER) && EXAMPLE_SLAVE_SERVER == 1
+int main(int argc, char* argv[])
+{
+    return main_slave_server(argc, argv);
+}
+#endif
@@ -17,22 +17,77 @@
 //! Тайм-аут запроса по-умолчанию, наносекунд.
 #define SLCAN_MASTER_TIMEOUT_NS_DEFAULT 100000000
 
+//! Тайм-аут запросов настройки и открытия/закрытия CAN
+//! (S, s, O, L, C) по-умолчанию, секунд.
+#define SLCAN_MASTER_SETUP_TIMEOUT_S_DEFAULT 0
+//! Тайм-аут запросов настройки и открытия/закрытия CAN
+//! (S, s, O, L, C) по-умолчанию, наносекунд.
+#define SLCAN_MASTER_SETUP_TIMEOUT_NS_DEFAULT 500000000
+
+//! Тайм-аут запросов передачи сообщений CAN по-умолчанию, секунд.
+#define SLCAN_MASTER_TRANSMIT_TIMEOUT_S_DEFAULT 0
+//! Тайм-аут запросов передачи сообщений CAN по-умолчанию, наносекунд.
+#define SLCAN_MASTER_TRANSMIT_TIMEOUT_NS_DEFAULT 100000000
+
+//! Включение адаптивного окна запросов по-умолчанию.
+#define SLCAN_MASTER_WINDOW_ADAPTIVE_DEFAULT 0
+
+//! Длительность тика колеса сроков запросов
+//! по-умолчанию - степень двойки наносекунд (2^16 нс ~ 65.5 мкс).
+#define SLCAN_TIMER_WHEEL_TICK_SHIFT_DEFAULT 16
+
 //! Включения отправки временных меток по-умолчанию.
 #define SLCAN_SLAVE_TIMESTAMP_DEFAULT 0
 //! Включение автоматической отправки принятых сообщений по-умолчанию.
 #define SLCAN_SLAVE_AUTO_POLL_DEFAULT 0
 
 
+//! Источник времени интерфейса по-умолчанию (slcan_clock_source_t).
+#define SLCAN_CLOCK_SOURCE_DEFAULT SLCAN_CLOCK_SOURCE_MONOTONIC
+
+//! Флаг поддержки счётчика тактов процессора как источника времени.
+#ifndef SLCAN_CLOCK_TSC
+#define SLCAN_CLOCK_TSC 1
+#endif
+
+
 //! Размер буфера команды по-умолчанию.
 #define SLCAN_CMD_BUF_DEFAULT_SIZE 32
 
 
+//! Число команд, получаемых за один вызов при обработке, по-умолчанию.
+#define SLCAN_CMDS_BATCH_DEFAULT_SIZE 16
+
+//! Включение восстановления синхронизации приёма по-умолчанию.
+#define SLCAN_RX_RESYNC_DEFAULT 0
+
+
+//! Флаг поиска границ принимаемых команд векторными инструкциями.
+#ifndef SLCAN_SCAN_SIMD
+#define SLCAN_SCAN_SIMD 1
+#endif
+
+
 //! Размер фифо ввода-вывода по-умолчанию.
 #define SLCAN_IO_FIFO_DEFAULT_SIZE 256
 
 //! Размер фифо сообщений CAN по-умолчанию.
 #define SLCAN_CAN_FIFO_DEFAULT_SIZE 32
 
+//! Размер фифо отправленных запросов по-умолчанию.
+#define SLCAN_RESP_OUT_FIFO_DEFAULT_SIZE 32
+
+//! Флаг потокобезопасных фифо с одним писателем и одним читателем.
+#ifndef SLCAN_FIFO_SPSC
+#define SLCAN_FIFO_SPSC 0
+#endif
+
+//! Флаг поддержки отдельного потока ввода-вывода,
+//! требует SLCAN_FIFO_SPSC.
+#ifndef SLCAN_IO_THREAD
+#define SLCAN_IO_THREAD 0
+#endif
+
 
 //! Флаг поллинга io мастером.
 #define SLCAN_MASTER_POLL_SLCAN 1
@@ -41,11 +96,29 @@
 #define SLCAN_SLAVE_POLL_SLCAN 1
 
 
+//! Флаг подсчёта вызовов ввода-вывода.
+//! Изменяет структуру интерфейса - задаётся для всей сборки.
+#ifndef SLCAN_IO_STATS
+#define SLCAN_IO_STATS 0
+#endif
+
+
+//! Максимальное число интерфейсов в реакторе по-умолчанию.
+#define SLCAN_REACTOR_DEFAULT_SIZE 128
+
+//! Число шагов обработки интерфейса за одно пробуждение реактора по-умолчанию.
+#define SLCAN_REACTOR_BUDGET_DEFAULT 4
+
+
 //! Флаг вывода на stdout передаваемых команд.
+#ifndef SLCAN_DEBUG_OUTCOMING_CMDS
 #define SLCAN_DEBUG_OUTCOMING_CMDS 1
+#endif
 
 //! Флаг вывода на stdout полученных команд.
+#ifndef SLCAN_DEBUG_INCOMING_CMDS
 #define SLCAN_DEBUG_INCOMING_CMDS 1
+#endif
 
 
 #endif /* SLCAN_CONF_H_ */
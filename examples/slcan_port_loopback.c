@@ -0,0 +1,412 @@
+#include "slcan_port_loopback.h"
+#include "slcan_port.h"
+#include "slcan_utils.h"
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <assert.h>
+
+
+// Маска индекса записей в линии.
+#define SLCAN_LOOPBACK_CHUNKS_MASK (SLCAN_LOOPBACK_CHUNKS - 1)
+
+
+// Получает текущее время в наносекундах.
+static uint64_t slcan_loopback_now_ns(void)
+{
+    struct timespec tp;
+
+    slcan_clock_gettime(&tp);
+
+    return (uint64_t)tp.tv_sec * 1000000000ULL + (uint64_t)tp.tv_nsec;
+}
+
+ALWAYS_INLINE static bool slcan_loopback_emulated(const slcan_loopback_t* lb)
+{
+    return lb->byte_ns != 0 || lb->latency_ns != 0;
+}
+
+static void slcan_loopback_ring_init(slcan_loopback_ring_t* ring)
+{
+    slcan_io_fifo_init_buf(&ring->fifo, ring->buf, SLCAN_LOOPBACK_RING_SIZE);
+
+    ring->sent = 0;
+    ring->delivered = 0;
+    ring->wire_free_ns = 0;
+    ring->chunks_head = 0;
+    ring->chunks_tail = 0;
+}
+
+ALWAYS_INLINE static bool slcan_loopback_ring_chunks_empty(const slcan_loopback_ring_t* ring)
+{
+    return ring->chunks_head == ring->chunks_tail;
+}
+
+ALWAYS_INLINE static bool slcan_loopback_ring_chunks_full(const slcan_loopback_ring_t* ring)
+{
+    return ring->chunks_tail - ring->chunks_head == SLCAN_LOOPBACK_CHUNKS;
+}
+
+// Доставляет байты, время приёма которых наступило.
+static void slcan_loopback_ring_update(const slcan_loopback_t* lb, slcan_loopback_ring_t* ring, uint64_t now_ns)
+{
+    slcan_loopback_chunk_t* chunk;
+    uint64_t arrive_ns;
+    size_t count;
+
+    while(!slcan_loopback_ring_chunks_empty(ring)){
+        chunk = &ring->chunks[ring->chunks_head & SLCAN_LOOPBACK_CHUNKS_MASK];
+
+        arrive_ns = chunk->start_ns + lb->latency_ns;
+        if(now_ns < arrive_ns) break;
+
+        if(lb->byte_ns == 0){
+            count = chunk->end - chunk->begin;
+        }else{
+            count = (size_t)((now_ns - arrive_ns) / lb->byte_ns);
+        }
+
+        if(count < chunk->end - chunk->begin){
+            ring->delivered = chunk->begin + count;
+            break;
+        }
+
+        ring->delivered = chunk->end;
+        ring->chunks_head ++;
+    }
+}
+
+// Получает время доставки следующего байта.
+static bool slcan_loopback_ring_next_ns(const slcan_loopback_t* lb, const slcan_loopback_ring_t* ring, uint64_t* next_ns)
+{
+    if(slcan_loopback_ring_chunks_empty(ring)) return false;
+
+    const slcan_loopback_chunk_t* chunk = &ring->chunks[ring->chunks_head & SLCAN_LOOPBACK_CHUNKS_MASK];
+
+    size_t count = ring->delivered - chunk->begin;
+
+    *next_ns = chunk->start_ns + lb->latency_ns + (uint64_t)(count + 1) * lb->byte_ns;
+
+    return true;
+}
+
+// Число доставленных и не прочитанных байт.
+static size_t slcan_loopback_ring_avail(const slcan_loopback_t* lb, slcan_loopback_ring_t* ring)
+{
+    if(!slcan_loopback_emulated(lb)){
+        return slcan_io_fifo_avail(&ring->fifo);
+    }
+
+    slcan_loopback_ring_update(lb, ring, slcan_loopback_now_ns());
+
+    return slcan_io_fifo_avail(&ring->fifo) - (ring->sent - ring->delivered);
+}
+
+// Число байт, которые можно передать.
+static size_t slcan_loopback_ring_remain(const slcan_loopback_t* lb, slcan_loopback_ring_t* ring)
+{
+    if(slcan_loopback_emulated(lb)){
+        slcan_loopback_ring_update(lb, ring, slcan_loopback_now_ns());
+
+        if(slcan_loopback_ring_chunks_full(ring)) return 0;
+    }
+
+    return slcan_io_fifo_remain(&ring->fifo);
+}
+
+static size_t slcan_loopback_ring_write(slcan_loopback_t* lb, slcan_loopback_ring_t* ring, const uint8_t* data, size_t data_size)
+{
+    size_t size = slcan_io_fifo_write(&ring->fifo, data, data_size);
+    if(size == 0) return 0;
+
+    size_t begin = ring->sent;
+
+    ring->sent += size;
+
+    if(!slcan_loopback_emulated(lb)){
+        ring->delivered = ring->sent;
+        return size;
+    }
+
+    uint64_t start_ns = MAX(slcan_loopback_now_ns(), ring->wire_free_ns);
+
+    ring->wire_free_ns = start_ns + (uint64_t)size * lb->byte_ns;
+
+    slcan_loopback_chunk_t* chunk;
+
+    // continue transmission of the last chunk.
+    if(!slcan_loopback_ring_chunks_empty(ring)){
+        chunk = &ring->chunks[(ring->chunks_tail - 1) & SLCAN_LOOPBACK_CHUNKS_MASK];
+
+        if(chunk->end == begin &&
+           chunk->start_ns + (uint64_t)(chunk->end - chunk->begin) * lb->byte_ns == start_ns){
+            chunk->end = ring->sent;
+            return size;
+        }
+    }
+
+    // remain() reserves a chunk before the write.
+    assert(!slcan_loopback_ring_chunks_full(ring));
+
+    chunk = &ring->chunks[ring->chunks_tail & SLCAN_LOOPBACK_CHUNKS_MASK];
+    chunk->begin = begin;
+    chunk->end = ring->sent;
+    chunk->start_ns = start_ns;
+
+    ring->chunks_tail ++;
+
+    return size;
+}
+
+
+slcan_err_t slcan_loopback_init(slcan_loopback_t* lb, uint32_t baud_rate, uint64_t latency_ns)
+{
+    assert(lb != NULL);
+
+    size_t i;
+
+    for(i = 0; i < 2; i ++){
+        slcan_loopback_ring_init(&lb->rings[i]);
+
+        lb->ends[i].lb = lb;
+        lb->ends[i].tx = &lb->rings[i];
+        lb->ends[i].rx = &lb->rings[1 - i];
+        lb->ends[i].opened = false;
+    }
+
+    if(baud_rate != 0){
+        lb->byte_ns = (SLCAN_LOOPBACK_BITS_PER_BYTE * 1000000000ULL + baud_rate - 1) / baud_rate;
+    }else{
+        lb->byte_ns = 0;
+    }
+    lb->latency_ns = latency_ns;
+
+    return E_SLCAN_NO_ERROR;
+}
+
+void slcan_loopback_deinit(slcan_loopback_t* lb)
+{
+    assert(lb != NULL);
+
+    lb->ends[0].opened = false;
+    lb->ends[1].opened = false;
+}
+
+void slcan_loopback_reset(slcan_loopback_t* lb)
+{
+    assert(lb != NULL);
+
+    slcan_loopback_ring_init(&lb->rings[0]);
+    slcan_loopback_ring_init(&lb->rings[1]);
+}
+
+
+// Преобразует конец соединения в slcan_serial_handle_t.
+#define END_TO_HANDLE(E) ((slcan_serial_handle_t)(E))
+// Преобразует slcan_serial_handle_t в конец соединения.
+#define HANDLE_TO_END(H) ((slcan_loopback_end_t*)(H))
+
+
+static int slcan_loopback_open(void* ctx, const char* name, slcan_serial_handle_t* serial_port)
+{
+    slcan_loopback_t* lb = (slcan_loopback_t*)ctx;
+
+    if(lb == NULL || name == NULL || serial_port == NULL){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_loopback_end_t* end;
+
+    if(strcmp(name, SLCAN_LOOPBACK_PORT_A) == 0){
+        end = &lb->ends[0];
+    }else if(strcmp(name, SLCAN_LOOPBACK_PORT_B) == 0){
+        end = &lb->ends[1];
+    }else{
+        errno = ENOENT;
+        return SLCAN_IO_FAIL;
+    }
+
+    if(end->opened){
+        errno = EBUSY;
+        return SLCAN_IO_FAIL;
+    }
+
+    end->opened = true;
+
+    *serial_port = END_TO_HANDLE(end);
+
+    return SLCAN_IO_SUCCESS;
+}
+
+static void slcan_loopback_close(void* ctx, slcan_serial_handle_t serial_port)
+{
+    (void) ctx;
+
+    HANDLE_TO_END(serial_port)->opened = false;
+}
+
+static slcan_port_caps_t slcan_loopback_caps(void* ctx, slcan_serial_handle_t serial_port)
+{
+    (void) ctx;
+    (void) serial_port;
+
+    return SLCAN_PORT_CAP_NONBLOCK_READ | SLCAN_PORT_CAP_WRITEV;
+}
+
+static int slcan_loopback_read(void* ctx, slcan_serial_handle_t serial_port, void* data, size_t data_size)
+{
+    (void) ctx;
+
+    slcan_loopback_end_t* end = HANDLE_TO_END(serial_port);
+
+    size_t size = slcan_loopback_ring_avail(end->lb, end->rx);
+    if(size == 0){
+        errno = EAGAIN;
+        return SLCAN_IO_FAIL;
+    }
+
+    size = slcan_io_fifo_read(&end->rx->fifo, (uint8_t*)data, MIN(size, data_size));
+
+    return (int)size;
+}
+
+static int slcan_loopback_write(void* ctx, slcan_serial_handle_t serial_port, const void* data, size_t data_size)
+{
+    (void) ctx;
+
+    slcan_loopback_end_t* end = HANDLE_TO_END(serial_port);
+
+    size_t size = slcan_loopback_ring_remain(end->lb, end->tx);
+    if(size == 0){
+        errno = EAGAIN;
+        return SLCAN_IO_FAIL;
+    }
+
+    size = slcan_loopback_ring_write(end->lb, end->tx, (const uint8_t*)data, MIN(size, data_size));
+
+    return (int)size;
+}
+
+static int slcan_loopback_writev(void* ctx, slcan_serial_handle_t serial_port, const slcan_serial_iovec_t* iov, size_t iovcnt)
+{
+    (void) ctx;
+
+    slcan_loopback_end_t* end = HANDLE_TO_END(serial_port);
+
+    size_t written = 0;
+    size_t remain, size, i;
+
+    for(i = 0; i < iovcnt; i ++){
+        remain = slcan_loopback_ring_remain(end->lb, end->tx);
+        if(remain == 0) break;
+
+        size = slcan_loopback_ring_write(end->lb, end->tx, (const uint8_t*)iov[i].data, MIN(remain, iov[i].size));
+
+        written += size;
+
+        if(size < iov[i].size) break;
+    }
+
+    if(written == 0 && iovcnt != 0){
+        errno = EAGAIN;
+        return SLCAN_IO_FAIL;
+    }
+
+    return (int)written;
+}
+
+static int slcan_loopback_nbytes(void* ctx, slcan_serial_handle_t serial_port, size_t* size)
+{
+    (void) ctx;
+
+    if(size == NULL){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_loopback_end_t* end = HANDLE_TO_END(serial_port);
+
+    *size = slcan_loopback_ring_avail(end->lb, end->rx);
+
+    return SLCAN_IO_SUCCESS;
+}
+
+static int slcan_loopback_poll(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, int timeout)
+{
+    (void) ctx;
+
+    if(revents == NULL){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_loopback_end_t* end = HANDLE_TO_END(serial_port);
+    slcan_loopback_t* lb = end->lb;
+
+    uint64_t now_ns = 0, end_ns = 0, next_ns, wake_ns;
+    struct timespec tp_sleep;
+    bool has_next;
+    int out_events;
+
+    if(timeout > 0){
+        now_ns = slcan_loopback_now_ns();
+        end_ns = now_ns + (uint64_t)timeout * 1000000ULL;
+    }
+
+    for(;;){
+        out_events = 0;
+
+        if(slcan_loopback_ring_avail(lb, end->rx) != 0) out_events |= SLCAN_POLLIN;
+        if(slcan_loopback_ring_remain(lb, end->tx) != 0) out_events |= SLCAN_POLLOUT;
+
+        out_events &= events;
+
+        if(out_events != 0 || timeout == 0) break;
+
+        // only bytes on the wire can change readiness,
+        // the peer is served by the same thread.
+        has_next = false;
+        if((events & SLCAN_POLLIN) && slcan_loopback_ring_next_ns(lb, end->rx, &next_ns)){
+            wake_ns = next_ns;
+            has_next = true;
+        }
+        if((events & SLCAN_POLLOUT) && slcan_loopback_ring_chunks_full(end->tx) &&
+           slcan_loopback_ring_next_ns(lb, end->tx, &next_ns)){
+            wake_ns = has_next ? MIN(wake_ns, next_ns) : next_ns;
+            has_next = true;
+        }
+        if(!has_next) break;
+
+        now_ns = slcan_loopback_now_ns();
+
+        if(timeout > 0){
+            if(now_ns >= end_ns) break;
+            wake_ns = MIN(wake_ns, end_ns);
+        }
+
+        if(wake_ns > now_ns){
+            tp_sleep.tv_sec = (time_t)((wake_ns - now_ns) / 1000000000ULL);
+            tp_sleep.tv_nsec = (long)((wake_ns - now_ns) % 1000000000ULL);
+            nanosleep(&tp_sleep, NULL);
+        }
+    }
+
+    *revents = out_events;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+
+const slcan_port_ops_t slcan_loopback_ops = {
+    .open = slcan_loopback_open,
+    .close = slcan_loopback_close,
+    .caps = slcan_loopback_caps,
+    .configure = NULL,
+    .read = slcan_loopback_read,
+    .write = slcan_loopback_write,
+    .writev = slcan_loopback_writev,
+    .poll = slcan_loopback_poll,
+    .poll_event = NULL,
+    .nbytes = slcan_loopback_nbytes,
+};
@@ -0,0 +1,110 @@
+/**
+ * @file slcan_port_loopback.h
+ * Транспорт в памяти процесса, соединяющий два интерфейса.
+ */
+
+#ifndef SLCAN_PORT_LOOPBACK_H_
+#define SLCAN_PORT_LOOPBACK_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "slcan_defs.h"
+#include "slcan_io_fifo.h"
+#include "slcan_port_ops.h"
+
+
+//! Размер кольца байт одного направления.
+#ifndef SLCAN_LOOPBACK_RING_SIZE
+#define SLCAN_LOOPBACK_RING_SIZE 4096
+#endif
+
+//! Число записей, находящихся в линии одновременно.
+#ifndef SLCAN_LOOPBACK_CHUNKS
+#define SLCAN_LOOPBACK_CHUNKS 256
+#endif
+
+#if (SLCAN_LOOPBACK_RING_SIZE & (SLCAN_LOOPBACK_RING_SIZE - 1)) != 0
+#error SLCAN_LOOPBACK_RING_SIZE must be a power of two!
+#endif
+
+#if (SLCAN_LOOPBACK_CHUNKS & (SLCAN_LOOPBACK_CHUNKS - 1)) != 0
+#error SLCAN_LOOPBACK_CHUNKS must be a power of two!
+#endif
+
+//! Имя первого конца соединения.
+#define SLCAN_LOOPBACK_PORT_A "a"
+//! Имя второго конца соединения.
+#define SLCAN_LOOPBACK_PORT_B "b"
+
+//! Число бит на байт в линии (8N1).
+#define SLCAN_LOOPBACK_BITS_PER_BYTE 10
+
+
+//! Запись, передаваемая по линии.
+typedef struct _Slcan_Loopback_Chunk {
+    size_t begin; //!< Номер первого байта записи.
+    size_t end; //!< Номер за последним байтом записи.
+    uint64_t start_ns; //!< Время начала передачи записи.
+} slcan_loopback_chunk_t;
+
+//! Направление передачи.
+typedef struct _Slcan_Loopback_Ring {
+    slcan_io_fifo_t fifo; //!< Байты в линии и в приёмнике.
+    uint8_t buf[SLCAN_LOOPBACK_RING_SIZE]; //!< Буфер фифо.
+    size_t sent; //!< Число переданных байт.
+    size_t delivered; //!< Число доставленных байт.
+    uint64_t wire_free_ns; //!< Время освобождения линии.
+    slcan_loopback_chunk_t chunks[SLCAN_LOOPBACK_CHUNKS]; //!< Записи в линии.
+    size_t chunks_head; //!< Индекс первой записи.
+    size_t chunks_tail; //!< Индекс за последней записью.
+} slcan_loopback_ring_t;
+
+//! Конец соединения.
+typedef struct _Slcan_Loopback_End {
+    struct _Slcan_Loopback* lb; //!< Соединение.
+    slcan_loopback_ring_t* tx; //!< Кольцо передачи.
+    slcan_loopback_ring_t* rx; //!< Кольцо приёма.
+    bool opened; //!< Флаг открытого конца.
+} slcan_loopback_end_t;
+
+//! Соединение двух интерфейсов в памяти.
+typedef struct _Slcan_Loopback {
+    slcan_loopback_ring_t rings[2]; //!< Кольца a -> b и b -> a.
+    slcan_loopback_end_t ends[2]; //!< Концы a и b.
+    uint64_t byte_ns; //!< Время передачи байта, 0 - без ограничения скорости.
+    uint64_t latency_ns; //!< Задержка линии.
+} slcan_loopback_t;
+
+
+/**
+ * Функции транспорта соединения.
+ * Контекстом является slcan_loopback_t.
+ * Оба конца должны обслуживаться одним потоком,
+ * ожидание без данных в линии завершается сразу.
+ */
+EXTERN const slcan_port_ops_t slcan_loopback_ops;
+
+
+/**
+ * Инициализирует соединение.
+ * @param lb Соединение.
+ * @param baud_rate Эмулируемая скорость, бод, 0 - без ограничения.
+ * @param latency_ns Эмулируемая задержка линии, нс.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_loopback_init(slcan_loopback_t* lb, uint32_t baud_rate, uint64_t latency_ns);
+
+/**
+ * Деинициализирует соединение.
+ * @param lb Соединение.
+ */
+EXTERN void slcan_loopback_deinit(slcan_loopback_t* lb);
+
+/**
+ * Сбрасывает данные в обоих направлениях.
+ * @param lb Соединение.
+ */
+EXTERN void slcan_loopback_reset(slcan_loopback_t* lb);
+
+#endif /* SLCAN_PORT_LOOPBACK_H_ */
@@ -6,6 +6,17 @@
 #include <sys/types.h>
 #include <sys/poll.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#ifdef __linux
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/serial.h>
+#include <linux/futex.h>
+#endif
 
 
 int slcan_clock_gettime (struct timespec *tp)
@@ -13,6 +24,15 @@ int slcan_clock_gettime (struct timespec *tp)
     return clock_gettime(CLOCK_MONOTONIC, tp);
 }
 
+int slcan_clock_gettime_coarse (struct timespec *tp)
+{
+#ifdef CLOCK_MONOTONIC_COARSE
+    return clock_gettime(CLOCK_MONOTONIC_COARSE, tp);
+#else
+    return clock_gettime(CLOCK_MONOTONIC, tp);
+#endif
+}
+
 
 // Преобразует тип последовательного порта в slcan_serial_handle_t.
 #define SERIAL_TO_HANDLE(S) ((slcan_serial_handle_t)(long)(S))
@@ -24,7 +44,7 @@ int slcan_serial_open(const char* serial_port_name, slcan_serial_handle_t* seria
 {
     if(serial_port == NULL) return SLCAN_IO_FAIL;
 
-    int s = open(serial_port_name, O_RDWR | O_NOCTTY);
+    int s = open(serial_port_name, O_RDWR | O_NOCTTY | O_NONBLOCK);
     if(s < 0) return SLCAN_IO_FAIL;
 
     *serial_port = SERIAL_TO_HANDLE(s);
@@ -32,22 +52,192 @@ int slcan_serial_open(const char* serial_port_name, slcan_serial_handle_t* seria
     return SLCAN_IO_SUCCESS;
 }
 
-int slcan_serial_configure(slcan_serial_handle_t serial_port, const slcan_port_conf_t* conf)
+slcan_port_caps_t slcan_serial_caps(slcan_serial_handle_t serial_port)
+{
+    (void) serial_port;
+
+    // read() returns 0 or EAGAIN on empty port (see VMIN).
+    return SLCAN_PORT_CAP_NONBLOCK_READ | SLCAN_PORT_CAP_WRITEV;
+}
+
+// Скорости стандартных значений slcan_port_baud_t, бод.
+static const uint32_t slcan_port_baud_rates[] = {
+    230400,
+    115200,
+    57600,
+    38400,
+    19200,
+    9600,
+    2400,
+    460800,
+    921600,
+    1000000,
+    1500000,
+    2000000,
+    3000000,
+    4000000,
+};
+
+// Получает константу скорости termios, B0 - если её нет.
+static speed_t baud_rate_to_speed(uint32_t baud_rate)
+{
+    switch(baud_rate){
+    case 2400: return B2400;
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+#endif
+#ifdef B921600
+    case 921600: return B921600;
+#endif
+#ifdef B1000000
+    case 1000000: return B1000000;
+#endif
+#ifdef B1500000
+    case 1500000: return B1500000;
+#endif
+#ifdef B2000000
+    case 2000000: return B2000000;
+#endif
+#ifdef B3000000
+    case 3000000: return B3000000;
+#endif
+#ifdef B4000000
+    case 4000000: return B4000000;
+#endif
+    default:
+        break;
+    }
+
+    return B0;
+}
+
+// struct termios2 из asm/termbits.h,
+// заголовок несовместим с termios.h.
+#if defined(__linux) && defined(TCGETS2) && \
+    (defined(__x86_64__) || defined(__i386__) || defined(__aarch64__) || defined(__arm__) || defined(__riscv))
+
+// Число управляющих символов termios ядра.
+#define KERNEL_NCCS 19
+// Произвольная скорость в c_cflag.
+#define KERNEL_BOTHER 0010000
+
+struct termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[KERNEL_NCCS];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+
+static int set_custom_baud_rate(int fd, uint32_t baud_rate)
+{
+    struct termios2 tty2;
+
+    int res;
+
+    res = ioctl(fd, TCGETS2, &tty2);
+    if(res == SLCAN_IO_FAIL) return res;
+
+    tty2.c_cflag &= ~CBAUD;
+    tty2.c_cflag |= KERNEL_BOTHER;
+    tty2.c_ispeed = baud_rate;
+    tty2.c_ospeed = baud_rate;
+
+    return ioctl(fd, TCSETS2, &tty2);
+}
+
+#else
+
+static int set_custom_baud_rate(int fd, uint32_t baud_rate)
+{
+    (void) fd;
+    (void) baud_rate;
+
+    errno = EINVAL;
+    return SLCAN_IO_FAIL;
+}
+
+#endif
+
+#if defined(__linux) && defined(TIOCGSERIAL) && defined(ASYNC_LOW_LATENCY)
+
+static int set_low_latency(int fd, bool enable)
 {
-    static const int slcan_port_bauds_impl[] = {
-        B230400,
-        B115200,
-        B57600,
-        B38400,
-        B19200,
-        B9600,
-        B2400,
-    };
+    struct serial_struct ss;
 
+    int res;
+
+    res = ioctl(fd, TIOCGSERIAL, &ss);
+    if(res == SLCAN_IO_FAIL){
+        // not a serial driver (pty, usb cdc).
+        if(errno == ENOTTY || errno == EINVAL) return SLCAN_IO_SUCCESS;
+        return res;
+    }
+
+    bool enabled = (ss.flags & ASYNC_LOW_LATENCY) != 0;
+
+    if(enabled == enable) return SLCAN_IO_SUCCESS;
+
+    if(enable){
+        ss.flags |= ASYNC_LOW_LATENCY;
+    }else{
+        ss.flags &= ~ASYNC_LOW_LATENCY;
+    }
+
+    res = ioctl(fd, TIOCSSERIAL, &ss);
+    if(res == SLCAN_IO_FAIL){
+        // driver does not allow to change flags.
+        if(errno == ENOTTY || errno == EINVAL) return SLCAN_IO_SUCCESS;
+        return res;
+    }
+
+    return SLCAN_IO_SUCCESS;
+}
+
+#else
+
+static int set_low_latency(int fd, bool enable)
+{
+    (void) fd;
+    (void) enable;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+#endif
+
+int slcan_serial_configure(slcan_serial_handle_t serial_port, const slcan_port_conf_t* conf)
+{
     struct termios tty;
 
     int res;
 
+    uint32_t baud_rate;
+
+    if(conf->baud == SLCAN_PORT_BAUD_CUSTOM){
+        baud_rate = conf->baud_rate;
+    }else if((unsigned int)conf->baud <= SLCAN_PORT_BAUD_STD_MAX){
+        baud_rate = slcan_port_baud_rates[conf->baud];
+    }else{
+        baud_rate = 0;
+    }
+
+    if(baud_rate == 0){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    speed_t speed = baud_rate_to_speed(baud_rate);
+
     res = tcgetattr(HANDLE_TO_SERIAL(serial_port), &tty);
     if(res == SLCAN_IO_FAIL) return res;
 
@@ -98,8 +288,11 @@ int slcan_serial_configure(slcan_serial_handle_t serial_port, const slcan_port_c
     // set 8 bit size flag.
     tty.c_cflag |= CS8;
     // hw flow control.
-    // disable.
-    tty.c_cflag &= ~CRTSCTS;
+    if(conf->flow_control == SLCAN_PORT_FLOW_CONTROL_RTS_CTS){
+        tty.c_cflag |= CRTSCTS;
+    }else{
+        tty.c_cflag &= ~CRTSCTS;
+    }
     // local mode.
     tty.c_cflag |= CLOCAL;
     // enable receiver.
@@ -142,21 +335,34 @@ int slcan_serial_configure(slcan_serial_handle_t serial_port, const slcan_port_c
     tty.c_oflag &= ~(OLCUC | ONLCR | OCRNL  | ONOCR | ONLRET | OFILL | OFDEL |
                      NLDLY | CRDLY | TABDLY | BSDLY | VTDLY  | FFDLY);
 
-    // Minimal characters to be read.
-    tty.c_cc[VMIN] = 0;
-    // Timeout to blocking read.
-    tty.c_cc[VTIME] = 0;
+    // port is non-blocking: VMIN only selects
+    // the result of empty read (0 or EAGAIN),
+    // VTIME is not used.
+    tty.c_cc[VMIN] = conf->vmin;
+    tty.c_cc[VTIME] = conf->vtime;
 
 
     // Speed.
-    cfsetispeed(&tty, slcan_port_bauds_impl[conf->baud]);
-    cfsetospeed(&tty, slcan_port_bauds_impl[conf->baud]);
+    if(speed != B0){
+        cfsetispeed(&tty, speed);
+        cfsetospeed(&tty, speed);
+    }
 
 
     // set conf to port.
     res = tcsetattr(HANDLE_TO_SERIAL(serial_port), TCSANOW, &tty);
     if(res == SLCAN_IO_FAIL) return res;
 
+    // not standard speed.
+    if(speed == B0){
+        res = set_custom_baud_rate(HANDLE_TO_SERIAL(serial_port), baud_rate);
+        if(res == SLCAN_IO_FAIL) return res;
+    }
+
+    // driver latency.
+    res = set_low_latency(HANDLE_TO_SERIAL(serial_port), conf->low_latency);
+    if(res == SLCAN_IO_FAIL) return res;
+
 
     // set non blocking io.
     int flags = fcntl(HANDLE_TO_SERIAL(serial_port), F_GETFL, 0);
@@ -183,6 +389,26 @@ int slcan_serial_write(slcan_serial_handle_t serial_port, const void* data, size
     return write(HANDLE_TO_SERIAL(serial_port), data, data_size);
 }
 
+// Максимальное число участков данных за один вызов writev.
+#define WRITEV_IOV_MAX 8
+
+int slcan_serial_writev(slcan_serial_handle_t serial_port, const slcan_serial_iovec_t* iov, size_t iovcnt)
+{
+    if(iov == NULL) return SLCAN_IO_FAIL;
+
+    struct iovec v[WRITEV_IOV_MAX];
+
+    if(iovcnt > WRITEV_IOV_MAX) iovcnt = WRITEV_IOV_MAX;
+
+    size_t i;
+    for(i = 0; i < iovcnt; i ++){
+        v[i].iov_base = (void*)iov[i].data;
+        v[i].iov_len = iov[i].size;
+    }
+
+    return writev(HANDLE_TO_SERIAL(serial_port), v, (int)iovcnt);
+}
+
 int slcan_serial_flush(slcan_serial_handle_t serial_port)
 {
     int res;
@@ -230,6 +456,60 @@ int slcan_serial_poll(slcan_serial_handle_t serial_port, int events, int* revent
     return SLCAN_IO_SUCCESS;
 }
 
+// Преобразует тип события в slcan_event_handle_t.
+#define EVENT_TO_HANDLE(E) ((slcan_event_handle_t)(long)(E))
+// Преобразует slcan_event_handle_t в тип события.
+#define HANDLE_TO_EVENT(H) ((int)(long)(H))
+
+int slcan_serial_poll_event(slcan_serial_handle_t serial_port, int events, int* revents, slcan_event_handle_t event, bool* signaled, int timeout)
+{
+    if(revents == NULL) return SLCAN_IO_FAIL;
+
+    struct pollfd pfd[2];
+
+    short in_events = 0;
+
+    if(events & SLCAN_POLLIN) in_events |= POLLIN;
+    if(events & SLCAN_POLLOUT) in_events |= POLLOUT;
+
+    pfd[0].fd = HANDLE_TO_SERIAL(serial_port);
+    pfd[0].events = in_events;
+    pfd[0].revents = 0;
+
+    pfd[1].fd = HANDLE_TO_EVENT(event);
+    pfd[1].events = POLLIN;
+    pfd[1].revents = 0;
+
+    int res = poll(pfd, 2, timeout);
+    if(res == SLCAN_IO_FAIL){
+        // interrupted by signal - no events.
+        if(errno != EINTR) return res;
+        pfd[0].revents = 0;
+        pfd[1].revents = 0;
+    }
+
+    short out_events = 0;
+
+    if(pfd[0].revents & POLLIN) out_events |= SLCAN_POLLIN;
+    if(pfd[0].revents & POLLOUT) out_events |= SLCAN_POLLOUT;
+    if(pfd[0].revents & (POLLERR | POLLHUP | POLLNVAL)) out_events |= SLCAN_POLLERR;
+
+    *revents = out_events;
+
+    bool ev_signaled = (pfd[1].revents & POLLIN) != 0;
+
+    if(ev_signaled){
+        uint64_t value;
+        // reset event.
+        res = read(HANDLE_TO_EVENT(event), &value, sizeof(value));
+        if(res == SLCAN_IO_FAIL && errno != EAGAIN) return res;
+    }
+
+    if(signaled) *signaled = ev_signaled;
+
+    return SLCAN_IO_SUCCESS;
+}
+
 int slcan_serial_nbytes(slcan_serial_handle_t serial_port, size_t* size)
 {
     if(size == NULL) return SLCAN_IO_FAIL;
@@ -244,3 +524,310 @@ int slcan_serial_nbytes(slcan_serial_handle_t serial_port, size_t* size)
 
     return SLCAN_IO_SUCCESS;
 }
+
+
+// Преобразует тип ожидания событий в slcan_poller_handle_t.
+#define POLLER_TO_HANDLE(P) ((slcan_poller_handle_t)(long)(P))
+// Преобразует slcan_poller_handle_t в тип ожидания событий.
+#define HANDLE_TO_POLLER(H) ((int)(long)(H))
+
+#ifdef __linux
+
+// Максимальное число событий за один вызов epoll_wait.
+#define POLLER_EVENTS_MAX 64
+
+
+int slcan_poller_open(slcan_poller_handle_t* poller)
+{
+    if(poller == NULL) return SLCAN_IO_FAIL;
+
+    int p = epoll_create1(EPOLL_CLOEXEC);
+    if(p < 0) return SLCAN_IO_FAIL;
+
+    *poller = POLLER_TO_HANDLE(p);
+
+    return SLCAN_IO_SUCCESS;
+}
+
+void slcan_poller_close(slcan_poller_handle_t poller)
+{
+    close(HANDLE_TO_POLLER(poller));
+}
+
+int slcan_poller_add(slcan_poller_handle_t poller, slcan_serial_handle_t serial_port, int events, void* user_data)
+{
+    struct epoll_event ev;
+
+    ev.events = EPOLLET;
+    if(events & SLCAN_POLLIN) ev.events |= EPOLLIN;
+    if(events & SLCAN_POLLOUT) ev.events |= EPOLLOUT;
+    ev.data.ptr = user_data;
+
+    return epoll_ctl(HANDLE_TO_POLLER(poller), EPOLL_CTL_ADD, HANDLE_TO_SERIAL(serial_port), &ev);
+}
+
+int slcan_poller_del(slcan_poller_handle_t poller, slcan_serial_handle_t serial_port)
+{
+    return epoll_ctl(HANDLE_TO_POLLER(poller), EPOLL_CTL_DEL, HANDLE_TO_SERIAL(serial_port), NULL);
+}
+
+int slcan_poller_wait(slcan_poller_handle_t poller, slcan_poller_event_t* events, size_t max_events, size_t* count, int timeout)
+{
+    if(events == NULL || count == NULL) return SLCAN_IO_FAIL;
+
+    struct epoll_event evs[POLLER_EVENTS_MAX];
+
+    if(max_events > POLLER_EVENTS_MAX) max_events = POLLER_EVENTS_MAX;
+
+    int res = epoll_wait(HANDLE_TO_POLLER(poller), evs, (int)max_events, timeout);
+    if(res == SLCAN_IO_FAIL){
+        // interrupted by signal - no events.
+        if(errno != EINTR) return res;
+        res = 0;
+    }
+
+    int i;
+    for(i = 0; i < res; i ++){
+        int out_events = 0;
+
+        if(evs[i].events & EPOLLIN) out_events |= SLCAN_POLLIN;
+        if(evs[i].events & EPOLLOUT) out_events |= SLCAN_POLLOUT;
+        if(evs[i].events & (EPOLLERR | EPOLLHUP)) out_events |= SLCAN_POLLERR;
+
+        events[i].user_data = evs[i].data.ptr;
+        events[i].revents = out_events;
+    }
+
+    *count = (size_t)res;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+#else
+
+int slcan_poller_open(slcan_poller_handle_t* poller)
+{
+    (void) poller;
+
+    return SLCAN_IO_FAIL;
+}
+
+void slcan_poller_close(slcan_poller_handle_t poller)
+{
+    (void) poller;
+}
+
+int slcan_poller_add(slcan_poller_handle_t poller, slcan_serial_handle_t serial_port, int events, void* user_data)
+{
+    (void) poller;
+    (void) serial_port;
+    (void) events;
+    (void) user_data;
+
+    return SLCAN_IO_FAIL;
+}
+
+int slcan_poller_del(slcan_poller_handle_t poller, slcan_serial_handle_t serial_port)
+{
+    (void) poller;
+    (void) serial_port;
+
+    return SLCAN_IO_FAIL;
+}
+
+int slcan_poller_wait(slcan_poller_handle_t poller, slcan_poller_event_t* events, size_t max_events, size_t* count, int timeout)
+{
+    (void) poller;
+    (void) events;
+    (void) max_events;
+    (void) count;
+    (void) timeout;
+
+    return SLCAN_IO_FAIL;
+}
+
+#endif
+
+
+
+#ifdef __linux
+
+int slcan_event_open(slcan_event_handle_t* event)
+{
+    if(event == NULL) return SLCAN_IO_FAIL;
+
+    int e = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(e < 0) return SLCAN_IO_FAIL;
+
+    *event = EVENT_TO_HANDLE(e);
+
+    return SLCAN_IO_SUCCESS;
+}
+
+void slcan_event_close(slcan_event_handle_t event)
+{
+    close(HANDLE_TO_EVENT(event));
+}
+
+int slcan_event_signal(slcan_event_handle_t event)
+{
+    uint64_t value = 1;
+
+    int res = write(HANDLE_TO_EVENT(event), &value, sizeof(value));
+    // counter overflow - event is already signaled.
+    if(res == SLCAN_IO_FAIL && errno != EAGAIN) return res;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+#else
+
+int slcan_event_open(slcan_event_handle_t* event)
+{
+    (void) event;
+
+    return SLCAN_IO_FAIL;
+}
+
+void slcan_event_close(slcan_event_handle_t event)
+{
+    (void) event;
+}
+
+int slcan_event_signal(slcan_event_handle_t event)
+{
+    (void) event;
+
+    return SLCAN_IO_FAIL;
+}
+
+#endif
+
+int slcan_event_wait(slcan_event_handle_t event, int timeout)
+{
+    struct pollfd pfd;
+
+    pfd.fd = HANDLE_TO_EVENT(event);
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int res = poll(&pfd, 1, timeout);
+    if(res == SLCAN_IO_FAIL){
+        // interrupted by signal - no events.
+        if(errno != EINTR) return res;
+        return SLCAN_IO_SUCCESS;
+    }
+
+    if(pfd.revents & POLLIN){
+        uint64_t value;
+        // reset event.
+        res = read(HANDLE_TO_EVENT(event), &value, sizeof(value));
+        if(res == SLCAN_IO_FAIL && errno != EAGAIN) return res;
+    }
+
+    return SLCAN_IO_SUCCESS;
+}
+
+
+#ifdef __linux
+
+int slcan_address_wait(uint32_t* addr, uint32_t value, int timeout)
+{
+    struct timespec ts;
+    struct timespec* pts = NULL;
+
+    if(timeout >= 0){
+        ts.tv_sec = timeout / 1000;
+        ts.tv_nsec = (long)(timeout % 1000) * 1000000;
+        pts = &ts;
+    }
+
+    long res = syscall(SYS_futex, addr, FUTEX_WAIT_PRIVATE, value, pts, NULL, 0);
+    if(res == -1){
+        // value changed, interrupted by signal or timed out.
+        if(errno != EAGAIN && errno != EINTR && errno != ETIMEDOUT) return SLCAN_IO_FAIL;
+    }
+
+    return SLCAN_IO_SUCCESS;
+}
+
+void slcan_address_wake(uint32_t* addr)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+
+#else
+
+// Общие для всех адресов мьютекс и условная переменная.
+static pthread_mutex_t slcan_address_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t slcan_address_cond = PTHREAD_COND_INITIALIZER;
+
+int slcan_address_wait(uint32_t* addr, uint32_t value, int timeout)
+{
+    struct timespec ts;
+    int res = 0;
+
+    if(timeout >= 0){
+        clock_gettime(CLOCK_REALTIME, &ts);
+        ts.tv_sec += timeout / 1000;
+        ts.tv_nsec += (long)(timeout % 1000) * 1000000;
+        if(ts.tv_nsec >= 1000000000){
+            ts.tv_nsec -= 1000000000;
+            ts.tv_sec += 1;
+        }
+    }
+
+    pthread_mutex_lock(&slcan_address_mutex);
+    // the value is changed before the wake under the mutex.
+    if(__atomic_load_n(addr, __ATOMIC_SEQ_CST) == value){
+        if(timeout >= 0){
+            res = pthread_cond_timedwait(&slcan_address_cond, &slcan_address_mutex, &ts);
+        }else{
+            res = pthread_cond_wait(&slcan_address_cond, &slcan_address_mutex);
+        }
+    }
+    pthread_mutex_unlock(&slcan_address_mutex);
+
+    if(res != 0 && res != ETIMEDOUT) return SLCAN_IO_FAIL;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+void slcan_address_wake(uint32_t* addr)
+{
+    (void) addr;
+
+    pthread_mutex_lock(&slcan_address_mutex);
+    pthread_cond_broadcast(&slcan_address_cond);
+    pthread_mutex_unlock(&slcan_address_mutex);
+}
+
+#endif
+
+
+// Преобразует pthread_t в slcan_thread_handle_t.
+#define THREAD_TO_HANDLE(T) ((slcan_thread_handle_t)(uintptr_t)(T))
+// Преобразует slcan_thread_handle_t в pthread_t.
+#define HANDLE_TO_THREAD(H) ((pthread_t)(uintptr_t)(H))
+
+int slcan_thread_create(slcan_thread_handle_t* thread, slcan_thread_func_t func, void* arg)
+{
+    if(thread == NULL || func == NULL) return SLCAN_IO_FAIL;
+
+    pthread_t t;
+
+    int res = pthread_create(&t, NULL, func, arg);
+    if(res != 0){
+        errno = res;
+        return SLCAN_IO_FAIL;
+    }
+
+    *thread = THREAD_TO_HANDLE(t);
+
+    return SLCAN_IO_SUCCESS;
+}
+
+void slcan_thread_join(slcan_thread_handle_t thread)
+{
+    pthread_join(HANDLE_TO_THREAD(thread), NULL);
+}
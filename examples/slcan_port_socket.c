@@ -0,0 +1,449 @@
+#include "slcan_port_socket.h"
+#include "slcan_port.h"
+#include "slcan_utils.h"
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <assert.h>
+
+
+// Преобразует дескриптор сокета в slcan_serial_handle_t.
+#define SOCKET_TO_HANDLE(S) ((slcan_serial_handle_t)(long)(S))
+// Преобразует slcan_serial_handle_t в дескриптор сокета.
+#define HANDLE_TO_SOCKET(H) ((int)(long)(H))
+
+// Максимальная длина адреса узла.
+#define SLCAN_SOCKET_HOST_MAX 256
+
+// Максимальное число участков данных в датаграмме.
+#define SLCAN_SOCKET_IOV_MAX 8
+
+
+slcan_err_t slcan_socket_init(slcan_socket_t* sock)
+{
+    assert(sock != NULL);
+
+    sock->fd = -1;
+    sock->type = SLCAN_SOCKET_TCP;
+    sock->connected = false;
+    sock->rxpos = 0;
+    sock->rxlen = 0;
+
+    return E_SLCAN_NO_ERROR;
+}
+
+slcan_err_t slcan_socket_open(slcan_t* sc, const char* name, slcan_socket_t* sock)
+{
+    return slcan_open_port(sc, name, &slcan_socket_ops, sock);
+}
+
+
+// Разбирает адрес вида [HOST:]PORT.
+static int slcan_socket_parse_addr(const char* addr, char* host, size_t host_size, const char** port)
+{
+    const char* sep = strrchr(addr, ':');
+
+    if(sep == NULL){
+        host[0] = '\0';
+        *port = addr;
+        return SLCAN_IO_SUCCESS;
+    }
+
+    size_t len = (size_t)(sep - addr);
+    if(len >= host_size){
+        errno = ENAMETOOLONG;
+        return SLCAN_IO_FAIL;
+    }
+
+    memcpy(host, addr, len);
+    host[len] = '\0';
+    *port = sep + 1;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+static int slcan_socket_set_nonblock(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    if(flags == -1) return SLCAN_IO_FAIL;
+
+    return fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+static int slcan_socket_set_nodelay(int fd)
+{
+    int on = 1;
+
+    // batching is done by the io fifo.
+    return setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+// Создаёт сокет, подключенный к адресу или ожидающий на нём.
+static int slcan_socket_create(slcan_socket_type_t type, const char* addr, bool listen_mode)
+{
+    char host[SLCAN_SOCKET_HOST_MAX];
+    const char* port;
+
+    if(slcan_socket_parse_addr(addr, host, sizeof(host), &port) == SLCAN_IO_FAIL) return -1;
+
+    struct addrinfo hints;
+    struct addrinfo* res_ai;
+    struct addrinfo* ai;
+
+    memset(&hints, 0x0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = (type == SLCAN_SOCKET_TCP) ? SOCK_STREAM : SOCK_DGRAM;
+    hints.ai_flags = listen_mode ? AI_PASSIVE : 0;
+
+    int res = getaddrinfo(host[0] ? host : NULL, port, &hints, &res_ai);
+    if(res != 0){
+        errno = EADDRNOTAVAIL;
+        return -1;
+    }
+
+    int fd = -1;
+    int on = 1;
+
+    for(ai = res_ai; ai != NULL; ai = ai->ai_next){
+        fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+        if(fd == -1) continue;
+
+        if(listen_mode){
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+            if(bind(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        }else{
+            if(connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) break;
+        }
+
+        close(fd);
+        fd = -1;
+    }
+
+    freeaddrinfo(res_ai);
+
+    return fd;
+}
+
+// Ожидает одно подключение TCP.
+static int slcan_socket_accept(const char* addr)
+{
+    int listen_fd = slcan_socket_create(SLCAN_SOCKET_TCP, addr, true);
+    if(listen_fd == -1) return -1;
+
+    if(listen(listen_fd, SLCAN_SOCKET_BACKLOG) == -1){
+        close(listen_fd);
+        return -1;
+    }
+
+    int fd;
+
+    do{
+        fd = accept(listen_fd, NULL, NULL);
+    }while(fd == -1 && errno == EINTR);
+
+    close(listen_fd);
+
+    return fd;
+}
+
+
+// Префикс имени порта.
+#define SLCAN_SOCKET_PREFIX(name, prefix) (strncmp((name), (prefix), sizeof(prefix) - 1) == 0)
+// Адрес после префикса имени порта.
+#define SLCAN_SOCKET_ADDR(name, prefix) (&(name)[sizeof(prefix) - 1])
+
+static int slcan_socket_open_port(void* ctx, const char* name, slcan_serial_handle_t* serial_port)
+{
+    slcan_socket_t* sock = (slcan_socket_t*)ctx;
+
+    if(sock == NULL || name == NULL || serial_port == NULL){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    int fd;
+
+    if(SLCAN_SOCKET_PREFIX(name, "tcp-listen:")){
+        sock->type = SLCAN_SOCKET_TCP;
+        fd = slcan_socket_accept(SLCAN_SOCKET_ADDR(name, "tcp-listen:"));
+        sock->connected = true;
+    }else if(SLCAN_SOCKET_PREFIX(name, "tcp:")){
+        sock->type = SLCAN_SOCKET_TCP;
+        fd = slcan_socket_create(SLCAN_SOCKET_TCP, SLCAN_SOCKET_ADDR(name, "tcp:"), false);
+        sock->connected = true;
+    }else if(SLCAN_SOCKET_PREFIX(name, "udp-listen:")){
+        sock->type = SLCAN_SOCKET_UDP;
+        fd = slcan_socket_create(SLCAN_SOCKET_UDP, SLCAN_SOCKET_ADDR(name, "udp-listen:"), true);
+        // peer is the sender of the first datagram.
+        sock->connected = false;
+    }else if(SLCAN_SOCKET_PREFIX(name, "udp:")){
+        sock->type = SLCAN_SOCKET_UDP;
+        fd = slcan_socket_create(SLCAN_SOCKET_UDP, SLCAN_SOCKET_ADDR(name, "udp:"), false);
+        sock->connected = true;
+    }else{
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    if(fd == -1) return SLCAN_IO_FAIL;
+
+    if(slcan_socket_set_nonblock(fd) == -1 ||
+       (sock->type == SLCAN_SOCKET_TCP && slcan_socket_set_nodelay(fd) == -1)){
+        close(fd);
+        return SLCAN_IO_FAIL;
+    }
+
+    sock->fd = fd;
+    sock->rxpos = 0;
+    sock->rxlen = 0;
+
+    *serial_port = SOCKET_TO_HANDLE(fd);
+
+    return SLCAN_IO_SUCCESS;
+}
+
+static void slcan_socket_close(void* ctx, slcan_serial_handle_t serial_port)
+{
+    slcan_socket_t* sock = (slcan_socket_t*)ctx;
+
+    close(HANDLE_TO_SOCKET(serial_port));
+
+    sock->fd = -1;
+    sock->connected = false;
+    sock->rxpos = 0;
+    sock->rxlen = 0;
+}
+
+static slcan_port_caps_t slcan_socket_caps(void* ctx, slcan_serial_handle_t serial_port)
+{
+    (void) ctx;
+    (void) serial_port;
+
+    return SLCAN_PORT_CAP_NONBLOCK_READ | SLCAN_PORT_CAP_WRITEV;
+}
+
+// Принимает датаграмму, запоминая адрес отправителя первой датаграммы.
+static ssize_t slcan_socket_recv_dgram(slcan_socket_t* sock, void* data, size_t data_size)
+{
+    if(sock->connected) return recv(sock->fd, data, data_size, 0);
+
+    struct sockaddr_storage addr;
+    socklen_t addr_len = sizeof(addr);
+
+    ssize_t res = recvfrom(sock->fd, data, data_size, 0, (struct sockaddr*)&addr, &addr_len);
+    if(res == -1) return res;
+
+    if(connect(sock->fd, (struct sockaddr*)&addr, addr_len) == 0){
+        sock->connected = true;
+    }
+
+    return res;
+}
+
+static int slcan_socket_read(void* ctx, slcan_serial_handle_t serial_port, void* data, size_t data_size)
+{
+    slcan_socket_t* sock = (slcan_socket_t*)ctx;
+    ssize_t res;
+
+    if(sock->type == SLCAN_SOCKET_TCP){
+        res = recv(HANDLE_TO_SOCKET(serial_port), data, data_size, 0);
+        // connection closed by peer.
+        if(res == 0 && data_size != 0){
+            errno = ECONNRESET;
+            return SLCAN_IO_FAIL;
+        }
+        return (int)res;
+    }
+
+    size_t size;
+
+    // rest of the last datagram.
+    if(sock->rxpos < sock->rxlen){
+        size = MIN(data_size, sock->rxlen - sock->rxpos);
+        memcpy(data, &sock->rxbuf[sock->rxpos], size);
+        sock->rxpos += size;
+        return (int)size;
+    }
+
+    // whole datagram fits.
+    if(data_size >= SLCAN_SOCKET_DGRAM_SIZE){
+        return (int)slcan_socket_recv_dgram(sock, data, data_size);
+    }
+
+    res = slcan_socket_recv_dgram(sock, sock->rxbuf, SLCAN_SOCKET_DGRAM_SIZE);
+    if(res == -1) return SLCAN_IO_FAIL;
+
+    size = MIN(data_size, (size_t)res);
+    memcpy(data, sock->rxbuf, size);
+
+    sock->rxpos = size;
+    sock->rxlen = (size_t)res;
+
+    return (int)size;
+}
+
+ALWAYS_INLINE static bool slcan_socket_is_eom(uint8_t byte)
+{
+    return byte == SLCAN_EOM_BYTE || byte == SLCAN_ERR_BYTE;
+}
+
+// Отправляет датаграмму из целых команд.
+static int slcan_socket_send_dgram(slcan_socket_t* sock, const slcan_serial_iovec_t* iov, size_t iovcnt)
+{
+    if(!sock->connected){
+        // nobody to send yet.
+        errno = EAGAIN;
+        return SLCAN_IO_FAIL;
+    }
+
+    struct iovec msg_iov[SLCAN_SOCKET_IOV_MAX];
+    size_t count = 0;
+    size_t size = 0;
+    size_t len, i;
+
+    // limit datagram size.
+    for(i = 0; i < iovcnt && count < SLCAN_SOCKET_IOV_MAX && size < SLCAN_SOCKET_DGRAM_SIZE; i ++){
+        len = MIN(iov[i].size, SLCAN_SOCKET_DGRAM_SIZE - size);
+        if(len == 0) continue;
+
+        msg_iov[count].iov_base = (void*)iov[i].data;
+        msg_iov[count].iov_len = len;
+        size += len;
+        count ++;
+    }
+
+    if(count == 0) return 0;
+
+    // cut datagram after the last command.
+    const uint8_t* data;
+    size_t n = count;
+
+    while(n != 0){
+        data = (const uint8_t*)msg_iov[n - 1].iov_base;
+        len = msg_iov[n - 1].iov_len;
+
+        while(len != 0 && !slcan_socket_is_eom(data[len - 1])) len --;
+
+        if(len != 0){
+            msg_iov[n - 1].iov_len = len;
+            break;
+        }
+
+        n --;
+    }
+
+    // no command end - send as is.
+    if(n != 0) count = n;
+
+    struct msghdr msg;
+
+    memset(&msg, 0x0, sizeof(msg));
+    msg.msg_iov = msg_iov;
+    msg.msg_iovlen = count;
+
+    return (int)sendmsg(sock->fd, &msg, 0);
+}
+
+static int slcan_socket_write(void* ctx, slcan_serial_handle_t serial_port, const void* data, size_t data_size)
+{
+    slcan_socket_t* sock = (slcan_socket_t*)ctx;
+
+    if(sock->type == SLCAN_SOCKET_TCP){
+        return (int)send(HANDLE_TO_SOCKET(serial_port), data, data_size, MSG_NOSIGNAL);
+    }
+
+    slcan_serial_iovec_t iov;
+
+    iov.data = data;
+    iov.size = data_size;
+
+    return slcan_socket_send_dgram(sock, &iov, 1);
+}
+
+static int slcan_socket_writev(void* ctx, slcan_serial_handle_t serial_port, const slcan_serial_iovec_t* iov, size_t iovcnt)
+{
+    slcan_socket_t* sock = (slcan_socket_t*)ctx;
+
+    if(sock->type == SLCAN_SOCKET_UDP){
+        return slcan_socket_send_dgram(sock, iov, iovcnt);
+    }
+
+    struct iovec msg_iov[SLCAN_SOCKET_IOV_MAX];
+    size_t i;
+
+    if(iovcnt > SLCAN_SOCKET_IOV_MAX) iovcnt = SLCAN_SOCKET_IOV_MAX;
+
+    for(i = 0; i < iovcnt; i ++){
+        msg_iov[i].iov_base = (void*)iov[i].data;
+        msg_iov[i].iov_len = iov[i].size;
+    }
+
+    struct msghdr msg;
+
+    memset(&msg, 0x0, sizeof(msg));
+    msg.msg_iov = msg_iov;
+    msg.msg_iovlen = iovcnt;
+
+    // one segment for all spans.
+    return (int)sendmsg(HANDLE_TO_SOCKET(serial_port), &msg, MSG_NOSIGNAL);
+}
+
+ALWAYS_INLINE static bool slcan_socket_rx_buffered(const slcan_socket_t* sock)
+{
+    return sock->rxpos < sock->rxlen;
+}
+
+static int slcan_socket_poll(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, int timeout)
+{
+    slcan_socket_t* sock = (slcan_socket_t*)ctx;
+
+    // buffered datagram is ready without waiting.
+    if((events & SLCAN_POLLIN) && slcan_socket_rx_buffered(sock)){
+        int res = slcan_serial_poll(serial_port, events & ~SLCAN_POLLIN, revents, 0);
+        if(res == SLCAN_IO_FAIL) return res;
+
+        *revents |= SLCAN_POLLIN;
+
+        return SLCAN_IO_SUCCESS;
+    }
+
+    return slcan_serial_poll(serial_port, events, revents, timeout);
+}
+
+static int slcan_socket_poll_event(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, slcan_event_handle_t event, bool* signaled, int timeout)
+{
+    slcan_socket_t* sock = (slcan_socket_t*)ctx;
+
+    if((events & SLCAN_POLLIN) && slcan_socket_rx_buffered(sock)){
+        int res = slcan_serial_poll_event(serial_port, events & ~SLCAN_POLLIN, revents, event, signaled, 0);
+        if(res == SLCAN_IO_FAIL) return res;
+
+        *revents |= SLCAN_POLLIN;
+
+        return SLCAN_IO_SUCCESS;
+    }
+
+    return slcan_serial_poll_event(serial_port, events, revents, event, signaled, timeout);
+}
+
+
+const slcan_port_ops_t slcan_socket_ops = {
+    .open = slcan_socket_open_port,
+    .close = slcan_socket_close,
+    .caps = slcan_socket_caps,
+    .configure = NULL,
+    .read = slcan_socket_read,
+    .write = slcan_socket_write,
+    .writev = slcan_socket_writev,
+    .poll = slcan_socket_poll,
+    .poll_event = slcan_socket_poll_event,
+    .nbytes = NULL,
+};
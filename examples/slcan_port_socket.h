@@ -0,0 +1,74 @@
+/**
+ * @file slcan_port_socket.h
+ * Транспорт поверх TCP и UDP сокетов.
+ */
+
+#ifndef SLCAN_PORT_SOCKET_H_
+#define SLCAN_PORT_SOCKET_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "slcan_defs.h"
+#include "slcan_err.h"
+#include "slcan.h"
+
+
+//! Максимальный размер датаграммы UDP (MTU Ethernet без заголовков IP и UDP).
+#ifndef SLCAN_SOCKET_DGRAM_SIZE
+#define SLCAN_SOCKET_DGRAM_SIZE 1472
+#endif
+
+//! Длина очереди входящих соединений.
+#define SLCAN_SOCKET_BACKLOG 1
+
+
+//! Перечисление типов сокета.
+typedef enum _Slcan_Socket_Type {
+    SLCAN_SOCKET_TCP = 0, //!< Поток TCP.
+    SLCAN_SOCKET_UDP = 1, //!< Датаграммы UDP.
+} slcan_socket_type_t;
+
+//! Сокет.
+typedef struct _Slcan_Socket {
+    int fd; //!< Дескриптор сокета.
+    slcan_socket_type_t type; //!< Тип сокета.
+    bool connected; //!< Флаг известного адреса удалённой стороны.
+    size_t rxpos; //!< Позиция непрочитанных данных датаграммы.
+    size_t rxlen; //!< Размер принятой датаграммы.
+    uint8_t rxbuf[SLCAN_SOCKET_DGRAM_SIZE]; //!< Буфер принятой датаграммы.
+} slcan_socket_t;
+
+
+/**
+ * Функции транспорта сокета.
+ * Контекстом является slcan_socket_t, один на интерфейс.
+ * Имя порта:
+ * "tcp:HOST:PORT" - подключение к серверу TCP;
+ * "tcp-listen:PORT" - ожидание одного подключения TCP;
+ * "udp:HOST:PORT" - обмен датаграммами с HOST:PORT;
+ * "udp-listen:PORT" - обмен датаграммами с отправителем первой датаграммы.
+ * Идентификатор порта - файловый дескриптор, совместимый
+ * с функциями slcan_serial_poll* и реактором.
+ * Датаграммы UDP содержат только целые команды.
+ */
+EXTERN const slcan_port_ops_t slcan_socket_ops;
+
+
+/**
+ * Инициализирует сокет.
+ * @param sock Сокет.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_socket_init(slcan_socket_t* sock);
+
+/**
+ * Открывает порт интерфейса через сокет.
+ * @param sc Интерфейс.
+ * @param name Имя порта.
+ * @param sock Сокет.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_socket_open(slcan_t* sc, const char* name, slcan_socket_t* sock);
+
+#endif /* SLCAN_PORT_SOCKET_H_ */
@@ -0,0 +1,790 @@
+#include "slcan_port_uring.h"
+#include "slcan_port.h"
+#include "slcan_utils.h"
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include <assert.h>
+
+
+// Многократное чтение (Linux 6.7), отсутствует в старых заголовках.
+#define SLCAN_IORING_OP_READ_MULTISHOT 49
+
+// Смещение "текущая позиция файла".
+#define SLCAN_URING_OFF_CURRENT ((__u64)-1)
+
+// Типы запросов в user_data.
+#define SLCAN_URING_OP_READ 1
+#define SLCAN_URING_OP_WRITE 2
+#define SLCAN_URING_OP_CANCEL 3
+
+// Формирует user_data запроса порта.
+#define SLCAN_URING_USER_DATA(port, op)\
+    (((__u64)(port)->gen << 32) | ((__u64)(port)->bgid << 8) | (__u64)(op))
+// Получает тип запроса из user_data.
+#define SLCAN_URING_USER_DATA_OP(ud) ((unsigned)((ud) & 0xff))
+// Получает слот порта из user_data.
+#define SLCAN_URING_USER_DATA_SLOT(ud) ((unsigned)(((ud) >> 8) & 0xffffff))
+// Получает номер открытия порта из user_data.
+#define SLCAN_URING_USER_DATA_GEN(ud) ((uint32_t)((ud) >> 32))
+
+// Число попыток дождаться завершения запросов при закрытии порта.
+#define SLCAN_URING_CLOSE_TRIES 10
+// Тайм-аут одной попытки, нс.
+#define SLCAN_URING_CLOSE_WAIT_NS 10000000
+
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags, const void* arg, size_t argsz)
+{
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, argsz);
+}
+
+static int sys_io_uring_register(int fd, unsigned opcode, const void* arg, unsigned nr_args)
+{
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+
+slcan_err_t slcan_uring_init(slcan_uring_t* uring)
+{
+    assert(uring != NULL);
+
+    memset(uring, 0x0, sizeof(slcan_uring_t));
+    uring->fd = -1;
+
+    struct io_uring_params params;
+
+    memset(&params, 0x0, sizeof(params));
+
+    int fd = sys_io_uring_setup(SLCAN_URING_ENTRIES, &params);
+    if(fd == -1) return E_SLCAN_IO_ERROR;
+
+    // timed waits.
+    if(!(params.features & IORING_FEAT_EXT_ARG)){
+        close(fd);
+        return E_SLCAN_IO_ERROR;
+    }
+
+    uring->fd = fd;
+
+    uring->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    uring->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        uring->sq_size = MAX(uring->sq_size, uring->cq_size);
+        uring->cq_size = uring->sq_size;
+    }
+
+    uring->sq_ptr = mmap(NULL, uring->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if(uring->sq_ptr == MAP_FAILED){
+        uring->sq_ptr = NULL;
+        slcan_uring_deinit(uring);
+        return E_SLCAN_IO_ERROR;
+    }
+
+    if(params.features & IORING_FEAT_SINGLE_MMAP){
+        uring->cq_ptr = uring->sq_ptr;
+    }else{
+        uring->cq_ptr = mmap(NULL, uring->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if(uring->cq_ptr == MAP_FAILED){
+            uring->cq_ptr = NULL;
+            slcan_uring_deinit(uring);
+            return E_SLCAN_IO_ERROR;
+        }
+    }
+
+    uring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    uring->sqes = (struct io_uring_sqe*)mmap(NULL, uring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if(uring->sqes == MAP_FAILED){
+        uring->sqes = NULL;
+        slcan_uring_deinit(uring);
+        return E_SLCAN_IO_ERROR;
+    }
+
+    uint8_t* sq = (uint8_t*)uring->sq_ptr;
+    uint8_t* cq = (uint8_t*)uring->cq_ptr;
+
+    uring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    uring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    uring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    uring->sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+    uring->sq_entries = *(unsigned*)(sq + params.sq_off.ring_entries);
+    uring->sq_local_tail = *uring->sq_tail;
+
+    uring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    uring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    uring->cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+    uring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    return E_SLCAN_NO_ERROR;
+}
+
+void slcan_uring_deinit(slcan_uring_t* uring)
+{
+    assert(uring != NULL);
+
+    if(uring->sqes != NULL){
+        munmap(uring->sqes, uring->sqes_size);
+        uring->sqes = NULL;
+    }
+    if(uring->cq_ptr != NULL && uring->cq_ptr != uring->sq_ptr){
+        munmap(uring->cq_ptr, uring->cq_size);
+    }
+    uring->cq_ptr = NULL;
+    if(uring->sq_ptr != NULL){
+        munmap(uring->sq_ptr, uring->sq_size);
+        uring->sq_ptr = NULL;
+    }
+    if(uring->fd != -1){
+        close(uring->fd);
+        uring->fd = -1;
+    }
+}
+
+
+// Число подготовленных и не отправленных запросов.
+ALWAYS_INLINE static unsigned slcan_uring_sq_pending(const slcan_uring_t* uring)
+{
+    return uring->sq_local_tail - __atomic_load_n(uring->sq_head, __ATOMIC_ACQUIRE);
+}
+
+// Отправляет подготовленные запросы и ждёт min_complete завершений.
+static int slcan_uring_enter(slcan_uring_t* uring, unsigned min_complete, const struct timespec* tp_timeout)
+{
+    unsigned to_submit = slcan_uring_sq_pending(uring);
+
+    if(to_submit == 0 && min_complete == 0) return SLCAN_IO_SUCCESS;
+
+    // publish prepared entries.
+    __atomic_store_n(uring->sq_tail, uring->sq_local_tail, __ATOMIC_RELEASE);
+
+    unsigned flags = IORING_ENTER_EXT_ARG;
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+
+    memset(&arg, 0x0, sizeof(arg));
+
+    if(min_complete != 0){
+        flags |= IORING_ENTER_GETEVENTS;
+
+        if(tp_timeout != NULL){
+            ts.tv_sec = tp_timeout->tv_sec;
+            ts.tv_nsec = tp_timeout->tv_nsec;
+            arg.ts = (__u64)(uintptr_t)&ts;
+        }
+    }
+
+    int res = sys_io_uring_enter(uring->fd, to_submit, min_complete, flags, &arg, sizeof(arg));
+    uring->stats.enters ++;
+
+    if(res == -1){
+        // timeout, signal or full completion ring.
+        if(errno == ETIME || errno == EINTR || errno == EBUSY || errno == EAGAIN) return SLCAN_IO_SUCCESS;
+        return SLCAN_IO_FAIL;
+    }
+
+    return SLCAN_IO_SUCCESS;
+}
+
+// Резервирует count элементов очереди отправки.
+static bool slcan_uring_sq_reserve(slcan_uring_t* uring, unsigned count)
+{
+    if(uring->sq_entries - slcan_uring_sq_pending(uring) >= count) return true;
+
+    // submit prepared entries to free the ring.
+    if(slcan_uring_enter(uring, 0, NULL) == SLCAN_IO_FAIL) return false;
+
+    return uring->sq_entries - slcan_uring_sq_pending(uring) >= count;
+}
+
+// Получает элемент очереди отправки, зарезервированный ранее.
+static struct io_uring_sqe* slcan_uring_get_sqe(slcan_uring_t* uring)
+{
+    unsigned index = uring->sq_local_tail & uring->sq_mask;
+
+    struct io_uring_sqe* sqe = &uring->sqes[index];
+
+    memset(sqe, 0x0, sizeof(struct io_uring_sqe));
+    uring->sq_array[index] = index;
+    uring->sq_local_tail ++;
+
+    return sqe;
+}
+
+
+ALWAYS_INLINE static size_t slcan_uring_port_rxq_count(const slcan_uring_port_t* port)
+{
+    return port->rxq_tail - port->rxq_head;
+}
+
+ALWAYS_INLINE static void slcan_uring_port_add_buf(slcan_uring_port_t* port, uint16_t bid)
+{
+    // do not touch resv of the first entry, it is the ring tail.
+    struct io_uring_buf* buf = &port->buf_ring->bufs[port->buf_ring_tail & (SLCAN_URING_RX_BUFS - 1)];
+
+    buf->addr = (__u64)(uintptr_t)port->rxbufs[bid];
+    buf->len = SLCAN_URING_RX_BUF_SIZE;
+    buf->bid = bid;
+
+    port->buf_ring_tail ++;
+}
+
+ALWAYS_INLINE static void slcan_uring_port_publish_bufs(slcan_uring_port_t* port)
+{
+    __atomic_store_n(&port->buf_ring->tail, port->buf_ring_tail, __ATOMIC_RELEASE);
+}
+
+static void slcan_uring_port_arm_read(slcan_uring_port_t* port)
+{
+    if(port->read_armed || port->read_cancel || port->err != 0) return;
+    // all buffers are waiting for the reader.
+    if(slcan_uring_port_rxq_count(port) == SLCAN_URING_RX_BUFS) return;
+
+    if(!slcan_uring_sq_reserve(port->uring, 1)) return;
+
+    struct io_uring_sqe* sqe = slcan_uring_get_sqe(port->uring);
+
+    sqe->opcode = SLCAN_IORING_OP_READ_MULTISHOT;
+    sqe->fd = port->fd;
+    sqe->off = SLCAN_URING_OFF_CURRENT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = port->bgid;
+    sqe->user_data = SLCAN_URING_USER_DATA(port, SLCAN_URING_OP_READ);
+
+    port->read_armed = true;
+}
+
+static void slcan_uring_port_submit_tx(slcan_uring_port_t* port)
+{
+    // one chain at a time keeps the order of the data.
+    if(port->tx_inflight != 0 || port->err != 0) return;
+
+    slcan_io_fifo_span_t spans[SLCAN_IO_FIFO_SPANS_MAX];
+
+    size_t count = slcan_io_fifo_read_spans(&port->txfifo, spans);
+    if(count == 0) return;
+
+    if(!slcan_uring_sq_reserve(port->uring, (unsigned)count)) return;
+
+    struct io_uring_sqe* sqe;
+    size_t i;
+
+    for(i = 0; i < count; i ++){
+        sqe = slcan_uring_get_sqe(port->uring);
+
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = port->fd;
+        sqe->off = SLCAN_URING_OFF_CURRENT;
+        sqe->addr = (__u64)(uintptr_t)spans[i].data;
+        sqe->len = (__u32)spans[i].size;
+        // short write cancels the rest of the chain.
+        sqe->flags = (i + 1 < count) ? IOSQE_IO_LINK : 0;
+        sqe->user_data = SLCAN_URING_USER_DATA(port, SLCAN_URING_OP_WRITE);
+
+        port->tx_inflight ++;
+    }
+}
+
+static void slcan_uring_port_complete_read(slcan_uring_port_t* port, int res, unsigned flags)
+{
+    if(flags & IORING_CQE_F_BUFFER){
+        uint16_t bid = (uint16_t)(flags >> IORING_CQE_BUFFER_SHIFT);
+
+        if(res > 0){
+            slcan_uring_rx_t* rx = &port->rxq[port->rxq_tail & (SLCAN_URING_RX_BUFS - 1)];
+            rx->bid = bid;
+            rx->size = (uint16_t)res;
+            port->rxq_tail ++;
+        }else{
+            slcan_uring_port_add_buf(port, bid);
+            slcan_uring_port_publish_bufs(port);
+        }
+    }
+
+    if(!(flags & IORING_CQE_F_MORE)){
+        port->read_armed = false;
+    }
+
+    if(port->read_cancel) return;
+
+    if(res == 0){
+        // end of file.
+        port->err = ECONNRESET;
+    }else if(res < 0 && res != -ENOBUFS && res != -EAGAIN && res != -EINTR){
+        port->err = -res;
+    }
+}
+
+static void slcan_uring_port_complete_write(slcan_uring_port_t* port, int res)
+{
+    if(port->tx_inflight != 0) port->tx_inflight --;
+
+    if(res > 0){
+        slcan_io_fifo_data_readed(&port->txfifo, (size_t)res);
+    }else if(res < 0 && res != -ECANCELED && res != -EAGAIN && res != -EINTR){
+        port->err = -res;
+    }
+}
+
+// Обрабатывает завершения всех портов без системных вызовов.
+static void slcan_uring_reap(slcan_uring_t* uring)
+{
+    unsigned head = *uring->cq_head;
+    unsigned tail = __atomic_load_n(uring->cq_tail, __ATOMIC_ACQUIRE);
+
+    if(head == tail) return;
+
+    struct io_uring_cqe* cqe;
+    slcan_uring_port_t* port;
+    unsigned slot;
+
+    for(; head != tail; head ++){
+        cqe = &uring->cqes[head & uring->cq_mask];
+
+        uring->stats.cqes ++;
+
+        slot = SLCAN_URING_USER_DATA_SLOT(cqe->user_data);
+        if(slot >= SLCAN_URING_PORTS_MAX) continue;
+
+        port = uring->ports[slot];
+        // completion of the closed port.
+        if(port == NULL || port->gen != SLCAN_URING_USER_DATA_GEN(cqe->user_data)) continue;
+
+        switch(SLCAN_URING_USER_DATA_OP(cqe->user_data)){
+        default:
+            break;
+        case SLCAN_URING_OP_READ:
+            slcan_uring_port_complete_read(port, cqe->res, cqe->flags);
+            break;
+        case SLCAN_URING_OP_WRITE:
+            slcan_uring_port_complete_write(port, cqe->res);
+            break;
+        }
+    }
+
+    __atomic_store_n(uring->cq_head, head, __ATOMIC_RELEASE);
+
+    size_t i;
+
+    // prepare next requests, they are submitted by the next enter.
+    for(i = 0; i < SLCAN_URING_PORTS_MAX; i ++){
+        port = uring->ports[i];
+        if(port == NULL) continue;
+
+        slcan_uring_port_arm_read(port);
+        slcan_uring_port_submit_tx(port);
+    }
+}
+
+slcan_err_t slcan_uring_run(slcan_uring_t* uring, const struct timespec* tp_timeout)
+{
+    assert(uring != NULL);
+
+    slcan_uring_reap(uring);
+
+    unsigned min_complete = 1;
+    size_t i;
+
+    // unprocessed data - do not sleep.
+    for(i = 0; i < SLCAN_URING_PORTS_MAX; i ++){
+        if(uring->ports[i] != NULL &&
+           (slcan_uring_port_revents(uring->ports[i]) & (SLCAN_POLLIN | SLCAN_POLLERR))){
+            min_complete = 0;
+            break;
+        }
+    }
+
+    if(slcan_uring_enter(uring, min_complete, tp_timeout) == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    slcan_uring_reap(uring);
+
+    return E_SLCAN_NO_ERROR;
+}
+
+
+slcan_err_t slcan_uring_port_init(slcan_uring_port_t* port, slcan_uring_t* uring, const slcan_port_ops_t* base_ops, void* base_ctx)
+{
+    assert(port != NULL);
+
+    if(uring == NULL) return E_SLCAN_NULL_POINTER;
+
+    port->uring = uring;
+    port->base_ops = base_ops ? base_ops : &slcan_port_default_ops;
+    port->base_ctx = base_ctx;
+    port->fd = -1;
+    port->bgid = 0;
+    port->gen = 0;
+    port->err = 0;
+    port->read_armed = false;
+    port->read_cancel = false;
+    port->buf_ring = NULL;
+    port->buf_ring_size = 0;
+    port->buf_ring_tail = 0;
+    port->rxq_head = 0;
+    port->rxq_tail = 0;
+    port->rx_offset = 0;
+    port->tx_inflight = 0;
+
+    return slcan_io_fifo_init_buf(&port->txfifo, port->txbuf, SLCAN_URING_TX_SIZE);
+}
+
+slcan_err_t slcan_uring_open(slcan_t* sc, const char* name, slcan_uring_port_t* port)
+{
+    return slcan_open_port(sc, name, &slcan_uring_ops, port);
+}
+
+int slcan_uring_port_revents(slcan_uring_port_t* port)
+{
+    assert(port != NULL);
+
+    int revents = 0;
+
+    if(slcan_uring_port_rxq_count(port) != 0) revents |= SLCAN_POLLIN;
+    if(!slcan_io_fifo_full(&port->txfifo)) revents |= SLCAN_POLLOUT;
+    if(port->err != 0) revents |= SLCAN_POLLERR;
+
+    return revents;
+}
+
+
+// Преобразует slcan_serial_handle_t в файловый дескриптор.
+#define HANDLE_TO_FD(H) ((int)(long)(H))
+
+
+static void slcan_uring_port_unregister(slcan_uring_port_t* port)
+{
+    slcan_uring_t* uring = port->uring;
+
+    if(port->buf_ring != NULL){
+        struct io_uring_buf_reg reg;
+
+        memset(&reg, 0x0, sizeof(reg));
+        reg.bgid = port->bgid;
+
+        sys_io_uring_register(uring->fd, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+
+        munmap(port->buf_ring, port->buf_ring_size);
+        port->buf_ring = NULL;
+    }
+
+    if(uring->ports[port->bgid] == port){
+        uring->ports[port->bgid] = NULL;
+    }
+}
+
+static int slcan_uring_port_open(void* ctx, const char* name, slcan_serial_handle_t* serial_port)
+{
+    slcan_uring_port_t* port = (slcan_uring_port_t*)ctx;
+
+    if(port == NULL || port->uring == NULL || serial_port == NULL){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_uring_t* uring = port->uring;
+    size_t slot;
+
+    for(slot = 0; slot < SLCAN_URING_PORTS_MAX; slot ++){
+        if(uring->ports[slot] == NULL) break;
+    }
+    if(slot == SLCAN_URING_PORTS_MAX){
+        errno = EMFILE;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_serial_handle_t handle;
+
+    int res = port->base_ops->open(port->base_ctx, name, &handle);
+    if(res == SLCAN_IO_FAIL) return res;
+
+    port->fd = HANDLE_TO_FD(handle);
+    port->bgid = (uint16_t)slot;
+    port->gen = ++ uring->gen;
+    port->err = 0;
+    port->read_armed = false;
+    port->read_cancel = false;
+    port->rxq_head = 0;
+    port->rxq_tail = 0;
+    port->rx_offset = 0;
+    port->tx_inflight = 0;
+    slcan_io_fifo_reset(&port->txfifo);
+
+    // provided buffers ring.
+    port->buf_ring_size = SLCAN_URING_RX_BUFS * sizeof(struct io_uring_buf);
+    port->buf_ring = (struct io_uring_buf_ring*)mmap(NULL, port->buf_ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(port->buf_ring == MAP_FAILED){
+        port->buf_ring = NULL;
+        port->base_ops->close(port->base_ctx, handle);
+        return SLCAN_IO_FAIL;
+    }
+
+    struct io_uring_buf_reg reg;
+
+    memset(&reg, 0x0, sizeof(reg));
+    reg.ring_addr = (__u64)(uintptr_t)port->buf_ring;
+    reg.ring_entries = SLCAN_URING_RX_BUFS;
+    reg.bgid = port->bgid;
+
+    if(sys_io_uring_register(uring->fd, IORING_REGISTER_PBUF_RING, &reg, 1) == -1){
+        munmap(port->buf_ring, port->buf_ring_size);
+        port->buf_ring = NULL;
+        port->base_ops->close(port->base_ctx, handle);
+        return SLCAN_IO_FAIL;
+    }
+
+    uint16_t bid;
+
+    port->buf_ring_tail = 0;
+    for(bid = 0; bid < SLCAN_URING_RX_BUFS; bid ++){
+        slcan_uring_port_add_buf(port, bid);
+    }
+    slcan_uring_port_publish_bufs(port);
+
+    uring->ports[slot] = port;
+
+    slcan_uring_port_arm_read(port);
+
+    *serial_port = handle;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+static void slcan_uring_port_close(void* ctx, slcan_serial_handle_t serial_port)
+{
+    slcan_uring_port_t* port = (slcan_uring_port_t*)ctx;
+    slcan_uring_t* uring = port->uring;
+
+    struct timespec tp_wait = {0, SLCAN_URING_CLOSE_WAIT_NS};
+    int tries;
+
+    // cancel all requests of the port.
+    if((port->read_armed || port->tx_inflight != 0) && slcan_uring_sq_reserve(uring, 1)){
+        struct io_uring_sqe* sqe = slcan_uring_get_sqe(uring);
+
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->fd = port->fd;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        sqe->user_data = SLCAN_URING_USER_DATA(port, SLCAN_URING_OP_CANCEL);
+
+        port->read_cancel = true;
+    }
+
+    for(tries = 0; tries < SLCAN_URING_CLOSE_TRIES && (port->read_armed || port->tx_inflight != 0); tries ++){
+        if(slcan_uring_enter(uring, 1, &tp_wait) == SLCAN_IO_FAIL) break;
+        slcan_uring_reap(uring);
+    }
+
+    slcan_uring_port_unregister(port);
+
+    port->base_ops->close(port->base_ctx, serial_port);
+
+    port->fd = -1;
+    port->read_armed = false;
+    port->tx_inflight = 0;
+}
+
+static slcan_port_caps_t slcan_uring_port_caps(void* ctx, slcan_serial_handle_t serial_port)
+{
+    (void) ctx;
+    (void) serial_port;
+
+    return SLCAN_PORT_CAP_NONBLOCK_READ | SLCAN_PORT_CAP_WRITEV;
+}
+
+static int slcan_uring_port_configure(void* ctx, slcan_serial_handle_t serial_port, const slcan_port_conf_t* conf)
+{
+    slcan_uring_port_t* port = (slcan_uring_port_t*)ctx;
+
+    if(port->base_ops->configure == NULL) return SLCAN_IO_SUCCESS;
+    if(conf == NULL){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_port_conf_t uring_conf = *conf;
+
+    // zero VMIN makes empty tty read return 0 (end of file)
+    // instead of EAGAIN, that stops multishot read.
+    uring_conf.vmin = 1;
+    uring_conf.vtime = 0;
+
+    return port->base_ops->configure(port->base_ctx, serial_port, &uring_conf);
+}
+
+static int slcan_uring_port_read(void* ctx, slcan_serial_handle_t serial_port, void* data, size_t data_size)
+{
+    (void) serial_port;
+
+    slcan_uring_port_t* port = (slcan_uring_port_t*)ctx;
+
+    if(slcan_uring_port_rxq_count(port) == 0){
+        slcan_uring_reap(port->uring);
+    }
+
+    uint8_t* buf = (uint8_t*)data;
+    slcan_uring_rx_t* rx;
+    size_t size = 0;
+    size_t n;
+    bool returned = false;
+
+    while(size < data_size && slcan_uring_port_rxq_count(port) != 0){
+        rx = &port->rxq[port->rxq_head & (SLCAN_URING_RX_BUFS - 1)];
+
+        n = MIN(data_size - size, rx->size - port->rx_offset);
+
+        memcpy(&buf[size], &port->rxbufs[rx->bid][port->rx_offset], n);
+
+        size += n;
+        port->rx_offset += n;
+
+        // buffer drained - give it back to the kernel.
+        if(port->rx_offset == rx->size){
+            slcan_uring_port_add_buf(port, rx->bid);
+            port->rxq_head ++;
+            port->rx_offset = 0;
+            returned = true;
+        }
+    }
+
+    if(returned){
+        slcan_uring_port_publish_bufs(port);
+        slcan_uring_port_arm_read(port);
+    }
+
+    if(size == 0){
+        errno = port->err ? port->err : EAGAIN;
+        return SLCAN_IO_FAIL;
+    }
+
+    return (int)size;
+}
+
+static int slcan_uring_port_write(void* ctx, slcan_serial_handle_t serial_port, const void* data, size_t data_size)
+{
+    (void) serial_port;
+
+    slcan_uring_port_t* port = (slcan_uring_port_t*)ctx;
+
+    if(port->err != 0){
+        errno = port->err;
+        return SLCAN_IO_FAIL;
+    }
+
+    size_t size = slcan_io_fifo_write(&port->txfifo, (const uint8_t*)data, data_size);
+    if(size == 0){
+        errno = EAGAIN;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_uring_port_submit_tx(port);
+
+    return (int)size;
+}
+
+static int slcan_uring_port_writev(void* ctx, slcan_serial_handle_t serial_port, const slcan_serial_iovec_t* iov, size_t iovcnt)
+{
+    (void) serial_port;
+
+    slcan_uring_port_t* port = (slcan_uring_port_t*)ctx;
+
+    if(port->err != 0){
+        errno = port->err;
+        return SLCAN_IO_FAIL;
+    }
+
+    size_t size = 0;
+    size_t n, i;
+
+    for(i = 0; i < iovcnt; i ++){
+        n = slcan_io_fifo_write(&port->txfifo, (const uint8_t*)iov[i].data, iov[i].size);
+        size += n;
+
+        if(n < iov[i].size) break;
+    }
+
+    if(size == 0 && iovcnt != 0){
+        errno = EAGAIN;
+        return SLCAN_IO_FAIL;
+    }
+
+    slcan_uring_port_submit_tx(port);
+
+    return (int)size;
+}
+
+static int slcan_uring_port_poll(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, int timeout)
+{
+    (void) serial_port;
+
+    slcan_uring_port_t* port = (slcan_uring_port_t*)ctx;
+    slcan_uring_t* uring = port->uring;
+
+    if(revents == NULL){
+        errno = EINVAL;
+        return SLCAN_IO_FAIL;
+    }
+
+    struct timespec tp_end, tp_cur, tp_remain;
+    const struct timespec* p_tp_remain = NULL;
+    int out_events;
+
+    if(timeout > 0){
+        tp_remain.tv_sec = timeout / 1000;
+        tp_remain.tv_nsec = (timeout % 1000) * 1000000;
+
+        slcan_clock_gettime(&tp_cur);
+        slcan_timespec_add(&tp_cur, &tp_remain, &tp_end);
+
+        p_tp_remain = &tp_remain;
+    }
+
+    for(;;){
+        slcan_uring_reap(uring);
+
+        out_events = slcan_uring_port_revents(port) & (events | SLCAN_POLLERR);
+
+        if(out_events != 0 || timeout == 0){
+            // submit prepared requests without waiting.
+            if(slcan_uring_enter(uring, 0, NULL) == SLCAN_IO_FAIL) return SLCAN_IO_FAIL;
+            break;
+        }
+
+        if(slcan_uring_enter(uring, 1, p_tp_remain) == SLCAN_IO_FAIL) return SLCAN_IO_FAIL;
+
+        if(timeout > 0){
+            slcan_clock_gettime(&tp_cur);
+            if(!slcan_timespec_remain(&tp_end, &tp_cur, &tp_remain)){
+                slcan_uring_reap(uring);
+                out_events = slcan_uring_port_revents(port) & (events | SLCAN_POLLERR);
+                break;
+            }
+        }
+    }
+
+    *revents = out_events;
+
+    return SLCAN_IO_SUCCESS;
+}
+
+
+const slcan_port_ops_t slcan_uring_ops = {
+    .open = slcan_uring_port_open,
+    .close = slcan_uring_port_close,
+    .caps = slcan_uring_port_caps,
+    .configure = slcan_uring_port_configure,
+    .read = slcan_uring_port_read,
+    .write = slcan_uring_port_write,
+    .writev = slcan_uring_port_writev,
+    .poll = slcan_uring_port_poll,
+    .poll_event = NULL,
+    .nbytes = NULL,
+};
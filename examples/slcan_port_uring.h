@@ -0,0 +1,193 @@
+/**
+ * @file slcan_port_uring.h
+ * Транспорт на основе io_uring (Linux).
+ */
+
+#ifndef SLCAN_PORT_URING_H_
+#define SLCAN_PORT_URING_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "slcan_defs.h"
+#include "slcan_err.h"
+#include "slcan_io_fifo.h"
+#include "slcan.h"
+
+
+//! Размер очереди отправки io_uring.
+#ifndef SLCAN_URING_ENTRIES
+#define SLCAN_URING_ENTRIES 64
+#endif
+
+//! Максимальное число портов одного io_uring.
+#ifndef SLCAN_URING_PORTS_MAX
+#define SLCAN_URING_PORTS_MAX 32
+#endif
+
+//! Число буферов приёма порта.
+#ifndef SLCAN_URING_RX_BUFS
+#define SLCAN_URING_RX_BUFS 16
+#endif
+
+//! Размер буфера приёма.
+#ifndef SLCAN_URING_RX_BUF_SIZE
+#define SLCAN_URING_RX_BUF_SIZE 256
+#endif
+
+//! Размер буфера передачи порта.
+#ifndef SLCAN_URING_TX_SIZE
+#define SLCAN_URING_TX_SIZE 4096
+#endif
+
+#if (SLCAN_URING_RX_BUFS & (SLCAN_URING_RX_BUFS - 1)) != 0
+#error SLCAN_URING_RX_BUFS must be a power of two!
+#endif
+
+#if (SLCAN_URING_TX_SIZE & (SLCAN_URING_TX_SIZE - 1)) != 0
+#error SLCAN_URING_TX_SIZE must be a power of two!
+#endif
+
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf_ring;
+struct _Slcan_Uring_Port;
+
+
+//! Счётчики io_uring.
+typedef struct _Slcan_Uring_Stats {
+    unsigned long enters; //!< Вызовы io_uring_enter.
+    unsigned long cqes; //!< Обработанные завершения.
+} slcan_uring_stats_t;
+
+//! Кольцо io_uring.
+typedef struct _Slcan_Uring {
+    int fd; //!< Дескриптор io_uring.
+    void* sq_ptr; //!< Отображение кольца отправки.
+    size_t sq_size; //!< Размер отображения кольца отправки.
+    void* cq_ptr; //!< Отображение кольца завершений.
+    size_t cq_size; //!< Размер отображения кольца завершений.
+    struct io_uring_sqe* sqes; //!< Элементы очереди отправки.
+    size_t sqes_size; //!< Размер отображения элементов очереди отправки.
+    unsigned* sq_head; //!< Голова кольца отправки.
+    unsigned* sq_tail; //!< Хвост кольца отправки.
+    unsigned* sq_array; //!< Индексы элементов кольца отправки.
+    unsigned sq_mask; //!< Маска кольца отправки.
+    unsigned sq_entries; //!< Размер кольца отправки.
+    unsigned sq_local_tail; //!< Хвост подготовленных элементов.
+    unsigned* cq_head; //!< Голова кольца завершений.
+    unsigned* cq_tail; //!< Хвост кольца завершений.
+    unsigned cq_mask; //!< Маска кольца завершений.
+    struct io_uring_cqe* cqes; //!< Элементы кольца завершений.
+    struct _Slcan_Uring_Port* ports[SLCAN_URING_PORTS_MAX]; //!< Порты.
+    uint32_t gen; //!< Счётчик открытий портов.
+    slcan_uring_stats_t stats; //!< Счётчики.
+} slcan_uring_t;
+
+//! Принятый буфер.
+typedef struct _Slcan_Uring_Rx {
+    uint16_t bid; //!< Номер буфера.
+    uint16_t size; //!< Размер данных.
+} slcan_uring_rx_t;
+
+//! Порт io_uring.
+typedef struct _Slcan_Uring_Port {
+    slcan_uring_t* uring; //!< Кольцо io_uring.
+    const slcan_port_ops_t* base_ops; //!< Транспорт, открывающий дескриптор.
+    void* base_ctx; //!< Контекст транспорта.
+    int fd; //!< Дескриптор порта.
+    uint16_t bgid; //!< Номер группы буферов приёма и слота порта.
+    uint32_t gen; //!< Номер открытия порта.
+    int err; //!< Код errno ошибки ввода-вывода.
+    bool read_armed; //!< Флаг запущенного многократного чтения.
+    bool read_cancel; //!< Флаг отмены чтения.
+    struct io_uring_buf_ring* buf_ring; //!< Кольцо буферов приёма.
+    size_t buf_ring_size; //!< Размер кольца буферов приёма.
+    uint16_t buf_ring_tail; //!< Хвост кольца буферов приёма.
+    slcan_uring_rx_t rxq[SLCAN_URING_RX_BUFS]; //!< Очередь принятых буферов.
+    size_t rxq_head; //!< Голова очереди принятых буферов.
+    size_t rxq_tail; //!< Хвост очереди принятых буферов.
+    size_t rx_offset; //!< Прочитанные данные первого принятого буфера.
+    unsigned tx_inflight; //!< Число выполняемых записей.
+    slcan_io_fifo_t txfifo; //!< Фифо передачи.
+    uint8_t txbuf[SLCAN_URING_TX_SIZE]; //!< Буфер фифо передачи.
+    uint8_t rxbufs[SLCAN_URING_RX_BUFS][SLCAN_URING_RX_BUF_SIZE]; //!< Буферы приёма.
+} slcan_uring_port_t;
+
+
+/**
+ * Функции транспорта io_uring.
+ * Контекстом является slcan_uring_port_t.
+ * Порт открывается транспортом base_ops, идентификатор которого
+ * должен быть файловым дескриптором (последовательный порт, сокет).
+ * Чтение выполняется многократным запросом в кольцо буферов,
+ * запись - цепочками связанных запросов из буфера передачи.
+ * Поток ввода-вывода и реактор не поддерживаются,
+ * для обслуживания многих портов используется slcan_uring_run().
+ */
+EXTERN const slcan_port_ops_t slcan_uring_ops;
+
+
+/**
+ * Инициализирует io_uring.
+ * @param uring Кольцо io_uring.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_uring_init(slcan_uring_t* uring);
+
+/**
+ * Деинициализирует io_uring.
+ * Все порты должны быть закрыты.
+ * @param uring Кольцо io_uring.
+ */
+EXTERN void slcan_uring_deinit(slcan_uring_t* uring);
+
+/**
+ * Отправляет подготовленные запросы, ждёт не более
+ * чем заданный тайм-аут завершений и обрабатывает их
+ * за один вызов io_uring_enter для всех портов.
+ * @param uring Кольцо io_uring.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_uring_run(slcan_uring_t* uring, const struct timespec* tp_timeout);
+
+/**
+ * Получает счётчики io_uring.
+ * @param uring Кольцо io_uring.
+ * @return Счётчики.
+ */
+ALWAYS_INLINE static slcan_uring_stats_t* slcan_uring_stats(slcan_uring_t* uring)
+{
+    return &uring->stats;
+}
+
+/**
+ * Инициализирует порт io_uring.
+ * @param port Порт.
+ * @param uring Кольцо io_uring.
+ * @param base_ops Транспорт, открывающий дескриптор, NULL - транспорт по-умолчанию.
+ * @param base_ctx Контекст транспорта.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_uring_port_init(slcan_uring_port_t* port, slcan_uring_t* uring, const slcan_port_ops_t* base_ops, void* base_ctx);
+
+/**
+ * Открывает порт интерфейса через io_uring.
+ * @param sc Интерфейс.
+ * @param name Имя порта.
+ * @param port Порт io_uring.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_uring_open(slcan_t* sc, const char* name, slcan_uring_port_t* port);
+
+/**
+ * Получает готовность порта без системных вызовов.
+ * @param port Порт.
+ * @return Готовность порта (SLCAN_POLLIN, SLCAN_POLLOUT, SLCAN_POLLERR).
+ */
+EXTERN int slcan_uring_port_revents(slcan_uring_port_t* port);
+
+#endif /* SLCAN_PORT_URING_H_ */
@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <stdlib.h>
+// slcan
+#include "slcan.h"
+#include "slcan_master.h"
+#include "slcan_utils.h"
+#include "slcan_port_socket.h"
+
+
+// Адрес сервера по-умолчанию (examples/slave_server.c).
+#define SERVER_ADDR "tcp:127.0.0.1:5555"
+
+// Число передаваемых сообщений.
+#define MSGS_COUNT 100000
+
+// Число сообщений в пути - не больше фифо полученных сообщений,
+// иначе эхо-сообщения отбрасываются при переполнении фифо.
+#define MSGS_IN_FLIGHT SLCAN_CAN_EXT_FIFO_SIZE
+
+
+static void gen_can_msg(slcan_can_msg_t* msg, size_t n)
+{
+    size_t i;
+
+    msg->frame_type = SLCAN_CAN_FRAME_NORMAL;
+    msg->id_type = SLCAN_CAN_ID_NORMAL;
+    msg->id = n & 0x7ff;
+    msg->dlc = 8;
+    for(i = 0; i < 8; i ++){
+        msg->data[i] = (n + i) & 0xff;
+    }
+}
+
+
+int main_socket_exchange(int argc, char* argv[])
+{
+    static slcan_t master_slcan;
+    static slcan_master_t master;
+    static slcan_socket_t sock;
+
+    // [addr].
+    const char* addr = (argc > 1) ? argv[1] : SERVER_ADDR;
+
+    if(slcan_init(&master_slcan) != 0){
+        printf("Cann't init slcan!\n");
+        return -1;
+    }
+
+    slcan_socket_init(&sock);
+
+    if(slcan_socket_open(&master_slcan, addr, &sock) != 0){
+        printf("Cann't open socket: %s\n", addr);
+        return -1;
+    }
+
+    if(slcan_master_init(&master, &master_slcan) != 0){
+        printf("Error init slcan master!\n");
+        return -1;
+    }
+
+    printf("Exchanging with %s...\n", addr);
+
+    struct timespec tp_start, tp_end, tp_cur;
+    struct timespec tp_timeout = {0, 100000000}; // 100 ms.
+    struct timespec tp_total = {10, 0}; // 10 s.
+
+    slcan_clock_gettime(&tp_start);
+    slcan_timespec_add(&tp_start, &tp_total, &tp_end);
+
+    slcan_can_msg_t can_msg;
+    slcan_err_t err;
+    size_t sent = 0, received = 0;
+
+    while(received < MSGS_COUNT){
+        while(sent < MSGS_COUNT && sent - received < MSGS_IN_FLIGHT &&
+              slcan_master_send_can_msgs_avail(&master) != 0){
+            gen_can_msg(&can_msg, sent);
+            slcan_master_send_can_msg(&master, &can_msg, NULL);
+            sent ++;
+        }
+
+        err = slcan_master_wait(&master, &tp_timeout);
+        if(err != E_SLCAN_NO_ERROR && err != E_SLCAN_OVERFLOW && err != E_SLCAN_OVERRUN){
+            printf("slcan master err: %d\n", (int)err);
+            break;
+        }
+
+        while(slcan_master_recv_can_msg(&master, &can_msg, NULL) == E_SLCAN_NO_ERROR){
+            received ++;
+        }
+
+        slcan_clock_gettime(&tp_cur);
+        if(slcan_timespec_cmp(&tp_cur, &tp_end, >)) break;
+    }
+
+    slcan_clock_gettime(&tp_cur);
+    slcan_timespec_sub(&tp_cur, &tp_start, &tp_cur);
+
+    printf("sent %u received %u\n", (unsigned int)sent, (unsigned int)received);
+    printf("time: %u.%06u s\n", (unsigned int)tp_cur.tv_sec, (unsigned int)(tp_cur.tv_nsec / 1000));
+
+    printf("Done.\n");
+
+    slcan_master_deinit(&master);
+    slcan_close(&master_slcan);
+    slcan_deinit(&master_slcan);
+
+    return 0;
+}
+
+#if defined(EXAMPLE_SOCKET_EXCHANGE) && EXAMPLE_SOCKET_EXCHANGE == 1
+int main(int argc, char* argv[])
+{
+    return main_socket_exchange(argc, argv);
+}
+#endif
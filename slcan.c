@@ -1,6 +1,7 @@
 #include "slcan.h"
 #include "slcan_utils.h"
 #include "slcan_port.h"
+#include "slcan_scan.h"
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
@@ -19,6 +20,11 @@ slcan_err_t slcan_get_default_port_config(slcan_port_conf_t* conf)
     conf->parity = SLCAN_PORT_PARITY_NONE;
     conf->stop_bits = SLCAN_PORT_STOP_BITS_1;
     conf->baud = SLCAN_PORT_BAUD_57600;
+    conf->baud_rate = 0;
+    conf->flow_control = SLCAN_PORT_FLOW_CONTROL_NONE;
+    conf->low_latency = false;
+    conf->vmin = 0;
+    conf->vtime = 0;
 
     return E_SLCAN_NO_ERROR;
 }
@@ -32,6 +38,41 @@ slcan_err_t slcan_get_port_config(slcan_t* sc, slcan_port_conf_t* conf)
     conf->parity = sc->port_conf.parity;
     conf->stop_bits = sc->port_conf.stop_bits;
     conf->baud = sc->port_conf.baud;
+    conf->baud_rate = sc->port_conf.baud_rate;
+    conf->flow_control = sc->port_conf.flow_control;
+    conf->low_latency = sc->port_conf.low_latency;
+    conf->vmin = sc->port_conf.vmin;
+    conf->vtime = sc->port_conf.vtime;
+
+    return E_SLCAN_NO_ERROR;
+}
+
+slcan_err_t slcan_set_io_buffers(slcan_t* sc, uint8_t* txbuf, size_t txbuf_size, uint8_t* rxbuf, size_t rxbuf_size)
+{
+    assert(sc != NULL);
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    // fifos are in use by io thread.
+    if(slcan_io_thread_running(sc)) return E_SLCAN_STATE;
+#endif
+
+    // check both buffers before changing any fifo.
+    if(!slcan_io_fifo_buf_valid(txbuf, txbuf_size)) return E_SLCAN_INVALID_SIZE;
+    if(!slcan_io_fifo_buf_valid(rxbuf, rxbuf_size)) return E_SLCAN_INVALID_SIZE;
+
+    slcan_err_t err;
+
+    err = slcan_io_fifo_init_buf(&sc->txiofifo, txbuf, txbuf_size);
+    if(err != E_SLCAN_NO_ERROR) return err;
+
+    err = slcan_io_fifo_init_buf(&sc->rxiofifo, rxbuf, rxbuf_size);
+    if(err != E_SLCAN_NO_ERROR) return err;
+
+    sc->txiofifo_watermark = SLCAN_TXIOFIFO_WATERMARK(slcan_io_fifo_size(&sc->txiofifo));
+
+    // drop partially received command.
+    slcan_cmd_buf_reset(&sc->rxcmd);
+    sc->rx_skip = false;
 
     return E_SLCAN_NO_ERROR;
 }
@@ -44,10 +85,90 @@ slcan_serial_handle_t slcan_serial_port(slcan_t* sc)
 }
 
 
+// Увеличивает счётчик вызовов ввода-вывода.
+#if defined(SLCAN_IO_STATS) && SLCAN_IO_STATS == 1
+#define SLCAN_IO_STATS_INC(sc, counter) ((sc)->io_stats.counter ++)
+#else
+#define SLCAN_IO_STATS_INC(sc, counter)
+#endif
+
+
+// Функции транспорта.
+
+ALWAYS_INLINE static int slcan_port_read(slcan_t* sc, void* data, size_t data_size)
+{
+    return sc->port_ops->read(sc->port_ctx, sc->serial_port, data, data_size);
+}
+
+ALWAYS_INLINE static int slcan_port_write(slcan_t* sc, const void* data, size_t data_size)
+{
+    return sc->port_ops->write(sc->port_ctx, sc->serial_port, data, data_size);
+}
+
+ALWAYS_INLINE static int slcan_port_writev(slcan_t* sc, const slcan_serial_iovec_t* iov, size_t iovcnt)
+{
+    return sc->port_ops->writev(sc->port_ctx, sc->serial_port, iov, iovcnt);
+}
+
+ALWAYS_INLINE static int slcan_port_nbytes(slcan_t* sc, size_t* size)
+{
+    return sc->port_ops->nbytes(sc->port_ctx, sc->serial_port, size);
+}
+
+ALWAYS_INLINE static int slcan_port_poll(slcan_t* sc, int events, int* revents, int timeout)
+{
+    return sc->port_ops->poll(sc->port_ctx, sc->serial_port, events, revents, timeout);
+}
+
+
+static slcan_err_t slcan_read_incoming_data(slcan_t* sc)
+{
+    assert(sc != NULL);
+
+    int res;
+    size_t nbytes, size;
+    int i;
+
+    // fifo line and wrapped line.
+    for(i = 0; i < 2; i ++){
+        // avail size in fifo.
+        size = slcan_io_fifo_write_line_size(&sc->rxiofifo);
+        // fifo is full.
+        if(size == 0){
+            break;
+        }
+        // read data.
+        res = slcan_port_read(sc,
+                              slcan_io_fifo_data_to_write(&sc->rxiofifo),
+                              size);
+        SLCAN_IO_STATS_INC(sc, reads);
+        // error.
+        if(res == SLCAN_IO_FAIL){
+            // no data.
+            if(errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return E_SLCAN_IO_ERROR;
+        }
+        // readed data size.
+        nbytes = (size_t)res;
+        // tell size to fifo.
+        slcan_io_fifo_data_written(&sc->rxiofifo, nbytes);
+        // end of transfer.
+        if(nbytes < size){
+            break;
+        }
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
 static slcan_err_t slcan_process_incoming_data(slcan_t* sc)
 {
     assert(sc != NULL);
 
+    if(sc->port_caps & SLCAN_PORT_CAP_NONBLOCK_READ){
+        return slcan_read_incoming_data(sc);
+    }
+
     int res;
     size_t nbytes, size;
 
@@ -59,7 +180,8 @@ static slcan_err_t slcan_process_incoming_data(slcan_t* sc)
             break;
         }
         // count of receiving bytes.
-        res = slcan_serial_nbytes(sc->serial_port, &nbytes);
+        res = slcan_port_nbytes(sc, &nbytes);
+        SLCAN_IO_STATS_INC(sc, nbytes);
         // error.
         if(res == SLCAN_IO_FAIL){
             return E_SLCAN_IO_ERROR;
@@ -71,9 +193,10 @@ static slcan_err_t slcan_process_incoming_data(slcan_t* sc)
         // size to read.
         nbytes = MIN(nbytes, size);
         // read data.
-        res = slcan_serial_read(sc->serial_port,
-                                slcan_io_fifo_data_to_write(&sc->rxiofifo),
-                                nbytes);
+        res = slcan_port_read(sc,
+                              slcan_io_fifo_data_to_write(&sc->rxiofifo),
+                              nbytes);
+        SLCAN_IO_STATS_INC(sc, reads);
         // error.
         if(res == SLCAN_IO_FAIL){
             return E_SLCAN_IO_ERROR;
@@ -87,10 +210,57 @@ static slcan_err_t slcan_process_incoming_data(slcan_t* sc)
     return E_SLCAN_NO_ERROR;
 }
 
+static slcan_err_t slcan_writev_outcoming_data(slcan_t* sc)
+{
+    assert(sc != NULL);
+
+    int res;
+    size_t nbytes, count, i;
+    slcan_io_fifo_span_t spans[SLCAN_IO_FIFO_SPANS_MAX];
+    slcan_serial_iovec_t iov[SLCAN_IO_FIFO_SPANS_MAX];
+
+    for(;;){
+        // data segments in fifo.
+        count = slcan_io_fifo_read_spans(&sc->txiofifo, spans);
+        // fifo is empty.
+        if(count == 0){
+            break;
+        }
+        for(i = 0; i < count; i ++){
+            iov[i].data = spans[i].data;
+            iov[i].size = spans[i].size;
+        }
+        // write data.
+        res = slcan_port_writev(sc, iov, count);
+        SLCAN_IO_STATS_INC(sc, writes);
+        // error.
+        if(res == SLCAN_IO_FAIL){
+            if(errno == EAGAIN) return E_SLCAN_OVERFLOW;
+            return E_SLCAN_IO_ERROR;
+        }
+        // written data size.
+        nbytes = (size_t)res;
+
+        // zero bytes written;
+        if(nbytes == 0){
+            break;
+        }
+
+        // tell size to fifo.
+        slcan_io_fifo_data_readed(&sc->txiofifo, nbytes);
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
 static slcan_err_t slcan_process_outcoming_data(slcan_t* sc)
 {
     assert(sc != NULL);
 
+    if((sc->port_caps & SLCAN_PORT_CAP_WRITEV) && sc->port_ops->writev){
+        return slcan_writev_outcoming_data(sc);
+    }
+
     int res;
     size_t nbytes;
 
@@ -102,9 +272,10 @@ static slcan_err_t slcan_process_outcoming_data(slcan_t* sc)
             break;
         }
         // write data.
-        res = slcan_serial_write(sc->serial_port,
-                                slcan_io_fifo_data_to_read(&sc->txiofifo),
-                                nbytes);
+        res = slcan_port_write(sc,
+                               slcan_io_fifo_data_to_read(&sc->txiofifo),
+                               nbytes);
+        SLCAN_IO_STATS_INC(sc, writes);
         // error.
         if(res == SLCAN_IO_FAIL){
             if(errno == EAGAIN) return E_SLCAN_OVERFLOW;
@@ -126,72 +297,207 @@ static slcan_err_t slcan_process_outcoming_data(slcan_t* sc)
 }
 
 
-static slcan_err_t slcan_rx_cmd_buf_get_cmd(slcan_t* sc, slcan_cmd_t* cmd)
+static slcan_err_t slcan_rx_data_get_cmd(slcan_t* sc, slcan_cmd_t* cmd, const uint8_t* data, size_t size)
 {
     assert(sc != NULL);
 
-    slcan_cmd_buf_t* buf = &sc->rxcmd;
     slcan_err_t err;
 
-    err = slcan_cmd_from_buf(cmd, buf);
+    err = slcan_cmd_from_data(cmd, data, size);
     if(err != E_SLCAN_NO_ERROR) return err;
 
 #if defined(SLCAN_DEBUG_INCOMING_CMDS) && SLCAN_DEBUG_INCOMING_CMDS == 1
-    uint8_t* buf_data = slcan_cmd_buf_data(buf);
-    buf_data[slcan_cmd_buf_size(buf)] = '\0';
     printf("Received msg: ");
-    if(*buf_data == '\r'){
+    if(*data == '\r'){
         printf("'\\r'\n");
-    }else if(*buf_data == '\007'){
+    }else if(*data == '\007'){
         printf("beep\n");
     }else{
-        printf("%s\n", (char*)buf_data);
+        printf("%.*s\n", (int)size, (const char*)data);
     }
 #endif
 
     return E_SLCAN_NO_ERROR;
 }
 
-static slcan_err_t slcan_rx_io_fifo_get_cmd(slcan_t* sc, slcan_cmd_t* cmd)
+// Дополняет буфер принимаемой команды частью команды.
+static slcan_err_t slcan_rx_cmd_buf_append(slcan_cmd_buf_t* buf, const uint8_t* data, size_t size)
+{
+    // msg buf is full.
+    if(slcan_cmd_buf_size(buf) + size > SLCAN_CMD_BUF_SIZE){
+        // drop received data.
+        slcan_cmd_buf_reset(buf);
+        return E_SLCAN_OVERFLOW;
+    }
+
+    memcpy(slcan_cmd_buf_data_end(buf), data, size);
+    slcan_cmd_buf_set_size(buf, slcan_cmd_buf_size(buf) + size);
+
+    return E_SLCAN_NO_ERROR;
+}
+
+// Учитывает отброшенные при приёме данные.
+ALWAYS_INLINE static void slcan_rx_drop(slcan_t* sc, size_t bytes, size_t frames)
+{
+    sc->rx_stats.dropped_bytes += bytes;
+    sc->rx_stats.dropped_frames += frames;
+}
+
+static slcan_err_t slcan_rx_io_fifo_get_cmds(slcan_t* sc, slcan_cmd_t* cmds, size_t max, size_t* n)
 {
     assert(sc != NULL);
 
-    if(cmd == NULL) return E_SLCAN_NULL_POINTER;
+    if(cmds == NULL || n == NULL) return E_SLCAN_NULL_POINTER;
 
-    size_t size;
-    uint8_t byte;
-    slcan_err_t err;
+    slcan_io_fifo_t* fifo = &sc->rxiofifo;
+    slcan_cmd_buf_t* buf = &sc->rxcmd;
+
+    size_t ends[SLCAN_CMDS_BATCH_SIZE];
+    size_t ends_count, ends_max;
+    const uint8_t* data;
+    size_t line_size, size, frame_size, pos, i;
+    size_t count = 0;
+    slcan_err_t err = E_SLCAN_NO_ERROR;
 
     // process data rx fifo.
-    for(;;){
-        // get byte.
-        size = slcan_io_fifo_get(&sc->rxiofifo, &byte);
+    while(count < max){
+        // get contiguous data.
+        line_size = slcan_io_fifo_read_line_size(fifo);
         // fifo is empty.
-        if(size == 0){
-            break;
-        }
+        if(line_size == 0) break;
+
+        data = slcan_io_fifo_data_to_read(fifo);
+
+        // find ends of msgs.
+        ends_max = MIN(max - count, SLCAN_CMDS_BATCH_SIZE);
+        ends_count = slcan_scan_ends(data, line_size, ends, ends_max);
+
+        pos = 0;
+        for(i = 0; i < ends_count; i ++){
+            size = ends[i] - pos + 1;
+            frame_size = size;
+
+            if(i == 0 && sc->rx_skip){
+                // end of dropped msg.
+                err = E_SLCAN_OVERFLOW;
+                sc->rx_skip = false;
+            }else if(i == 0 && slcan_cmd_buf_size(buf) != 0){
+                // msg is split by fifo wrap or by reception,
+                // complete it in msg buf.
+                frame_size += slcan_cmd_buf_size(buf);
+                err = slcan_rx_cmd_buf_append(buf, data, size);
+                if(err == E_SLCAN_NO_ERROR){
+                    err = slcan_rx_data_get_cmd(sc, &cmds[count], slcan_cmd_buf_data_const(buf), slcan_cmd_buf_size(buf));
+                }else if(!sc->rx_resync){
+                    // too long msg is dropped.
+                    slcan_rx_drop(sc, frame_size, 1);
+                }
+                // reset processed msg.
+                slcan_cmd_buf_reset(buf);
+            }else{
+                // whole msg is contiguous - parse in place.
+                err = slcan_rx_data_get_cmd(sc, &cmds[count], &data[pos], size);
+            }
 
-        // put data to msg buf.
-        size = slcan_cmd_buf_put(&sc->rxcmd, byte);
-        // msg buf is full.
-        if(size == 0){
-            // reset received data.
-            slcan_cmd_buf_reset(&sc->rxcmd);
-            return E_SLCAN_OVERFLOW;
+            pos += size;
+
+            if(err != E_SLCAN_NO_ERROR){
+                if(!sc->rx_resync) break;
+
+                // skip invalid msg up to its end.
+                slcan_rx_drop(sc, frame_size, 1);
+                err = E_SLCAN_NO_ERROR;
+                continue;
+            }
+
+            count ++;
         }
 
-        // end of msg.
-        if((byte == SLCAN_EOM_BYTE) || (byte == SLCAN_ERR_BYTE)){
-            // parse msg.
-            err = slcan_rx_cmd_buf_get_cmd(sc, cmd);
-            // reset processed msg.
-            slcan_cmd_buf_reset(&sc->rxcmd);
+        // more msgs may follow.
+        if(err != E_SLCAN_NO_ERROR || ends_count == ends_max){
+            slcan_io_fifo_data_readed(fifo, pos);
+            if(err != E_SLCAN_NO_ERROR) break;
+            continue;
+        }
 
-            return err;
+        size = line_size - pos;
+
+        if(sc->rx_skip){
+            // drop the rest of too long msg.
+            slcan_rx_drop(sc, size, 0);
+        }else{
+            // collect incomplete msg in msg buf.
+            frame_size = slcan_cmd_buf_size(buf) + size;
+            err = slcan_rx_cmd_buf_append(buf, &data[pos], size);
+
+            if(err != E_SLCAN_NO_ERROR){
+                // too long msg is dropped.
+                slcan_rx_drop(sc, frame_size, 0);
+
+                if(sc->rx_resync){
+                    // skip it up to its end.
+                    sc->rx_skip = true;
+                    err = E_SLCAN_NO_ERROR;
+                }
+            }
         }
+        slcan_io_fifo_data_readed(fifo, line_size);
+
+        if(err != E_SLCAN_NO_ERROR) break;
     }
 
-    return E_SLCAN_UNDERFLOW;
+    *n = count;
+
+    if(err == E_SLCAN_NO_ERROR && count == 0) return E_SLCAN_UNDERFLOW;
+
+    return err;
+}
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+static void slcan_io_thread_kick(slcan_t* sc);
+#endif
+
+// Получает флаг команды передачи сообщения CAN.
+ALWAYS_INLINE static bool slcan_cmd_is_transmit(const slcan_cmd_t* cmd)
+{
+    return cmd->type == SLCAN_CMD_TRANSMIT || cmd->type == SLCAN_CMD_TRANSMIT_EXT ||
+           cmd->type == SLCAN_CMD_TRANSMIT_RTR || cmd->type == SLCAN_CMD_TRANSMIT_RTR_EXT;
+}
+
+// Записывает сообщение CAN сразу в фифо передачи.
+static slcan_err_t slcan_tx_io_fifo_put_can_msg(slcan_t* sc, const slcan_cmd_t* cmd)
+{
+    slcan_io_fifo_t* iofifo = &sc->txiofifo;
+    const slcan_can_msg_t* can_msg = &cmd->transmit.can_msg;
+    const slcan_can_msg_extdata_t* extdata = &cmd->transmit.extdata;
+
+    size_t size = slcan_can_msg_encoded_size(can_msg, extdata);
+    if(size == 0) return E_SLCAN_INVALID_VALUE;
+
+    // fifo remain size too small.
+    if(slcan_io_fifo_remain(iofifo) < size) return E_SLCAN_OVERFLOW;
+
+    uint8_t* data;
+
+    if(slcan_io_fifo_write_line_size(iofifo) >= size){
+        // encode in place.
+        data = slcan_io_fifo_data_to_write(iofifo);
+        slcan_can_msg_encode(can_msg, extdata, data);
+        slcan_io_fifo_data_written(iofifo, size);
+    }else{
+        if(size > SLCAN_CMD_BUF_SIZE) return E_SLCAN_OVERFLOW;
+
+        // wrapped space, encode via msg buf.
+        data = slcan_cmd_buf_data(&sc->txcmd);
+        slcan_can_msg_encode(can_msg, extdata, data);
+        slcan_io_fifo_write(iofifo, data, size);
+    }
+
+#if defined(SLCAN_DEBUG_OUTCOMING_CMDS) && SLCAN_DEBUG_OUTCOMING_CMDS == 1
+    printf("Transmitting msg: %.*s\n", (int)(size - 1), (const char*)data);
+#endif
+
+    return E_SLCAN_NO_ERROR;
 }
 
 static slcan_err_t slcan_tx_io_fifo_put_cmd(slcan_t* sc, const slcan_cmd_t* cmd)
@@ -205,30 +511,41 @@ static slcan_err_t slcan_tx_io_fifo_put_cmd(slcan_t* sc, const slcan_cmd_t* cmd)
     slcan_err_t err;
 
     // if fifo ~ full.
-    if(slcan_io_fifo_avail(iofifo) >= SLCAN_TXIOFIFO_WATERMARK){
+    if(slcan_io_fifo_avail(iofifo) >= sc->txiofifo_watermark){
         return E_SLCAN_OVERFLOW;
     }
 
-    // serialize.
-    err = slcan_cmd_to_buf(cmd, buf);
-    if(err != E_SLCAN_NO_ERROR) return err;
+    if(slcan_cmd_is_transmit(cmd)){
+        // fast path for CAN messages.
+        err = slcan_tx_io_fifo_put_can_msg(sc, cmd);
+        if(err != E_SLCAN_NO_ERROR) return err;
+    }else{
+        // serialize.
+        err = slcan_cmd_to_buf(cmd, buf);
+        if(err != E_SLCAN_NO_ERROR) return err;
 
-    // fifo remain size too small.
-    if(!slcan_io_fifo_write_block(iofifo, slcan_cmd_buf_data(buf),
-                                     slcan_cmd_buf_size(buf))){
-        return E_SLCAN_OVERFLOW;
+        // fifo remain size too small.
+        if(!slcan_io_fifo_write_block(iofifo, slcan_cmd_buf_data(buf),
+                                         slcan_cmd_buf_size(buf))){
+            return E_SLCAN_OVERFLOW;
+        }
+
+#if defined(SLCAN_DEBUG_OUTCOMING_CMDS) && SLCAN_DEBUG_OUTCOMING_CMDS == 1
+        const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
+        printf("Transmitting msg: ");
+        if(*buf_data == '\r'){
+            printf("'\\r'\n");
+        }else if(*buf_data == '\007'){
+            printf("beep\n");
+        }else{
+            printf("%.*s\n", (int)slcan_cmd_buf_size(buf), (const char*)buf_data);
+        }
+#endif
     }
 
-#if defined(SLCAN_DEBUG_INCOMING_CMDS) && SLCAN_DEBUG_INCOMING_CMDS == 1
-    uint8_t* buf_data = slcan_cmd_buf_data(buf);
-    buf_data[slcan_cmd_buf_size(buf)] = '\0';
-    printf("Transmitting msg: ");
-    if(*buf_data == '\r'){
-        printf("'\\r'\n");
-    }else if(*buf_data == '\007'){
-        printf("beep\n");
-    }else{
-        printf("%s\n", (char*)buf_data);
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    if(slcan_io_thread_running(sc)){
+        slcan_io_thread_kick(sc);
     }
 #endif
 
@@ -236,6 +553,90 @@ static slcan_err_t slcan_tx_io_fifo_put_cmd(slcan_t* sc, const slcan_cmd_t* cmd)
 }
 
 
+static slcan_err_t slcan_tx_io_fifo_put_can_msgs(slcan_t* sc, const slcan_can_msg_t* can_msgs, size_t count, size_t* n)
+{
+    assert(sc != NULL);
+
+    if(can_msgs == NULL || n == NULL) return E_SLCAN_NULL_POINTER;
+
+    slcan_io_fifo_t* iofifo = &sc->txiofifo;
+    slcan_err_t err = E_SLCAN_NO_ERROR;
+
+    size_t avail = slcan_io_fifo_avail(iofifo);
+    size_t remain = slcan_io_fifo_remain(iofifo);
+    size_t line_size = slcan_io_fifo_write_line_size(iofifo);
+    uint8_t* line = slcan_io_fifo_data_to_write(iofifo);
+    uint8_t* data;
+    size_t line_pos = 0;
+    size_t total = 0;
+    size_t size, i;
+
+    for(i = 0; i < count; i ++){
+        // if fifo ~ full.
+        if(avail + total >= sc->txiofifo_watermark) break;
+
+        size = slcan_can_msg_encoded_size(&can_msgs[i], NULL);
+        if(size == 0){
+            err = E_SLCAN_INVALID_VALUE;
+            break;
+        }
+
+        // fifo remain size too small.
+        if(remain - total < size) break;
+
+        if(line_size - line_pos >= size){
+            // encode in place, back-to-back.
+            data = &line[line_pos];
+            slcan_can_msg_encode(&can_msgs[i], NULL, data);
+            line_pos += size;
+        }else{
+            if(size > SLCAN_CMD_BUF_SIZE){
+                err = E_SLCAN_OVERFLOW;
+                break;
+            }
+
+            // commit encoded msgs.
+            slcan_io_fifo_data_written(iofifo, line_pos);
+
+            // wrapped space, encode via msg buf.
+            data = slcan_cmd_buf_data(&sc->txcmd);
+            slcan_can_msg_encode(&can_msgs[i], NULL, data);
+            slcan_io_fifo_write(iofifo, data, size);
+
+            line_size = slcan_io_fifo_write_line_size(iofifo);
+            line = slcan_io_fifo_data_to_write(iofifo);
+            line_pos = 0;
+        }
+
+        total += size;
+
+#if defined(SLCAN_DEBUG_OUTCOMING_CMDS) && SLCAN_DEBUG_OUTCOMING_CMDS == 1
+        printf("Transmitting msg: %.*s\n", (int)(size - 1), (const char*)data);
+#endif
+    }
+
+    // commit encoded msgs.
+    if(line_pos != 0){
+        slcan_io_fifo_data_written(iofifo, line_pos);
+    }
+
+    *n = i;
+
+    if(i == 0){
+        if(err == E_SLCAN_NO_ERROR && count != 0) return E_SLCAN_OVERFLOW;
+        return err;
+    }
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    if(slcan_io_thread_running(sc)){
+        slcan_io_thread_kick(sc);
+    }
+#endif
+
+    return err;
+}
+
+
 slcan_err_t slcan_init(slcan_t* sc)
 {
     assert(sc != NULL);
@@ -244,14 +645,46 @@ slcan_err_t slcan_init(slcan_t* sc)
 
     slcan_io_fifo_init(&sc->txiofifo);
     slcan_io_fifo_init(&sc->rxiofifo);
+    sc->txiofifo_watermark = SLCAN_TXIOFIFO_WATERMARK(slcan_io_fifo_size(&sc->txiofifo));
     slcan_cmd_buf_init(&sc->txcmd);
     slcan_cmd_buf_init(&sc->rxcmd);
+    sc->rx_resync = SLCAN_RX_RESYNC_DEFAULT;
+    sc->rx_skip = false;
+    slcan_rx_stats_reset(sc);
+
+    // unsupported default - the port monotonic clock.
+    if(slcan_clock_init(&sc->clock, SLCAN_CLOCK_SOURCE_DEFAULT) != E_SLCAN_NO_ERROR){
+        slcan_clock_init(&sc->clock, SLCAN_CLOCK_SOURCE_MONOTONIC);
+    }
 
+    sc->port_ops = &slcan_port_default_ops;
+    sc->port_ctx = NULL;
     sc->serial_port = SLCAN_IO_INVALID_HANDLE;
+    sc->port_caps = SLCAN_PORT_CAP_NONE;
+
+#if defined(SLCAN_IO_STATS) && SLCAN_IO_STATS == 1
+    slcan_io_stats_reset(sc);
+#endif
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    sc->io_thread.thread = SLCAN_THREAD_INVALID_HANDLE;
+    sc->io_thread.tx_event = SLCAN_EVENT_INVALID_HANDLE;
+    sc->io_thread.rx_event = SLCAN_EVENT_INVALID_HANDLE;
+    slcan_atomic_int_store(sc->io_thread.stop, 0);
+    slcan_atomic_int_store(sc->io_thread.wait, 0);
+    slcan_atomic_int_store(sc->io_thread.err, E_SLCAN_NO_ERROR);
+#endif
 
     return E_SLCAN_NO_ERROR;
 }
 
+slcan_err_t slcan_set_clock_source(slcan_t* sc, slcan_clock_source_t source)
+{
+    assert(sc != NULL);
+
+    return slcan_clock_init(&sc->clock, source);
+}
+
 void slcan_deinit(slcan_t* sc)
 {
     assert(sc != NULL);
@@ -274,18 +707,44 @@ void slcan_reset(slcan_t* sc)
     // reset buffers.
     slcan_cmd_buf_reset(&sc->txcmd);
     slcan_cmd_buf_reset(&sc->rxcmd);
+    sc->rx_skip = false;
 }
 
 slcan_err_t slcan_open(slcan_t* sc, const char* serial_port_name)
+{
+    return slcan_open_port(sc, serial_port_name, &slcan_port_default_ops, NULL);
+}
+
+slcan_err_t slcan_open_port(slcan_t* sc, const char* port_name, const slcan_port_ops_t* ops, void* ctx)
 {
     assert(sc != NULL);
 
+    if(ops == NULL) ops = &slcan_port_default_ops;
+
+    if(ops->open == NULL || ops->close == NULL ||
+       ops->read == NULL || ops->write == NULL ||
+       ops->poll == NULL) return E_SLCAN_NULL_POINTER;
+
     if(sc->serial_port != SLCAN_IO_INVALID_HANDLE){
         slcan_close(sc);
     }
 
-    int res = slcan_serial_open(serial_port_name, &sc->serial_port);
-    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+    sc->port_ops = ops;
+    sc->port_ctx = ctx;
+
+    int res = ops->open(ctx, port_name, &sc->serial_port);
+    if(res == SLCAN_IO_FAIL){
+        sc->serial_port = SLCAN_IO_INVALID_HANDLE;
+        return E_SLCAN_IO_ERROR;
+    }
+
+    sc->port_caps = ops->caps ? ops->caps(ctx, sc->serial_port) : SLCAN_PORT_CAP_NONE;
+
+    // blocking read requires the size of incoming data.
+    if(!(sc->port_caps & SLCAN_PORT_CAP_NONBLOCK_READ) && ops->nbytes == NULL){
+        slcan_close(sc);
+        return E_SLCAN_INVALID_VALUE;
+    }
 
     return E_SLCAN_NO_ERROR;
 }
@@ -294,9 +753,16 @@ void slcan_close(slcan_t* sc)
 {
     assert(sc != NULL);
 
-    slcan_serial_close(sc->serial_port);
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    slcan_stop_io_thread(sc);
+#endif
+
+    if(sc->serial_port != SLCAN_IO_INVALID_HANDLE){
+        sc->port_ops->close(sc->port_ctx, sc->serial_port);
+    }
 
     sc->serial_port = SLCAN_IO_INVALID_HANDLE;
+    sc->port_caps = SLCAN_PORT_CAP_NONE;
 }
 
 slcan_err_t slcan_configure(slcan_t* sc, slcan_port_conf_t* port_conf)
@@ -305,29 +771,29 @@ slcan_err_t slcan_configure(slcan_t* sc, slcan_port_conf_t* port_conf)
 
     if(port_conf == NULL) port_conf = &sc->port_conf;
 
-    int res = slcan_serial_configure(sc->serial_port, port_conf);
-    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+    if(sc->port_ops->configure){
+        int res = sc->port_ops->configure(sc->port_ctx, sc->serial_port, port_conf);
+        if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+    }
 
     sc->port_conf.parity = port_conf->parity;
     sc->port_conf.stop_bits = port_conf->stop_bits;
     sc->port_conf.baud = port_conf->baud;
+    sc->port_conf.baud_rate = port_conf->baud_rate;
+    sc->port_conf.flow_control = port_conf->flow_control;
+    sc->port_conf.low_latency = port_conf->low_latency;
+    sc->port_conf.vmin = port_conf->vmin;
+    sc->port_conf.vtime = port_conf->vtime;
 
     return E_SLCAN_NO_ERROR;
 }
 
-slcan_err_t slcan_poll(slcan_t* sc)
+static slcan_err_t slcan_process_events(slcan_t* sc, int revents)
 {
     assert(sc != NULL);
 
-    int res;
     slcan_err_t err;
 
-
-    // poll.
-    int revents = 0;
-    res = slcan_serial_poll(sc->serial_port, SLCAN_POLLIN | SLCAN_POLLOUT, &revents, 0);
-    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
-
     // incoming data.
     if(revents & SLCAN_POLLIN){
         err = slcan_process_incoming_data(sc);
@@ -337,81 +803,409 @@ slcan_err_t slcan_poll(slcan_t* sc)
     // outcoming data.
     if(revents & SLCAN_POLLOUT){
         err = slcan_process_outcoming_data(sc);
+        // port is not ready to write,
+        // the rest of data is sent later.
+        if(err != E_SLCAN_NO_ERROR && err != E_SLCAN_OVERFLOW) return err;
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+
+//! Поток ждёт данных для передачи.
+#define SLCAN_IO_THREAD_WAIT_TX 1
+//! Поток ждёт места в фифо приёма.
+#define SLCAN_IO_THREAD_WAIT_RX 2
+
+static bool slcan_io_thread_has_work(slcan_t* sc, int wait)
+{
+    // data to send.
+    if((wait & SLCAN_IO_THREAD_WAIT_TX) && !slcan_io_fifo_empty(&sc->txiofifo)) return true;
+    // space to receive.
+    if((wait & SLCAN_IO_THREAD_WAIT_RX) && !slcan_io_fifo_full(&sc->rxiofifo)) return true;
+
+    return false;
+}
+
+static void slcan_io_thread_kick(slcan_t* sc)
+{
+    // pairs with the fence in io thread before sleep.
+    slcan_atomic_fence();
+
+    int wait = slcan_atomic_int_load(sc->io_thread.wait);
+
+    if(wait == 0 || !slcan_io_thread_has_work(sc, wait)) return;
+
+    // wake the thread only once.
+    if(slcan_atomic_int_exchange(sc->io_thread.wait, 0) != 0){
+        slcan_event_signal(sc->io_thread.tx_event);
+    }
+}
+
+static void* slcan_io_thread_func(void* arg)
+{
+    slcan_t* sc = (slcan_t*)arg;
+
+    int res;
+    int events, revents, wait;
+    slcan_err_t err = E_SLCAN_NO_ERROR;
+
+    while(!slcan_atomic_int_load(sc->io_thread.stop)){
+        events = 0;
+        wait = 0;
+
+        // wait incoming data only if there is space for it.
+        if(!slcan_io_fifo_full(&sc->rxiofifo)){
+            events |= SLCAN_POLLIN;
+        }else{
+            wait |= SLCAN_IO_THREAD_WAIT_RX;
+        }
+        // wait outcoming data only if there is data to send.
+        if(!slcan_io_fifo_empty(&sc->txiofifo)){
+            events |= SLCAN_POLLOUT;
+        }else{
+            wait |= SLCAN_IO_THREAD_WAIT_TX;
+        }
+
+        // tell what to wake up on and recheck fifos,
+        // data may be put before the flags are visible.
+        slcan_atomic_int_store(sc->io_thread.wait, wait);
+        slcan_atomic_fence();
+
+        if(slcan_io_thread_has_work(sc, wait)){
+            slcan_atomic_int_store(sc->io_thread.wait, 0);
+            continue;
+        }
+
+        // poll.
+        revents = 0;
+        res = sc->port_ops->poll_event(sc->port_ctx, sc->serial_port, events, &revents, sc->io_thread.tx_event, NULL, -1);
+        SLCAN_IO_STATS_INC(sc, polls);
+
+        slcan_atomic_int_store(sc->io_thread.wait, 0);
+
+        if(res == SLCAN_IO_FAIL || (revents & SLCAN_POLLERR)){
+            err = E_SLCAN_IO_ERROR;
+            break;
+        }
+
+        err = slcan_process_events(sc, revents);
+        if(err != E_SLCAN_NO_ERROR) break;
+
+        // data received or sent.
+        if(revents & (SLCAN_POLLIN | SLCAN_POLLOUT)){
+            slcan_event_signal(sc->io_thread.rx_event);
+        }
+    }
+
+    if(err != E_SLCAN_NO_ERROR){
+        slcan_atomic_int_store(sc->io_thread.err, err);
+        // wake waiting application thread.
+        slcan_event_signal(sc->io_thread.rx_event);
+    }
+
+    return NULL;
+}
+
+slcan_err_t slcan_start_io_thread(slcan_t* sc)
+{
+    assert(sc != NULL);
+
+    if(!slcan_opened(sc)) return E_SLCAN_STATE;
+    if(slcan_io_thread_running(sc)) return E_SLCAN_STATE;
+    // transport cann't wait for the wake up event.
+    if(sc->port_ops->poll_event == NULL) return E_SLCAN_STATE;
+
+    int res;
+
+    res = slcan_event_open(&sc->io_thread.tx_event);
+    if(res == SLCAN_IO_FAIL){
+        sc->io_thread.tx_event = SLCAN_EVENT_INVALID_HANDLE;
+        return E_SLCAN_IO_ERROR;
+    }
+
+    res = slcan_event_open(&sc->io_thread.rx_event);
+    if(res == SLCAN_IO_FAIL){
+        slcan_event_close(sc->io_thread.tx_event);
+        sc->io_thread.tx_event = SLCAN_EVENT_INVALID_HANDLE;
+        sc->io_thread.rx_event = SLCAN_EVENT_INVALID_HANDLE;
+        return E_SLCAN_IO_ERROR;
+    }
+
+    slcan_atomic_int_store(sc->io_thread.stop, 0);
+    slcan_atomic_int_store(sc->io_thread.wait, 0);
+    slcan_atomic_int_store(sc->io_thread.err, E_SLCAN_NO_ERROR);
+
+    res = slcan_thread_create(&sc->io_thread.thread, slcan_io_thread_func, sc);
+    if(res == SLCAN_IO_FAIL){
+        slcan_event_close(sc->io_thread.tx_event);
+        slcan_event_close(sc->io_thread.rx_event);
+        sc->io_thread.thread = SLCAN_THREAD_INVALID_HANDLE;
+        sc->io_thread.tx_event = SLCAN_EVENT_INVALID_HANDLE;
+        sc->io_thread.rx_event = SLCAN_EVENT_INVALID_HANDLE;
+        return E_SLCAN_IO_ERROR;
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
+void slcan_stop_io_thread(slcan_t* sc)
+{
+    assert(sc != NULL);
+
+    if(!slcan_io_thread_running(sc)) return;
+
+    slcan_atomic_int_store(sc->io_thread.stop, 1);
+    slcan_event_signal(sc->io_thread.tx_event);
+
+    slcan_thread_join(sc->io_thread.thread);
+
+    slcan_event_close(sc->io_thread.tx_event);
+    slcan_event_close(sc->io_thread.rx_event);
+
+    sc->io_thread.thread = SLCAN_THREAD_INVALID_HANDLE;
+    sc->io_thread.tx_event = SLCAN_EVENT_INVALID_HANDLE;
+    sc->io_thread.rx_event = SLCAN_EVENT_INVALID_HANDLE;
+}
+
+static slcan_err_t slcan_io_thread_poll(slcan_t* sc)
+{
+    // wake the thread if there is new data or space.
+    slcan_io_thread_kick(sc);
+
+    return (slcan_err_t)slcan_atomic_int_load(sc->io_thread.err);
+}
+
+static slcan_err_t slcan_io_thread_wait(slcan_t* sc, const struct timespec* tp_timeout)
+{
+    slcan_err_t err;
+    int res;
+
+    err = slcan_io_thread_poll(sc);
+    if(err != E_SLCAN_NO_ERROR) return err;
+
+    // unprocessed received data.
+    if(!slcan_io_fifo_empty(&sc->rxiofifo)) return E_SLCAN_NO_ERROR;
+
+    res = slcan_event_wait(sc->io_thread.rx_event, slcan_timespec_to_poll_ms(tp_timeout));
+    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    return (slcan_err_t)slcan_atomic_int_load(sc->io_thread.err);
+}
+
+static slcan_err_t slcan_io_thread_wait_tx(slcan_t* sc, const struct timespec* tp_timeout)
+{
+    slcan_err_t err;
+    int res;
+
+    err = slcan_io_thread_poll(sc);
+    if(err != E_SLCAN_NO_ERROR) return err;
+
+    // all data is sent.
+    if(slcan_io_fifo_empty(&sc->txiofifo)) return E_SLCAN_NO_ERROR;
+
+    // unprocessed received data doesn't end the wait,
+    // the thread signals the event after sending data.
+    res = slcan_event_wait(sc->io_thread.rx_event, slcan_timespec_to_poll_ms(tp_timeout));
+    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    return (slcan_err_t)slcan_atomic_int_load(sc->io_thread.err);
+}
+
+#endif
+
+slcan_err_t slcan_process_io(slcan_t* sc, int* revents)
+{
+    assert(sc != NULL);
+
+    if(revents == NULL) return E_SLCAN_NULL_POINTER;
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    // port is owned by io thread.
+    if(slcan_io_thread_running(sc)) return E_SLCAN_STATE;
+#endif
+
+    slcan_err_t err;
+
+    // incoming data.
+    if(*revents & SLCAN_POLLIN){
+        err = slcan_process_incoming_data(sc);
         if(err != E_SLCAN_NO_ERROR) return err;
+
+        // all incoming data readed.
+        if(!slcan_io_fifo_full(&sc->rxiofifo)){
+            *revents &= ~SLCAN_POLLIN;
+        }
     }
 
+    // outcoming data.
+    if(*revents & SLCAN_POLLOUT){
+        err = slcan_process_outcoming_data(sc);
+        // port is not ready to write.
+        if(err == E_SLCAN_OVERFLOW){
+            *revents &= ~SLCAN_POLLOUT;
+        }else if(err != E_SLCAN_NO_ERROR){
+            return err;
+        }
+    }
 
     return E_SLCAN_NO_ERROR;
 }
 
+slcan_err_t slcan_poll(slcan_t* sc)
+{
+    assert(sc != NULL);
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    if(slcan_io_thread_running(sc)) return slcan_io_thread_poll(sc);
+#endif
+
+    int res;
+
+
+    // poll.
+    int revents = 0;
+    res = slcan_port_poll(sc, SLCAN_POLLIN | SLCAN_POLLOUT, &revents, 0);
+    SLCAN_IO_STATS_INC(sc, polls);
+    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    return slcan_process_events(sc, revents);
+}
+
+slcan_err_t slcan_wait(slcan_t* sc, const struct timespec* tp_timeout)
+{
+    assert(sc != NULL);
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    if(slcan_io_thread_running(sc)) return slcan_io_thread_wait(sc, tp_timeout);
+#endif
+
+    int res;
+    int events = 0;
+
+    // wait incoming data only if there is space for it.
+    if(!slcan_io_fifo_full(&sc->rxiofifo)){
+        events |= SLCAN_POLLIN;
+    }
+    // wait outcoming data only if there is data to send,
+    // the port is almost always ready to write.
+    if(!slcan_io_fifo_empty(&sc->txiofifo)){
+        events |= SLCAN_POLLOUT;
+    }
+
+    // unprocessed data in full rx fifo.
+    if(events == 0) return E_SLCAN_NO_ERROR;
+
+    // poll.
+    int revents = 0;
+    res = slcan_port_poll(sc, events, &revents, slcan_timespec_to_poll_ms(tp_timeout));
+    SLCAN_IO_STATS_INC(sc, polls);
+    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    return slcan_process_events(sc, revents);
+}
+
 slcan_err_t slcan_poll_out(slcan_t* sc)
 {
     assert(sc != NULL);
 
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    if(slcan_io_thread_running(sc)) return slcan_io_thread_poll(sc);
+#endif
+
     int res;
     slcan_err_t err;
 
 
     // poll.
     int revents = 0;
-    res = slcan_serial_poll(sc->serial_port, SLCAN_POLLOUT, &revents, 0);
+    res = slcan_port_poll(sc, SLCAN_POLLOUT, &revents, 0);
+    SLCAN_IO_STATS_INC(sc, polls);
     if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
 
     // outcoming data.
     if(revents & SLCAN_POLLOUT){
         err = slcan_process_outcoming_data(sc);
-        if(err != E_SLCAN_NO_ERROR) return err;
+        // port is not ready to write.
+        if(err != E_SLCAN_NO_ERROR && err != E_SLCAN_OVERFLOW) return err;
     }
 
 
     return E_SLCAN_NO_ERROR;
 }
 
+// Ждёт передачи данных.
+static slcan_err_t slcan_wait_tx(slcan_t* sc, const struct timespec* tp_timeout)
+{
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    if(slcan_io_thread_running(sc)) return slcan_io_thread_wait_tx(sc, tp_timeout);
+#endif
+
+    // wait for the port to accept data,
+    // incoming data is kept in rx fifo.
+    return slcan_wait(sc, tp_timeout);
+}
+
 slcan_err_t slcan_flush(slcan_t* sc, struct timespec* tp_timeout)
 {
     assert(sc != NULL);
 
     if(!slcan_opened(sc)) return E_SLCAN_STATE;
 
-    struct timespec tp_end, tp_cur;
+    struct timespec tp_end, tp_cur, tp_wait;
+    const struct timespec* p_tp_wait = NULL;
 
     if(tp_timeout){
         slcan_clock_gettime(&tp_cur);
         slcan_timespec_add(&tp_cur, tp_timeout, &tp_end);
+    }else{
+        tp_end.tv_sec = 0;
+        tp_end.tv_nsec = 0;
     }
 
-    int res;
     slcan_err_t err;
 
     while(!slcan_io_fifo_empty(&sc->txiofifo)){
+        if(tp_timeout){
+            slcan_clock_gettime(&tp_cur);
+            slcan_timespec_remain(&tp_end, &tp_cur, &tp_wait);
+            p_tp_wait = &tp_wait;
+        }
 
-        res = slcan_serial_flush(sc->serial_port);
-        if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
-
-        err = slcan_poll_out(sc);
+        err = slcan_wait_tx(sc, p_tp_wait);
         if(err != E_SLCAN_NO_ERROR) return err;
 
-        if(tp_timeout){
+        if(tp_timeout && !slcan_io_fifo_empty(&sc->txiofifo)){
             slcan_clock_gettime(&tp_cur);
 
-            if(slcan_timespec_cmp(&tp_cur, &tp_end, >)){
+            if(!slcan_timespec_cmp(&tp_cur, &tp_end, <)){
                 return E_SLCAN_TIMEOUT;
             }
         }
     }
 
-    res = slcan_serial_flush(sc->serial_port);
-    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
-
     return E_SLCAN_NO_ERROR;
 }
 
 slcan_err_t slcan_get_cmd(slcan_t* sc, slcan_cmd_t* cmd)
 {
-    return slcan_rx_io_fifo_get_cmd(sc, cmd);
+    size_t n;
+
+    return slcan_rx_io_fifo_get_cmds(sc, cmd, 1, &n);
+}
+
+slcan_err_t slcan_get_cmds(slcan_t* sc, slcan_cmd_t* cmds, size_t max, size_t* n)
+{
+    return slcan_rx_io_fifo_get_cmds(sc, cmds, max, n);
 }
 
 slcan_err_t slcan_put_cmd(slcan_t* sc, const slcan_cmd_t* cmd)
 {
     return slcan_tx_io_fifo_put_cmd(sc, cmd);
 }
+
+slcan_err_t slcan_put_can_msgs(slcan_t* sc, const slcan_can_msg_t* can_msgs, size_t count, size_t* n)
+{
+    return slcan_tx_io_fifo_put_can_msgs(sc, can_msgs, count, n);
+}
@@ -7,10 +7,20 @@
 #include "slcan_cmd.h"
 #include "slcan_err.h"
 #include "slcan_port.h"
+#include "slcan_port_ops.h"
+#include "slcan_atomic.h"
+#include "slcan_clock.h"
 #include "slcan_defs.h"
 #include "slcan_conf.h"
 
 
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+#if !defined(SLCAN_FIFO_SPSC) || SLCAN_FIFO_SPSC != 1
+#error SLCAN_IO_THREAD requires SLCAN_FIFO_SPSC!
+#endif
+#endif
+
+
 //! Инициализация SLCAN открывает последовательный порт.
 //#define SLCAN_INIT_OPENS_PORT 0
 
@@ -18,8 +28,14 @@
 //#define SLCAN_DEINIT_CLOSES_PORT 0
 
 
-//! Порог заполнения фифо отправляемыми сообщениями.
-#define SLCAN_TXIOFIFO_WATERMARK (SLCAN_IO_FIFO_SIZE / 4 * 3)
+//! Число команд, получаемых за один вызов при обработке.
+#ifndef SLCAN_CMDS_BATCH_SIZE
+#define SLCAN_CMDS_BATCH_SIZE SLCAN_CMDS_BATCH_DEFAULT_SIZE
+#endif
+
+
+//! Порог заполнения фифо отправляемыми сообщениями по-умолчанию.
+#define SLCAN_TXIOFIFO_WATERMARK(size) ((size) / 4 * 3)
 
 
 // End Of Message
@@ -38,14 +54,59 @@
 struct timespec;
 
 
+#if defined(SLCAN_IO_STATS) && SLCAN_IO_STATS == 1
+//! Структура счётчиков вызовов ввода-вывода.
+typedef struct _Slcan_Io_Stats {
+    unsigned long reads; //!< Число вызовов чтения.
+    unsigned long writes; //!< Число вызовов записи.
+    unsigned long nbytes; //!< Число запросов доступных байт.
+    unsigned long polls; //!< Число ожиданий событий.
+} slcan_io_stats_t;
+#endif
+
+
+//! Структура счётчиков отброшенных при приёме данных.
+typedef struct _Slcan_Rx_Stats {
+    unsigned long dropped_bytes; //!< Число отброшенных байт.
+    unsigned long dropped_frames; //!< Число отброшенных команд.
+} slcan_rx_stats_t;
+
+
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+//! Структура потока ввода-вывода.
+typedef struct _Slcan_Io_Thread {
+    slcan_thread_handle_t thread; //!< Поток.
+    slcan_event_handle_t tx_event; //!< Событие пробуждения потока.
+    slcan_event_handle_t rx_event; //!< Событие оповещения о вводе-выводе.
+    slcan_atomic_int_t stop; //!< Флаг остановки потока.
+    slcan_atomic_int_t wait; //!< Флаги ожидания потока.
+    slcan_atomic_int_t err; //!< Ошибка ввода-вывода.
+} slcan_io_thread_t;
+#endif
+
+
 //! Структура последовательного интерфейса для CAN.
 typedef struct _Slcan {
     slcan_port_conf_t port_conf; //!< Конфигурация порта.
+    const slcan_port_ops_t* port_ops; //!< Функции транспорта.
+    void* port_ctx; //!< Контекст транспорта.
     slcan_serial_handle_t serial_port; //!< Идентификатор открытого порта.
+    slcan_port_caps_t port_caps; //!< Возможности открытого порта.
     slcan_io_fifo_t txiofifo; //!< Фифо байт данных для передачи.
     slcan_io_fifo_t rxiofifo; //!< Фифо принятых байт данных.
+    size_t txiofifo_watermark; //!< Порог заполнения фифо отправляемыми сообщениями.
     slcan_cmd_buf_t txcmd; //!< Буфер для передаваемой команды.
     slcan_cmd_buf_t rxcmd; //!< Буфер для принимаемой команды.
+    bool rx_resync; //!< Флаг восстановления синхронизации приёма.
+    bool rx_skip; //!< Флаг пропуска данных до конца команды.
+    slcan_rx_stats_t rx_stats; //!< Счётчики отброшенных при приёме данных.
+    slcan_clock_t clock; //!< Часы и снимок времени цикла обработки.
+#if defined(SLCAN_IO_STATS) && SLCAN_IO_STATS == 1
+    slcan_io_stats_t io_stats; //!< Счётчики вызовов ввода-вывода.
+#endif
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+    slcan_io_thread_t io_thread; //!< Поток ввода-вывода.
+#endif
 } slcan_t;
 
 
@@ -70,6 +131,185 @@ EXTERN slcan_err_t slcan_get_port_config(slcan_t* sc, slcan_port_conf_t* conf);
  */
 EXTERN slcan_serial_handle_t slcan_serial_port(slcan_t* sc);
 
+/**
+ * Устанавливает буферы фифо ввода-вывода.
+ * Сбрасывает фифо и порог заполнения фифо передачи.
+ * @param sc Интерфейс.
+ * @param txbuf Буфер фифо передачи, NULL - встроенный буфер.
+ * @param txbuf_size Размер буфера фифо передачи, степень двойки.
+ * @param rxbuf Буфер фифо приёма, NULL - встроенный буфер.
+ * @param rxbuf_size Размер буфера фифо приёма, степень двойки.
+ * @return Код ошибки, E_SLCAN_INVALID_SIZE - если размер
+ * любого из буферов недопустим, фифо при этом не изменяются.
+ */
+EXTERN slcan_err_t slcan_set_io_buffers(slcan_t* sc, uint8_t* txbuf, size_t txbuf_size, uint8_t* rxbuf, size_t rxbuf_size);
+
+/**
+ * Получает порог заполнения фифо передачи,
+ * выше которого команды не помещаются в фифо.
+ * @param sc Интерфейс.
+ * @return Порог заполнения фифо передачи.
+ */
+ALWAYS_INLINE static size_t slcan_txiofifo_watermark(const slcan_t* sc)
+{
+    return sc->txiofifo_watermark;
+}
+
+/**
+ * Устанавливает порог заполнения фифо передачи.
+ * @param sc Интерфейс.
+ * @param watermark Порог заполнения, не более размера фифо.
+ */
+ALWAYS_INLINE static void slcan_set_txiofifo_watermark(slcan_t* sc, size_t watermark)
+{
+    size_t size = slcan_io_fifo_size(&sc->txiofifo);
+
+    sc->txiofifo_watermark = (watermark < size) ? watermark : size;
+}
+
+/**
+ * Получает используемые возможности порта.
+ * @param sc Интерфейс.
+ * @return Возможности порта.
+ */
+ALWAYS_INLINE static slcan_port_caps_t slcan_port_caps(const slcan_t* sc)
+{
+    return sc->port_caps;
+}
+
+/**
+ * Устанавливает используемые возможности порта.
+ * Позволяет отключить возможности, сообщённые портом при открытии.
+ * @param sc Интерфейс.
+ * @param caps Возможности порта.
+ */
+ALWAYS_INLINE static void slcan_set_port_caps(slcan_t* sc, slcan_port_caps_t caps)
+{
+    sc->port_caps = caps;
+}
+
+/**
+ * Получает флаг восстановления синхронизации приёма.
+ * @param sc Интерфейс.
+ * @return Флаг восстановления синхронизации приёма.
+ */
+ALWAYS_INLINE static bool slcan_rx_resync(const slcan_t* sc)
+{
+    return sc->rx_resync;
+}
+
+/**
+ * Устанавливает флаг восстановления синхронизации приёма.
+ * При восстановлении синхронизации неверные и переполняющие
+ * буфер команды пропускаются до ближайшего конца команды
+ * и учитываются в счётчиках, а приём продолжается.
+ * Без восстановления синхронизации неверная команда
+ * возвращает ошибку из slcan_get_cmds().
+ * По-умолчанию - SLCAN_RX_RESYNC_DEFAULT (выключено).
+ * @param sc Интерфейс.
+ * @param resync Флаг восстановления синхронизации приёма.
+ */
+ALWAYS_INLINE static void slcan_set_rx_resync(slcan_t* sc, bool resync)
+{
+    sc->rx_resync = resync;
+}
+
+/**
+ * Получает счётчики отброшенных при приёме данных.
+ * Переполняющие буфер команды учитываются
+ * и без восстановления синхронизации приёма.
+ * @param sc Интерфейс.
+ * @return Счётчики отброшенных при приёме данных.
+ */
+ALWAYS_INLINE static slcan_rx_stats_t* slcan_rx_stats(slcan_t* sc)
+{
+    return &sc->rx_stats;
+}
+
+/**
+ * Сбрасывает счётчики отброшенных при приёме данных.
+ * @param sc Интерфейс.
+ */
+ALWAYS_INLINE static void slcan_rx_stats_reset(slcan_t* sc)
+{
+    sc->rx_stats.dropped_bytes = 0;
+    sc->rx_stats.dropped_frames = 0;
+}
+
+/**
+ * Получает источник времени интерфейса.
+ * @param sc Интерфейс.
+ * @return Источник времени.
+ */
+ALWAYS_INLINE static slcan_clock_source_t slcan_clock_source(const slcan_t* sc)
+{
+    return sc->clock.source;
+}
+
+/**
+ * Устанавливает источник времени интерфейса.
+ * @param sc Интерфейс.
+ * @param source Источник времени.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_set_clock_source(slcan_t* sc, slcan_clock_source_t source);
+
+/**
+ * Делает снимок времени цикла обработки.
+ * Все события цикла до slcan_release_now()
+ * получают одно и то же время.
+ * @param sc Интерфейс.
+ * @return Время, нс.
+ */
+ALWAYS_INLINE static uint64_t slcan_update_now(slcan_t* sc)
+{
+    return slcan_clock_update(&sc->clock);
+}
+
+/**
+ * Завершает цикл обработки - освобождает снимок времени.
+ * @param sc Интерфейс.
+ */
+ALWAYS_INLINE static void slcan_release_now(slcan_t* sc)
+{
+    slcan_clock_release(&sc->clock);
+}
+
+/**
+ * Получает текущее время: снимок цикла обработки,
+ * вне цикла - время источника.
+ * @param sc Интерфейс.
+ * @return Время, нс.
+ */
+ALWAYS_INLINE static uint64_t slcan_now_ns(const slcan_t* sc)
+{
+    return slcan_clock_now(&sc->clock);
+}
+
+#if defined(SLCAN_IO_STATS) && SLCAN_IO_STATS == 1
+/**
+ * Получает счётчики вызовов ввода-вывода.
+ * @param sc Интерфейс.
+ * @return Счётчики вызовов ввода-вывода.
+ */
+ALWAYS_INLINE static slcan_io_stats_t* slcan_io_stats(slcan_t* sc)
+{
+    return &sc->io_stats;
+}
+
+/**
+ * Сбрасывает счётчики вызовов ввода-вывода.
+ * @param sc Интерфейс.
+ */
+ALWAYS_INLINE static void slcan_io_stats_reset(slcan_t* sc)
+{
+    sc->io_stats.reads = 0;
+    sc->io_stats.writes = 0;
+    sc->io_stats.nbytes = 0;
+    sc->io_stats.polls = 0;
+}
+#endif
+
 
 /**
  * Инициализирует последовательных интерфейс CAN.
@@ -99,11 +339,23 @@ EXTERN void slcan_reset(slcan_t* sc);
 /**
  * Открывает порт.
  * @param sc Интерфейс.
- * @param serial_port_name
+ * @param serial_port_name Имя последовательного порта.
  * @return Код ошибки.
  */
 EXTERN slcan_err_t slcan_open(slcan_t* sc, const char* serial_port_name);
 
+/**
+ * Открывает порт с заданным транспортом.
+ * Реактор и поток ввода-вывода требуют,
+ * чтобы идентификатор порта был файловым дескриптором.
+ * @param sc Интерфейс.
+ * @param port_name Имя порта.
+ * @param ops Функции транспорта, NULL - транспорт по-умолчанию.
+ * @param ctx Контекст транспорта.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_open_port(slcan_t* sc, const char* port_name, const slcan_port_ops_t* ops, void* ctx);
+
 /**
  * Закрывает порт.
  * @param sc Интерфейс.
@@ -118,6 +370,34 @@ EXTERN void slcan_close(slcan_t* sc);
  */
 EXTERN slcan_err_t slcan_configure(slcan_t* sc, slcan_port_conf_t* port_conf);
 
+#if defined(SLCAN_IO_THREAD) && SLCAN_IO_THREAD == 1
+/**
+ * Запускает поток ввода-вывода.
+ * Поток читает и передаёт данные порта через фифо,
+ * функции ожидания и обработки ввода-вывода интерфейса
+ * не выполняют системных вызовов порта.
+ * @param sc Интерфейс.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_start_io_thread(slcan_t* sc);
+
+/**
+ * Останавливает поток ввода-вывода.
+ * @param sc Интерфейс.
+ */
+EXTERN void slcan_stop_io_thread(slcan_t* sc);
+
+/**
+ * Получает флаг запущенного потока ввода-вывода.
+ * @param sc Интерфейс.
+ * @return Флаг запущенного потока ввода-вывода.
+ */
+ALWAYS_INLINE static bool slcan_io_thread_running(const slcan_t* sc)
+{
+    return sc->io_thread.thread != SLCAN_THREAD_INVALID_HANDLE;
+}
+#endif
+
 /**
  * Обрабатывает события ввода-вывода.
  * @param sc Интерфейс.
@@ -125,6 +405,30 @@ EXTERN slcan_err_t slcan_configure(slcan_t* sc, slcan_port_conf_t* port_conf);
  */
 EXTERN slcan_err_t slcan_poll(slcan_t* sc);
 
+/**
+ * Обрабатывает ввод-вывод для заданной готовности порта.
+ * Сбрасывает флаги готовности, если все данные
+ * прочитаны (SLCAN_POLLIN) или порт не готов
+ * передавать данные (SLCAN_POLLOUT).
+ * Используется при ожидании событий порта извне,
+ * недоступна при запущенном потоке ввода-вывода.
+ * @param sc Интерфейс.
+ * @param revents Готовность порта (SLCAN_POLLIN, SLCAN_POLLOUT).
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_process_io(slcan_t* sc, int* revents);
+
+/**
+ * Ждёт не более чем заданный тайм-аут событий ввода-вывода
+ * и обрабатывает их.
+ * Ожидание прерывается при поступлении данных
+ * или готовности порта к передаче имеющихся данных.
+ * @param sc Интерфейс.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_wait(slcan_t* sc, const struct timespec* tp_timeout);
+
 /**
  * Обрабатывает события вывода.
  * @param sc Интерфейс.
@@ -149,6 +453,22 @@ EXTERN slcan_err_t slcan_flush(slcan_t* sc, struct timespec* tp_timeout);
  */
 EXTERN slcan_err_t slcan_get_cmd(slcan_t* sc, slcan_cmd_t* cmd);
 
+/**
+ * Получает принятые команды.
+ * Разбирает за один вызов все полные команды
+ * в фифо приёма, но не более max.
+ * При ошибке разбора команды возвращается код ошибки,
+ * а полученные до неё команды остаются действительными.
+ * При восстановлении синхронизации приёма неверные команды
+ * отбрасываются без ошибки (см. slcan_set_rx_resync).
+ * @param sc Интерфейс.
+ * @param cmds Массив команд.
+ * @param max Размер массива команд.
+ * @param n Число полученных команд.
+ * @return Код ошибки, E_SLCAN_UNDERFLOW - если нет полных команд.
+ */
+EXTERN slcan_err_t slcan_get_cmds(slcan_t* sc, slcan_cmd_t* cmds, size_t max, size_t* n);
+
 /**
  * Отправляет команду.
  * @param sc Интерфейс.
@@ -157,4 +477,18 @@ EXTERN slcan_err_t slcan_get_cmd(slcan_t* sc, slcan_cmd_t* cmd);
  */
 EXTERN slcan_err_t slcan_put_cmd(slcan_t* sc, const slcan_cmd_t* cmd);
 
+/**
+ * Отправляет сообщения CAN.
+ * Записывает за один вызов подряд в фифо передачи
+ * сообщения, пока фифо не заполнится до порога.
+ * При неверном сообщении возвращается код ошибки,
+ * а отправленные до него сообщения остаются в фифо.
+ * @param sc Интерфейс.
+ * @param can_msgs Массив сообщений CAN.
+ * @param count Число сообщений CAN.
+ * @param n Число отправленных сообщений.
+ * @return Код ошибки, E_SLCAN_OVERFLOW - если ни одно сообщение не поместилось в фифо.
+ */
+EXTERN slcan_err_t slcan_put_can_msgs(slcan_t* sc, const slcan_can_msg_t* can_msgs, size_t count, size_t* n);
+
 #endif /* SLCAN_H_ */
@@ -0,0 +1,94 @@
+/**
+ * @file slcan_atomic.h
+ * Атомарные операции над индексами фифо.
+ */
+
+#ifndef SLCAN_ATOMIC_H_
+#define SLCAN_ATOMIC_H_
+
+#include <stddef.h>
+#include "slcan_defs.h"
+#include "slcan_conf.h"
+
+
+//! Размер линии кэша.
+#ifndef SLCAN_CACHE_LINE_SIZE
+#define SLCAN_CACHE_LINE_SIZE 64
+#endif
+
+
+#if defined(SLCAN_FIFO_SPSC) && SLCAN_FIFO_SPSC == 1
+
+#if !defined(__cplusplus) && !defined(__STDC_NO_ATOMICS__)
+
+#include <stdatomic.h>
+
+//! Тип атомарного индекса фифо.
+typedef _Atomic size_t slcan_fifo_index_t;
+
+//! Загружает индекс с семантикой acquire.
+#define slcan_fifo_index_load(index) atomic_load_explicit(&(index), memory_order_acquire)
+//! Загружает индекс, изменяемый только текущим потоком.
+#define slcan_fifo_index_load_relaxed(index) atomic_load_explicit(&(index), memory_order_relaxed)
+//! Сохраняет индекс с семантикой release.
+#define slcan_fifo_index_store(index, value) atomic_store_explicit(&(index), (value), memory_order_release)
+
+//! Тип атомарного целого.
+typedef _Atomic int slcan_atomic_int_t;
+
+//! Загружает атомарное целое.
+#define slcan_atomic_int_load(var) atomic_load(&(var))
+//! Сохраняет атомарное целое.
+#define slcan_atomic_int_store(var, value) atomic_store(&(var), (value))
+//! Обменивает значение атомарного целого, возвращает старое значение.
+#define slcan_atomic_int_exchange(var, value) atomic_exchange(&(var), (value))
+//! Полный барьер памяти.
+#define slcan_atomic_fence() atomic_thread_fence(memory_order_seq_cst)
+
+#else
+
+//! Тип атомарного индекса фифо.
+typedef size_t slcan_fifo_index_t;
+
+//! Загружает индекс с семантикой acquire.
+#define slcan_fifo_index_load(index) __atomic_load_n(&(index), __ATOMIC_ACQUIRE)
+//! Загружает индекс, изменяемый только текущим потоком.
+#define slcan_fifo_index_load_relaxed(index) __atomic_load_n(&(index), __ATOMIC_RELAXED)
+//! Сохраняет индекс с семантикой release.
+#define slcan_fifo_index_store(index, value) __atomic_store_n(&(index), (value), __ATOMIC_RELEASE)
+
+//! Тип атомарного целого.
+typedef int slcan_atomic_int_t;
+
+//! Загружает атомарное целое.
+#define slcan_atomic_int_load(var) __atomic_load_n(&(var), __ATOMIC_SEQ_CST)
+//! Сохраняет атомарное целое.
+#define slcan_atomic_int_store(var, value) __atomic_store_n(&(var), (value), __ATOMIC_SEQ_CST)
+//! Обменивает значение атомарного целого, возвращает старое значение.
+#define slcan_atomic_int_exchange(var, value) __atomic_exchange_n(&(var), (value), __ATOMIC_SEQ_CST)
+//! Полный барьер памяти.
+#define slcan_atomic_fence() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+
+#endif
+
+//! Выравнивание индекса фифо на отдельную линию кэша.
+#define SLCAN_FIFO_INDEX_ALIGN __attribute__((aligned(SLCAN_CACHE_LINE_SIZE)))
+
+#else
+
+//! Тип индекса фифо.
+typedef size_t slcan_fifo_index_t;
+
+//! Загружает индекс.
+#define slcan_fifo_index_load(index) (index)
+//! Загружает индекс, изменяемый только текущим потоком.
+#define slcan_fifo_index_load_relaxed(index) (index)
+//! Сохраняет индекс.
+#define slcan_fifo_index_store(index, value) ((index) = (value))
+
+//! Выравнивание индекса фифо.
+#define SLCAN_FIFO_INDEX_ALIGN
+
+#endif
+
+#endif /* SLCAN_ATOMIC_H_ */
@@ -9,26 +9,21 @@ void slcan_can_fifo_init(slcan_can_fifo_t* fifo)
     assert(fifo != NULL);
 
     memset(fifo->buf, 0x0, SLCAN_CAN_FIFO_SIZE * sizeof(slcan_can_fifo_data_t));
-    fifo->wptr = 0;
-    fifo->rptr = 0;
-    fifo->count = 0;
+    slcan_fifo_index_store(fifo->wptr, 0);
+    slcan_fifo_index_store(fifo->rptr, 0);
 }
 
 size_t slcan_can_fifo_put(slcan_can_fifo_t* fifo, const slcan_can_msg_t* msg, slcan_future_t* future)
 {
     assert(fifo != NULL);
 
-    if(fifo->count < SLCAN_CAN_FIFO_SIZE){
-        slcan_can_fifo_data_t* data = &fifo->buf[fifo->wptr];
+    slcan_can_fifo_data_t* data = slcan_can_fifo_data_to_write(fifo);
 
+    if(data){
         memcpy(&data->can_msg, msg, sizeof(slcan_can_msg_t));
         data->future = future;
 
-        fifo->count ++;
-        fifo->wptr ++;
-        if(fifo->wptr >= SLCAN_CAN_FIFO_SIZE){
-            fifo->wptr = 0;
-        }
+        slcan_can_fifo_data_written(fifo, 1);
         return 1;
     }
     return 0;
@@ -38,17 +33,13 @@ size_t slcan_can_fifo_get(slcan_can_fifo_t* fifo, slcan_can_msg_t* msg, slcan_fu
 {
     assert(fifo != NULL);
 
-    if(msg && fifo->count > 0){
-        slcan_can_fifo_data_t* data = &fifo->buf[fifo->rptr];
+    slcan_can_fifo_data_t* data = slcan_can_fifo_data_to_read(fifo);
 
+    if(msg && data){
         memcpy(msg, &data->can_msg, sizeof(slcan_can_msg_t));
         if(future) *future = data->future;
 
-        fifo->count --;
-        fifo->rptr ++;
-        if(fifo->rptr >= SLCAN_CAN_FIFO_SIZE){
-            fifo->rptr = 0;
-        }
+        slcan_can_fifo_data_readed(fifo, 1);
         return 1;
     }
     return 0;
@@ -58,8 +49,8 @@ size_t slcan_can_fifo_peek(const slcan_can_fifo_t* fifo, slcan_can_msg_t* msg, s
 {
     assert(fifo != NULL);
 
-    if(msg && fifo->count > 0){
-        const slcan_can_fifo_data_t* data = &fifo->buf[fifo->rptr];
+    if(msg && !slcan_can_fifo_empty(fifo)){
+        const slcan_can_fifo_data_t* data = &fifo->buf[slcan_fifo_index_load_relaxed(fifo->rptr) & (SLCAN_CAN_FIFO_SIZE - 1)];
 
         memcpy(msg, &data->can_msg, sizeof(slcan_can_msg_t));
         if(future) *future = data->future;
@@ -73,20 +64,14 @@ void slcan_can_fifo_data_readed(slcan_can_fifo_t* fifo, size_t data_size)
 {
     assert(fifo != NULL);
 
-    fifo->count -= data_size;
-    fifo->rptr += data_size;
-    if(fifo->rptr >= SLCAN_CAN_FIFO_SIZE){
-        fifo->rptr -= SLCAN_CAN_FIFO_SIZE;
-    }
+    // publish free space to the writer.
+    slcan_fifo_index_store(fifo->rptr, slcan_fifo_index_load_relaxed(fifo->rptr) + data_size);
 }
 
 void slcan_can_fifo_data_written(slcan_can_fifo_t* fifo, size_t data_size)
 {
     assert(fifo != NULL);
 
-    fifo->count += data_size;
-    fifo->wptr += data_size;
-    if(fifo->wptr >= SLCAN_CAN_FIFO_SIZE){
-        fifo->wptr -= SLCAN_CAN_FIFO_SIZE;
-    }
+    // publish written data to the reader.
+    slcan_fifo_index_store(fifo->wptr, slcan_fifo_index_load_relaxed(fifo->wptr) + data_size);
 }
@@ -6,6 +6,7 @@
 #include "slcan_defs.h"
 #include "slcan_can_msg.h"
 #include "slcan_future.h"
+#include "slcan_atomic.h"
 #include "slcan_conf.h"
 
 
@@ -14,6 +15,10 @@
 #define SLCAN_CAN_FIFO_SIZE SLCAN_CAN_FIFO_DEFAULT_SIZE
 #endif
 
+#if (SLCAN_CAN_FIFO_SIZE == 0) || ((SLCAN_CAN_FIFO_SIZE & (SLCAN_CAN_FIFO_SIZE - 1)) != 0)
+#error SLCAN_CAN_FIFO_SIZE must be a power of two!
+#endif
+
 
 //! Тип данных фифо.
 typedef struct _Slcan_Can_Fifo_Data {
@@ -23,11 +28,12 @@ typedef struct _Slcan_Can_Fifo_Data {
 
 
 //! Тип фифо.
+//! При SLCAN_FIFO_SPSC == 1 фифо может использоваться
+//! одним пишущим и одним читающим потоком одновременно.
 typedef struct _Slcan_Can_Fifo {
     slcan_can_fifo_data_t buf[SLCAN_CAN_FIFO_SIZE]; //!< Данные.
-    size_t wptr; //!< Индекс для записи.
-    size_t rptr; //!< Индекс для чтения.
-    size_t count; //!< Количество данных.
+    slcan_fifo_index_t wptr SLCAN_FIFO_INDEX_ALIGN; //!< Свободно растущий индекс для записи.
+    slcan_fifo_index_t rptr SLCAN_FIFO_INDEX_ALIGN; //!< Свободно растущий индекс для чтения.
 } slcan_can_fifo_t;
 
 
@@ -43,9 +49,8 @@ EXTERN void slcan_can_fifo_init(slcan_can_fifo_t* fifo);
  */
 ALWAYS_INLINE static void slcan_can_fifo_reset(slcan_can_fifo_t* fifo)
 {
-    fifo->wptr = 0;
-    fifo->rptr = 0;
-    fifo->count = 0;
+    slcan_fifo_index_store(fifo->wptr, 0);
+    slcan_fifo_index_store(fifo->rptr, 0);
 }
 
 /**
@@ -55,7 +60,7 @@ ALWAYS_INLINE static void slcan_can_fifo_reset(slcan_can_fifo_t* fifo)
  */
 ALWAYS_INLINE static size_t slcan_can_fifo_avail(const slcan_can_fifo_t* fifo)
 {
-    return fifo->count;
+    return slcan_fifo_index_load(fifo->wptr) - slcan_fifo_index_load(fifo->rptr);
 }
 
 /**
@@ -65,7 +70,7 @@ ALWAYS_INLINE static size_t slcan_can_fifo_avail(const slcan_can_fifo_t* fifo)
  */
 ALWAYS_INLINE static size_t slcan_can_fifo_remain(const slcan_can_fifo_t* fifo)
 {
-    return SLCAN_CAN_FIFO_SIZE - fifo->count;
+    return SLCAN_CAN_FIFO_SIZE - slcan_can_fifo_avail(fifo);
 }
 
 /**
@@ -75,7 +80,7 @@ ALWAYS_INLINE static size_t slcan_can_fifo_remain(const slcan_can_fifo_t* fifo)
  */
 ALWAYS_INLINE static bool slcan_can_fifo_full(const slcan_can_fifo_t* fifo)
 {
-    return fifo->count == SLCAN_CAN_FIFO_SIZE;
+    return slcan_can_fifo_avail(fifo) == SLCAN_CAN_FIFO_SIZE;
 }
 
 /**
@@ -85,7 +90,31 @@ ALWAYS_INLINE static bool slcan_can_fifo_full(const slcan_can_fifo_t* fifo)
  */
 ALWAYS_INLINE static bool slcan_can_fifo_empty(const slcan_can_fifo_t* fifo)
 {
-    return fifo->count == 0;
+    return slcan_can_fifo_avail(fifo) == 0;
+}
+
+/**
+ * Получает указатель на элемент для записи в фифо.
+ * Запись подтверждается вызовом slcan_can_fifo_data_written.
+ * @param fifo Фифо.
+ * @return Указатель на элемент, NULL - если фифо полное.
+ */
+ALWAYS_INLINE static slcan_can_fifo_data_t* slcan_can_fifo_data_to_write(slcan_can_fifo_t* fifo)
+{
+    if(slcan_can_fifo_full(fifo)) return NULL;
+    return &fifo->buf[slcan_fifo_index_load_relaxed(fifo->wptr) & (SLCAN_CAN_FIFO_SIZE - 1)];
+}
+
+/**
+ * Получает указатель на элемент для чтения из фифо.
+ * Чтение подтверждается вызовом slcan_can_fifo_data_readed.
+ * @param fifo Фифо.
+ * @return Указатель на элемент, NULL - если фифо пустое.
+ */
+ALWAYS_INLINE static slcan_can_fifo_data_t* slcan_can_fifo_data_to_read(slcan_can_fifo_t* fifo)
+{
+    if(slcan_can_fifo_empty(fifo)) return NULL;
+    return &fifo->buf[slcan_fifo_index_load_relaxed(fifo->rptr) & (SLCAN_CAN_FIFO_SIZE - 1)];
 }
 
 /**
@@ -1,7 +1,7 @@
 #include "slcan_can_msg.h"
 #include "slcan_cmd.h"
 #include "slcan_utils.h"
-#include <ctype.h>
+#include "slcan_hex.h"
 #include <assert.h>
 
 
@@ -37,61 +37,44 @@ bool slcan_can_msg_is_valid(const slcan_can_msg_t* msg)
 
 
 
-static slcan_err_t slcan_can_msg_from_buf_t(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_can_msg_from_data_t(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const uint8_t* buf_data, size_t buf_data_size)
 {
     assert(can_msg != NULL);
-    assert(buf != NULL);
+    assert(buf_data != NULL);
 
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size < 1 + 3 + 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
-    size_t i;
+    uint32_t id;
+    uint32_t value;
 
-    // check id.
-    for(i = 0; i < 3; i ++){
-        if(!isxdigit(cmd_data[i])) return E_SLCAN_INVALID_DATA;
-    }
-
-    uint32_t id = 0;
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+    // id.
+    if(slcan_hex_decode(cmd_data, 3, &id) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 3;
 
     if(id > 0x7ff) return E_SLCAN_INVALID_DATA;
 
-    // check data size.
-    //for(i = 0; i < 3 + 1; i ++){
-        if(!isxdigit(cmd_data[0])) return E_SLCAN_INVALID_DATA;
-    //}
+    // data size.
+    if(slcan_hex_decode(cmd_data, 1, &value) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 1;
 
-    size_t data_size;
-    data_size = digit_hex_to_num(*cmd_data ++);
+    size_t data_size = value;
 
     if(data_size > 8) return E_SLCAN_INVALID_DATA;
 
     size_t msg_size = (1 + 3 + 1 + data_size + data_size + 1 /* EOM */);
     if(buf_data_size < msg_size) return E_SLCAN_INVALID_SIZE;
 
-    // check data.
-    for(i = 0; i < data_size + data_size; i ++){
-        if(!isxdigit(cmd_data[i])) return E_SLCAN_INVALID_DATA;
-    }
+    // data.
+    if(slcan_hex_decode_bytes(cmd_data, can_msg->data, data_size) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += data_size + data_size;
 
     can_msg->frame_type = SLCAN_CAN_FRAME_NORMAL;
     can_msg->id_type = SLCAN_CAN_ID_NORMAL;
     can_msg->id = id;
     can_msg->dlc = data_size;
 
-    uint8_t byte;
-    for(i = 0; i < data_size; i ++){
-        byte  = (digit_hex_to_num(*cmd_data ++) & 0x0f) << 4;
-        byte |= (digit_hex_to_num(*cmd_data ++) & 0x0f) << 0;
-        can_msg->data[i] = byte;
-    }
-
     // timestamp.
     bool ts_valid = false;
     uint16_t ts_value = 0;
@@ -100,17 +83,13 @@ static slcan_err_t slcan_can_msg_from_buf_t(slcan_can_msg_t* can_msg, slcan_can_
     if(buf_data_size >= (msg_size + 4)){
         // add timestamp size.
         msg_size += 4;
-        // check timestamp.
-        for(i = 0; i < 4; i ++){
-            if(!isxdigit(cmd_data[i])) { return E_SLCAN_INVALID_DATA; }
-        }
+        // check and decode timestamp.
+        if(slcan_hex_decode(cmd_data, 4, &value) != 0) return E_SLCAN_INVALID_DATA;
+        cmd_data += 4;
         // ts is valid.
         ts_valid = true;
         // ts value.
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 12);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+        ts_value = (uint16_t)value;
     }
 
     bool autopoll = false;
@@ -133,66 +112,44 @@ static slcan_err_t slcan_can_msg_from_buf_t(slcan_can_msg_t* can_msg, slcan_can_
     return E_SLCAN_NO_ERROR;
 }
 
-static slcan_err_t slcan_can_msg_from_buf_T(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_can_msg_from_data_T(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const uint8_t* buf_data, size_t buf_data_size)
 {
     assert(can_msg != NULL);
-    assert(buf != NULL);
+    assert(buf_data != NULL);
 
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size < 1 + 8 + 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
-    size_t i;
-
-    // check id.
-    for(i = 0; i < 3; i ++){
-        if(!isxdigit(cmd_data[i])) return E_SLCAN_INVALID_DATA;
-    }
+    uint32_t id;
+    uint32_t value;
 
-    uint32_t id = 0;
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 28);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 24);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 20);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 16);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 12);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+    // id.
+    if(slcan_hex_decode(cmd_data, 8, &id) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 8;
 
     if(id > 0x1fffffff) return E_SLCAN_INVALID_DATA;
 
-    // check data size.
-    //for(i = 0; i < 3 + 1; i ++){
-        if(!isxdigit(cmd_data[0])) return E_SLCAN_INVALID_DATA;
-    //}
+    // data size.
+    if(slcan_hex_decode(cmd_data, 1, &value) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 1;
 
-    size_t data_size;
-    data_size = digit_hex_to_num(*cmd_data ++);
+    size_t data_size = value;
 
     if(data_size > 8) return E_SLCAN_INVALID_DATA;
 
     size_t msg_size = (1 + 8 + 1 + data_size + data_size + 1 /* EOM */);
     if(buf_data_size < msg_size) return E_SLCAN_INVALID_SIZE;
 
-    // check data.
-    for(i = 0; i < data_size + data_size; i ++){
-        if(!isxdigit(cmd_data[i])) return E_SLCAN_INVALID_DATA;
-    }
+    // data.
+    if(slcan_hex_decode_bytes(cmd_data, can_msg->data, data_size) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += data_size + data_size;
 
     can_msg->frame_type = SLCAN_CAN_FRAME_NORMAL;
     can_msg->id_type = SLCAN_CAN_ID_EXTENDED;
     can_msg->id = id;
     can_msg->dlc = data_size;
 
-    uint8_t byte;
-    for(i = 0; i < data_size; i ++){
-        byte  = (digit_hex_to_num(*cmd_data ++) & 0x0f) << 4;
-        byte |= (digit_hex_to_num(*cmd_data ++) & 0x0f) << 0;
-        can_msg->data[i] = byte;
-    }
-
     // timestamp.
     bool ts_valid = false;
     uint16_t ts_value = 0;
@@ -201,17 +158,13 @@ static slcan_err_t slcan_can_msg_from_buf_T(slcan_can_msg_t* can_msg, slcan_can_
     if(buf_data_size >= (msg_size + 4)){
         // add timestamp size.
         msg_size += 4;
-        // check timestamp.
-        for(i = 0; i < 4; i ++){
-            if(!isxdigit(cmd_data[i])) { return E_SLCAN_INVALID_DATA; }
-        }
+        // check and decode timestamp.
+        if(slcan_hex_decode(cmd_data, 4, &value) != 0) return E_SLCAN_INVALID_DATA;
+        cmd_data += 4;
         // ts is valid.
         ts_valid = true;
         // ts value.
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 12);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+        ts_value = (uint16_t)value;
     }
 
     bool autopoll = false;
@@ -234,38 +187,29 @@ static slcan_err_t slcan_can_msg_from_buf_T(slcan_can_msg_t* can_msg, slcan_can_
     return E_SLCAN_NO_ERROR;
 }
 
-static slcan_err_t slcan_can_msg_from_buf_r(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_can_msg_from_data_r(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const uint8_t* buf_data, size_t buf_data_size)
 {
     assert(can_msg != NULL);
-    assert(buf != NULL);
+    assert(buf_data != NULL);
 
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size < 1 + 3 + 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
-    int i;
-
-    // check id.
-    for(i = 0; i < 3; i ++){
-        if(!isxdigit(cmd_data[i])) return E_SLCAN_INVALID_DATA;
-    }
+    uint32_t id;
+    uint32_t value;
 
-    uint32_t id = 0;
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+    // id.
+    if(slcan_hex_decode(cmd_data, 3, &id) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 3;
 
     if(id > 0x7ff) return E_SLCAN_INVALID_DATA;
 
-    // check data size.
-    //for(i = 0; i < 3 + 1; i ++){
-        if(!isxdigit(cmd_data[0])) return E_SLCAN_INVALID_DATA;
-    //}
+    // data size.
+    if(slcan_hex_decode(cmd_data, 1, &value) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 1;
 
-    size_t data_size;
-    data_size = digit_hex_to_num(*cmd_data ++);
+    size_t data_size = value;
 
     if(data_size > 8) return E_SLCAN_INVALID_DATA;
 
@@ -285,17 +229,13 @@ static slcan_err_t slcan_can_msg_from_buf_r(slcan_can_msg_t* can_msg, slcan_can_
     if(buf_data_size >= (msg_size + 4)){
         // add timestamp size.
         msg_size += 4;
-        // check timestamp.
-        for(i = 0; i < 4; i ++){
-            if(!isxdigit(cmd_data[i])) { return E_SLCAN_INVALID_DATA; }
-        }
+        // check and decode timestamp.
+        if(slcan_hex_decode(cmd_data, 4, &value) != 0) return E_SLCAN_INVALID_DATA;
+        cmd_data += 4;
         // ts is valid.
         ts_valid = true;
         // ts value.
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 12);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+        ts_value = (uint16_t)value;
     }
 
     bool autopoll = false;
@@ -318,43 +258,29 @@ static slcan_err_t slcan_can_msg_from_buf_r(slcan_can_msg_t* can_msg, slcan_can_
     return E_SLCAN_NO_ERROR;
 }
 
-static slcan_err_t slcan_can_msg_from_buf_R(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_can_msg_from_data_R(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const uint8_t* buf_data, size_t buf_data_size)
 {
     assert(can_msg != NULL);
-    assert(buf != NULL);
+    assert(buf_data != NULL);
 
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size < 1 + 8 + 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
-    int i;
+    uint32_t id;
+    uint32_t value;
 
-    // check id.
-    for(i = 0; i < 3; i ++){
-        if(!isxdigit(cmd_data[i])) return E_SLCAN_INVALID_DATA;
-    }
-
-    uint32_t id = 0;
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 28);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 24);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 20);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 16);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 12);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-    id |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+    // id.
+    if(slcan_hex_decode(cmd_data, 8, &id) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 8;
 
     if(id > 0x1fffffff) return E_SLCAN_INVALID_DATA;
 
-    // check data size.
-    //for(i = 0; i < 3 + 1; i ++){
-        if(!isxdigit(cmd_data[0])) return E_SLCAN_INVALID_DATA;
-    //}
+    // data size.
+    if(slcan_hex_decode(cmd_data, 1, &value) != 0) return E_SLCAN_INVALID_DATA;
+    cmd_data += 1;
 
-    size_t data_size;
-    data_size = digit_hex_to_num(*cmd_data ++);
+    size_t data_size = value;
 
     if(data_size > 8) return E_SLCAN_INVALID_DATA;
 
@@ -374,17 +300,13 @@ static slcan_err_t slcan_can_msg_from_buf_R(slcan_can_msg_t* can_msg, slcan_can_
     if(buf_data_size >= (msg_size + 4)){
         // add timestamp size.
         msg_size += 4;
-        // check timestamp.
-        for(i = 0; i < 4; i ++){
-            if(!isxdigit(cmd_data[i])) { return E_SLCAN_INVALID_DATA; }
-        }
+        // check and decode timestamp.
+        if(slcan_hex_decode(cmd_data, 4, &value) != 0) return E_SLCAN_INVALID_DATA;
+        cmd_data += 4;
         // ts is valid.
         ts_valid = true;
         // ts value.
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 12);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 8);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 4);
-        ts_value |= ((digit_hex_to_num(*cmd_data ++) & 0x0f) << 0);
+        ts_value = (uint16_t)value;
     }
 
     bool autopoll = false;
@@ -407,215 +329,118 @@ static slcan_err_t slcan_can_msg_from_buf_R(slcan_can_msg_t* can_msg, slcan_can_
     return E_SLCAN_NO_ERROR;
 }
 
-slcan_err_t slcan_can_msg_from_buf(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const slcan_cmd_buf_t* buf)
+slcan_err_t slcan_can_msg_from_data(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const uint8_t* buf_data, size_t buf_data_size)
 {
-    if(can_msg == NULL || buf == NULL) return E_SLCAN_NULL_POINTER;
-    if(slcan_cmd_buf_size(buf) == 0) return E_SLCAN_INVALID_VALUE;
+    if(can_msg == NULL || buf_data == NULL) return E_SLCAN_NULL_POINTER;
+    if(buf_data_size == 0) return E_SLCAN_INVALID_VALUE;
 
-    uint8_t buf_type = buf->buf[0];
+    uint8_t buf_type = buf_data[0];
 
     switch(buf_type){
         default:
             break;
         case 't':
-            return slcan_can_msg_from_buf_t(can_msg, ed, buf);
+            return slcan_can_msg_from_data_t(can_msg, ed, buf_data, buf_data_size);
         case 'T':
-            return slcan_can_msg_from_buf_T(can_msg, ed, buf);
+            return slcan_can_msg_from_data_T(can_msg, ed, buf_data, buf_data_size);
         case 'r':
-            return slcan_can_msg_from_buf_r(can_msg, ed, buf);
+            return slcan_can_msg_from_data_r(can_msg, ed, buf_data, buf_data_size);
         case 'R':
-            return slcan_can_msg_from_buf_R(can_msg, ed, buf);
+            return slcan_can_msg_from_data_R(can_msg, ed, buf_data, buf_data_size);
     }
 
     return E_SLCAN_INVALID_VALUE;
 }
 
-
-static slcan_err_t slcan_can_msg_to_buf_t(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed, slcan_cmd_buf_t* buf)
+slcan_err_t slcan_can_msg_from_buf(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const slcan_cmd_buf_t* buf)
 {
-    assert(can_msg != NULL);
-    assert(buf != NULL);
-
-    slcan_cmd_buf_reset(buf);
+    if(buf == NULL) return E_SLCAN_NULL_POINTER;
 
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_TRANSMIT) == 0) return E_SLCAN_OVERFLOW;
-
-    // id.
-    uint32_t id = can_msg->id;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-
-    // data_size.
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex(can_msg->dlc)) == 0) return E_SLCAN_OVERFLOW;
-
-    int i;
-    // data.
-    for(i = 0; i < can_msg->dlc; i ++){
-        if(slcan_cmd_buf_put(buf, digit_num_to_hex((can_msg->data[i] >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-        if(slcan_cmd_buf_put(buf, digit_num_to_hex((can_msg->data[i] >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    }
-
-    if(ed){
-        if(ed->has_timestamp){
-            uint16_t ts_value = ed->timestamp;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 12) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-        }
-        if(ed->autopoll_flag){
-            if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK_AUTOPOLL) == 0) return E_SLCAN_OVERFLOW;
-        }
-    }
-
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK) == 0) return E_SLCAN_OVERFLOW;
-
-    return E_SLCAN_NO_ERROR;
+    return slcan_can_msg_from_data(can_msg, ed, slcan_cmd_buf_data_const(buf), slcan_cmd_buf_size(buf));
 }
 
-static slcan_err_t slcan_can_msg_to_buf_T(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed, slcan_cmd_buf_t* buf)
+
+size_t slcan_can_msg_encoded_size(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed)
 {
     assert(can_msg != NULL);
-    assert(buf != NULL);
-
-    slcan_cmd_buf_reset(buf);
-
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_TRANSMIT_EXT) == 0) return E_SLCAN_OVERFLOW;
 
-    // id.
-    uint32_t id = can_msg->id;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 28) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 24) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 20) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 16) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 12) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
+    if(can_msg->dlc > SLCAN_CAN_DATA_SIZE_MAX) return 0;
 
-    // data_size.
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex(can_msg->dlc)) == 0) return E_SLCAN_OVERFLOW;
+    // type, id, data size, EOM.
+    size_t size = 1 + ((can_msg->id_type == SLCAN_CAN_ID_NORMAL) ? 3 : 8) + 1 + 1 /* EOM */;
 
-    int i;
     // data.
-    for(i = 0; i < can_msg->dlc; i ++){
-        if(slcan_cmd_buf_put(buf, digit_num_to_hex((can_msg->data[i] >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-        if(slcan_cmd_buf_put(buf, digit_num_to_hex((can_msg->data[i] >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
+    if(can_msg->frame_type == SLCAN_CAN_FRAME_NORMAL){
+        size += can_msg->dlc + can_msg->dlc;
     }
 
     if(ed){
-        if(ed->has_timestamp){
-            uint16_t ts_value = ed->timestamp;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 12) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-        }
-        if(ed->autopoll_flag){
-            if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK_AUTOPOLL_EXT) == 0) return E_SLCAN_OVERFLOW;
-        }
+        if(ed->has_timestamp) size += 4;
+        if(ed->autopoll_flag) size += 1;
     }
 
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK) == 0) return E_SLCAN_OVERFLOW;
-
-    return E_SLCAN_NO_ERROR;
+    return size;
 }
 
-static slcan_err_t slcan_can_msg_to_buf_r(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed, slcan_cmd_buf_t* buf)
+size_t slcan_can_msg_encode(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed, uint8_t* data)
 {
     assert(can_msg != NULL);
-    assert(buf != NULL);
+    assert(data != NULL);
+    assert(can_msg->dlc <= SLCAN_CAN_DATA_SIZE_MAX);
 
-    slcan_cmd_buf_reset(buf);
+    uint8_t* cmd_data = data;
+    bool normal_id = can_msg->id_type == SLCAN_CAN_ID_NORMAL;
 
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_TRANSMIT_RTR) == 0) return E_SLCAN_OVERFLOW;
+    // type.
+    if(can_msg->frame_type == SLCAN_CAN_FRAME_NORMAL){
+        *cmd_data ++ = normal_id ? SLCAN_CMD_TRANSMIT : SLCAN_CMD_TRANSMIT_EXT;
+    }else{ // SLCAN_MSG_FRAME_TYPE_RTR
+        *cmd_data ++ = normal_id ? SLCAN_CMD_TRANSMIT_RTR : SLCAN_CMD_TRANSMIT_RTR_EXT;
+    }
 
     // id.
-    uint32_t id = can_msg->id;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
+    if(normal_id){
+        slcan_hex_encode(cmd_data, can_msg->id, 3);
+        cmd_data += 3;
+    }else{ //SLCAN_MSG_ID_EXTENDED
+        slcan_hex_encode(cmd_data, can_msg->id, 8);
+        cmd_data += 8;
+    }
 
     // data_size.
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex(can_msg->dlc)) == 0) return E_SLCAN_OVERFLOW;
+    slcan_hex_encode(cmd_data, can_msg->dlc, 1);
+    cmd_data += 1;
 
-    if(ed){
-        if(ed->has_timestamp){
-            uint16_t ts_value = ed->timestamp;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 12) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-        }
-        if(ed->autopoll_flag){
-            if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK_AUTOPOLL) == 0) return E_SLCAN_OVERFLOW;
-        }
+    // data.
+    if(can_msg->frame_type == SLCAN_CAN_FRAME_NORMAL){
+        slcan_hex_encode_bytes(cmd_data, can_msg->data, can_msg->dlc);
+        cmd_data += can_msg->dlc + can_msg->dlc;
     }
 
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK) == 0) return E_SLCAN_OVERFLOW;
-
-    return E_SLCAN_NO_ERROR;
-}
-
-static slcan_err_t slcan_can_msg_to_buf_R(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed, slcan_cmd_buf_t* buf)
-{
-    assert(can_msg != NULL);
-    assert(buf != NULL);
-
-    slcan_cmd_buf_reset(buf);
-
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_TRANSMIT_RTR_EXT) == 0) return E_SLCAN_OVERFLOW;
-
-    // id.
-    uint32_t id = can_msg->id;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 28) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 24) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 20) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 16) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 12) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex((id >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-
-    // data_size.
-    if(slcan_cmd_buf_put(buf, digit_num_to_hex(can_msg->dlc)) == 0) return E_SLCAN_OVERFLOW;
-
     if(ed){
         if(ed->has_timestamp){
-            uint16_t ts_value = ed->timestamp;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 12) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 8) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 4) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
-            if(slcan_cmd_buf_put(buf, digit_num_to_hex((ts_value >> 0) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
+            slcan_hex_encode(cmd_data, ed->timestamp, 4);
+            cmd_data += 4;
         }
         if(ed->autopoll_flag){
-            if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK_AUTOPOLL_EXT) == 0) return E_SLCAN_OVERFLOW;
+            *cmd_data ++ = normal_id ? SLCAN_CMD_OK_AUTOPOLL : SLCAN_CMD_OK_AUTOPOLL_EXT;
         }
     }
 
-    if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK) == 0) return E_SLCAN_OVERFLOW;
+    *cmd_data ++ = SLCAN_CMD_OK;
 
-    return E_SLCAN_NO_ERROR;
+    return (size_t)(cmd_data - data);
 }
 
 slcan_err_t slcan_can_msg_to_buf(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed, slcan_cmd_buf_t* cmd)
 {
     if(can_msg == NULL || cmd == NULL) return E_SLCAN_NULL_POINTER;
 
-    if(can_msg->frame_type == SLCAN_CAN_FRAME_NORMAL){
-        if(can_msg->id_type == SLCAN_CAN_ID_NORMAL){
-            return slcan_can_msg_to_buf_t(can_msg, ed, cmd);
-        }else{ //SLCAN_MSG_ID_EXTENDED
-            return slcan_can_msg_to_buf_T(can_msg, ed, cmd);
-        }
-    }else{ // SLCAN_MSG_FRAME_TYPE_RTR
-        if(can_msg->id_type == SLCAN_CAN_ID_NORMAL){
-            return slcan_can_msg_to_buf_r(can_msg, ed, cmd);
-        }else{ //SLCAN_MSG_ID_EXTENDED
-            return slcan_can_msg_to_buf_R(can_msg, ed, cmd);
-        }
-    }
+    size_t size = slcan_can_msg_encoded_size(can_msg, ed);
+    if(size == 0) return E_SLCAN_INVALID_VALUE;
+    if(size > SLCAN_CMD_BUF_SIZE) return E_SLCAN_OVERFLOW;
 
-    return E_SLCAN_INVALID_VALUE;
+    slcan_cmd_buf_set_size(cmd, slcan_can_msg_encode(can_msg, ed, slcan_cmd_buf_data(cmd)));
+
+    return E_SLCAN_NO_ERROR;
 }
@@ -52,6 +52,16 @@ typedef struct _Slcan_Can_Msg_Extdata {
  */
 EXTERN bool slcan_can_msg_is_valid(const slcan_can_msg_t* msg);
 
+/**
+ * Десериализация сообщения CAN из данных.
+ * @param can_msg Сообщение CAN.
+ * @param ed Расширенные данные о сообщении.
+ * @param data Данные сообщения, включая EOM.
+ * @param data_size Размер данных.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_can_msg_from_data(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const uint8_t* data, size_t data_size);
+
 /**
  * Десериализация сообщения CAN из буфера.
  * @param can_msg Сообщение CAN.
@@ -61,6 +71,24 @@ EXTERN bool slcan_can_msg_is_valid(const slcan_can_msg_t* msg);
  */
 EXTERN slcan_err_t slcan_can_msg_from_buf(slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* ed, const slcan_cmd_buf_t* cmd_buf);
 
+/**
+ * Получает размер записи сообщения CAN.
+ * @param can_msg Сообщение CAN.
+ * @param ed Расширенные данные о сообщении.
+ * @return Размер записи, включая EOM, 0 - при неверном размере данных.
+ */
+EXTERN size_t slcan_can_msg_encoded_size(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed);
+
+/**
+ * Записывает сообщение CAN за один проход без проверок.
+ * Размер буфера должен быть не меньше slcan_can_msg_encoded_size().
+ * @param can_msg Сообщение CAN.
+ * @param ed Расширенные данные о сообщении.
+ * @param data Буфер.
+ * @return Размер записи.
+ */
+EXTERN size_t slcan_can_msg_encode(const slcan_can_msg_t* can_msg, const slcan_can_msg_extdata_t* ed, uint8_t* data);
+
 /**
  * Сериализация сообщения CAN в буфер.
  * @param can_msg Сообщение CAN.
@@ -0,0 +1,159 @@
+#include "slcan_clock.h"
+#include "slcan_port.h"
+#include "slcan_utils.h"
+#include <assert.h>
+#if SLCAN_CLOCK_X86_TSC == 1
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+
+
+
+// Читает время функцией порта.
+ALWAYS_INLINE static uint64_t slcan_clock_read_port_ns(int (*gettime)(struct timespec*))
+{
+    struct timespec tp;
+
+    if(gettime(&tp) != 0) return 0;
+
+    return slcan_timespec_to_ns(&tp);
+}
+
+
+#if SLCAN_CLOCK_X86_TSC == 1
+
+//! Длительность калибровки счётчика тактов, нс.
+#define SLCAN_CLOCK_TSC_CALIBRATION_NS 10000000ULL
+
+// Состояния калибровки счётчика тактов.
+#define SLCAN_CLOCK_TSC_NONE 0
+#define SLCAN_CLOCK_TSC_BUSY 1
+#define SLCAN_CLOCK_TSC_READY 2
+#define SLCAN_CLOCK_TSC_UNSUPPORTED 3
+
+// Калибровка счётчика тактов.
+static struct {
+    uint64_t tsc_base; // такты в начале калибровки.
+    uint64_t ns_base; // время в начале калибровки, нс.
+    uint64_t mult; // нс на такт, 32.32.
+    int state; // состояние калибровки.
+} slcan_clock_tsc;
+
+// Проверяет наличие инвариантного счётчика тактов.
+static bool slcan_clock_tsc_invariant(void)
+{
+    unsigned int eax, ebx, ecx, edx;
+
+    if(!__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx)) return false;
+    if(eax < 0x80000007) return false;
+    if(!__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx)) return false;
+
+    // invariant TSC.
+    return (edx & (1U << 8)) != 0;
+}
+
+// Калибрует счётчик тактов по монотонному времени порта.
+static int slcan_clock_tsc_calibrate(void)
+{
+    uint64_t tsc_start, tsc_end, ns_start, ns_end;
+
+    if(!slcan_clock_tsc_invariant()) return SLCAN_CLOCK_TSC_UNSUPPORTED;
+
+    ns_start = slcan_clock_read_port_ns(slcan_clock_gettime);
+    tsc_start = __rdtsc();
+
+    do{
+        ns_end = slcan_clock_read_port_ns(slcan_clock_gettime);
+        tsc_end = __rdtsc();
+    }while(ns_end - ns_start < SLCAN_CLOCK_TSC_CALIBRATION_NS);
+
+    if(tsc_end <= tsc_start) return SLCAN_CLOCK_TSC_UNSUPPORTED;
+
+    slcan_clock_tsc.tsc_base = tsc_start;
+    slcan_clock_tsc.ns_base = ns_start;
+    slcan_clock_tsc.mult = (uint64_t)(((unsigned __int128)(ns_end - ns_start) << 32) / (tsc_end - tsc_start));
+
+    return SLCAN_CLOCK_TSC_READY;
+}
+
+// Получает состояние калибровки, калибрует при первом вызове.
+static int slcan_clock_tsc_state(void)
+{
+    int state = __atomic_load_n(&slcan_clock_tsc.state, __ATOMIC_ACQUIRE);
+    int none = SLCAN_CLOCK_TSC_NONE;
+
+    if(state == SLCAN_CLOCK_TSC_READY || state == SLCAN_CLOCK_TSC_UNSUPPORTED) return state;
+
+    if(__atomic_compare_exchange_n(&slcan_clock_tsc.state, &none, SLCAN_CLOCK_TSC_BUSY,
+                                   false, __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE)){
+        state = slcan_clock_tsc_calibrate();
+        __atomic_store_n(&slcan_clock_tsc.state, state, __ATOMIC_RELEASE);
+        return state;
+    }
+
+    // calibration in another thread.
+    while((state = __atomic_load_n(&slcan_clock_tsc.state, __ATOMIC_ACQUIRE)) == SLCAN_CLOCK_TSC_BUSY){
+        _mm_pause();
+    }
+
+    return state;
+}
+
+ALWAYS_INLINE static uint64_t slcan_clock_read_tsc_ns(void)
+{
+    uint64_t ticks = __rdtsc() - slcan_clock_tsc.tsc_base;
+
+    return slcan_clock_tsc.ns_base + (uint64_t)(((unsigned __int128)ticks * slcan_clock_tsc.mult) >> 32);
+}
+
+#endif
+
+
+bool slcan_clock_source_supported(slcan_clock_source_t source)
+{
+    switch(source){
+    case SLCAN_CLOCK_SOURCE_MONOTONIC:
+    case SLCAN_CLOCK_SOURCE_COARSE:
+        return true;
+    case SLCAN_CLOCK_SOURCE_TSC:
+#if SLCAN_CLOCK_X86_TSC == 1
+        return slcan_clock_tsc_state() == SLCAN_CLOCK_TSC_READY;
+#else
+        return false;
+#endif
+    }
+
+    return false;
+}
+
+uint64_t slcan_clock_read_ns(slcan_clock_source_t source)
+{
+    switch(source){
+    default:
+    case SLCAN_CLOCK_SOURCE_MONOTONIC:
+        break;
+    case SLCAN_CLOCK_SOURCE_COARSE:
+        return slcan_clock_read_port_ns(slcan_clock_gettime_coarse);
+    case SLCAN_CLOCK_SOURCE_TSC:
+#if SLCAN_CLOCK_X86_TSC == 1
+        return slcan_clock_read_tsc_ns();
+#else
+        break;
+#endif
+    }
+
+    return slcan_clock_read_port_ns(slcan_clock_gettime);
+}
+
+slcan_err_t slcan_clock_init(slcan_clock_t* clock, slcan_clock_source_t source)
+{
+    assert(clock != NULL);
+
+    if(!slcan_clock_source_supported(source)) return E_SLCAN_INVALID_VALUE;
+
+    clock->source = source;
+    clock->cached = false;
+    clock->now_ns = 0;
+
+    return E_SLCAN_NO_ERROR;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file slcan_clock.h
+ * Источники монотонного времени и снимок времени цикла обработки.
+ */
+
+#ifndef SLCAN_CLOCK_H_
+#define SLCAN_CLOCK_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "slcan_defs.h"
+#include "slcan_err.h"
+#include "slcan_conf.h"
+
+
+//! Поддержка счётчика тактов процессора (x86-64, GCC или Clang).
+#if defined(SLCAN_CLOCK_TSC) && SLCAN_CLOCK_TSC == 1 &&\
+    defined(__x86_64__) && defined(__GNUC__)
+#define SLCAN_CLOCK_X86_TSC 1
+#else
+#define SLCAN_CLOCK_X86_TSC 0
+#endif
+
+
+//! Перечисление источников времени.
+typedef enum _Slcan_Clock_Source {
+    SLCAN_CLOCK_SOURCE_MONOTONIC = 0, //!< Монотонное время порта (slcan_clock_gettime).
+    SLCAN_CLOCK_SOURCE_COARSE = 1, //!< Грубое монотонное время порта (slcan_clock_gettime_coarse).
+    SLCAN_CLOCK_SOURCE_TSC = 2, //!< Счётчик тактов процессора, откалиброванный по монотонному времени.
+} slcan_clock_source_t;
+
+//! Структура часов.
+typedef struct _Slcan_Clock {
+    slcan_clock_source_t source; //!< Источник времени.
+    bool cached; //!< Флаг действительного снимка времени.
+    uint64_t now_ns; //!< Снимок времени, нс.
+} slcan_clock_t;
+
+
+/**
+ * Проверяет поддержку источника времени.
+ * Для счётчика тактов при первом вызове
+ * выполняется его калибровка.
+ * @param source Источник времени.
+ * @return Флаг поддержки источника времени.
+ */
+EXTERN bool slcan_clock_source_supported(slcan_clock_source_t source);
+
+/**
+ * Читает время источника.
+ * @param source Поддерживаемый источник времени.
+ * @return Время, нс.
+ */
+EXTERN uint64_t slcan_clock_read_ns(slcan_clock_source_t source);
+
+/**
+ * Инициализирует часы.
+ * @param clock Часы.
+ * @param source Источник времени.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_clock_init(slcan_clock_t* clock, slcan_clock_source_t source);
+
+/**
+ * Делает снимок времени, действительный
+ * до вызова slcan_clock_release().
+ * @param clock Часы.
+ * @return Время, нс.
+ */
+ALWAYS_INLINE static uint64_t slcan_clock_update(slcan_clock_t* clock)
+{
+    clock->now_ns = slcan_clock_read_ns(clock->source);
+    clock->cached = true;
+
+    return clock->now_ns;
+}
+
+/**
+ * Освобождает снимок времени.
+ * @param clock Часы.
+ */
+ALWAYS_INLINE static void slcan_clock_release(slcan_clock_t* clock)
+{
+    clock->cached = false;
+}
+
+/**
+ * Получает текущее время: снимок,
+ * если он действителен, иначе время источника.
+ * @param clock Часы.
+ * @return Время, нс.
+ */
+ALWAYS_INLINE static uint64_t slcan_clock_now(const slcan_clock_t* clock)
+{
+    if(clock->cached) return clock->now_ns;
+
+    return slcan_clock_read_ns(clock->source);
+}
+
+#endif /* SLCAN_CLOCK_H_ */
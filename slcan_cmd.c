@@ -5,9 +5,11 @@
 
 
 
-static slcan_err_t slcan_cmd_ok_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_ok_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    if(slcan_cmd_buf_size(buf) != 1) return E_SLCAN_INVALID_SIZE;
+    (void) buf_data;
+
+    if(buf_data_size != 1) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_OK;
     cmd->mode = SLCAN_CMD_MODE_RESPONSE;
@@ -25,9 +27,11 @@ static slcan_err_t slcan_cmd_ok_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t*
 }
 
 
-static slcan_err_t slcan_cmd_ok_z_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_ok_z_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    if(slcan_cmd_buf_size(buf) != 2) return E_SLCAN_INVALID_SIZE;
+    (void) buf_data;
+
+    if(buf_data_size != 2) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_OK_AUTOPOLL;
     cmd->mode = SLCAN_CMD_MODE_RESPONSE;
@@ -46,9 +50,11 @@ static slcan_err_t slcan_cmd_ok_z_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t
 }
 
 
-static slcan_err_t slcan_cmd_ok_Z_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_ok_Z_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    if(slcan_cmd_buf_size(buf) != 2) return E_SLCAN_INVALID_SIZE;
+    (void) buf_data;
+
+    if(buf_data_size != 2) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_OK_AUTOPOLL_EXT;
     cmd->mode = SLCAN_CMD_MODE_RESPONSE;
@@ -67,9 +73,11 @@ static slcan_err_t slcan_cmd_ok_Z_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t
 }
 
 
-static slcan_err_t slcan_cmd_err_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_err_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    if(slcan_cmd_buf_size(buf) != 1) return E_SLCAN_INVALID_SIZE;
+    (void) buf_data;
+
+    if(buf_data_size != 1) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_ERR;
     cmd->mode = SLCAN_CMD_MODE_RESPONSE;
@@ -87,12 +95,10 @@ static slcan_err_t slcan_cmd_err_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t*
 }
 
 
-static slcan_err_t slcan_cmd_setup_can_std_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_setup_can_std_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 2 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     uint8_t can_bitrate = digit_hex_to_num(cmd_data[0]);
@@ -118,12 +124,10 @@ static slcan_err_t slcan_cmd_setup_can_std_to_buf(const slcan_cmd_t* cmd, slcan_
 }
 
 
-static slcan_err_t slcan_cmd_setup_can_btr_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_setup_can_btr_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 5 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     int i;
@@ -161,9 +165,10 @@ static slcan_err_t slcan_cmd_setup_can_btr_to_buf(const slcan_cmd_t* cmd, slcan_
 }
 
 
-static slcan_err_t slcan_cmd_open_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_open_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_OPEN;
@@ -183,9 +188,10 @@ static slcan_err_t slcan_cmd_open_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t
 }
 
 
-static slcan_err_t slcan_cmd_listen_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_listen_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_LISTEN;
@@ -205,9 +211,10 @@ static slcan_err_t slcan_cmd_listen_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf
 }
 
 
-static slcan_err_t slcan_cmd_close_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_close_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_CLOSE;
@@ -227,17 +234,16 @@ static slcan_err_t slcan_cmd_close_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_
 }
 
 
-static slcan_err_t slcan_cmd_transmit_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_transmit_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
     slcan_err_t err;
 
     slcan_can_msg_t* can_msg = &cmd->transmit.can_msg;
     slcan_can_msg_extdata_t* extdata = &cmd->transmit.extdata;
 
-    err = slcan_can_msg_from_buf(can_msg, extdata, buf);
+    err = slcan_can_msg_from_data(can_msg, extdata, buf_data, buf_data_size);
     if(err != E_SLCAN_NO_ERROR) return err;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     uint8_t cmd_type = buf_data[0];
 
     cmd->type = cmd_type;
@@ -260,9 +266,10 @@ static slcan_err_t slcan_cmd_transmit_to_buf(const slcan_cmd_t* cmd, slcan_cmd_b
 }
 
 
-static slcan_err_t slcan_cmd_poll_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_poll_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_POLL;
@@ -282,9 +289,10 @@ static slcan_err_t slcan_cmd_poll_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t
 }
 
 
-static slcan_err_t slcan_cmd_poll_all_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_poll_all_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_POLL_ALL;
@@ -304,9 +312,10 @@ static slcan_err_t slcan_cmd_poll_all_to_buf(const slcan_cmd_t* cmd, slcan_cmd_b
 }
 
 
-static slcan_err_t slcan_cmd_status_req_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_status_req_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_STATUS;
@@ -326,12 +335,10 @@ static slcan_err_t slcan_cmd_status_req_to_buf(const slcan_cmd_t* cmd, slcan_cmd
 }
 
 
-static slcan_err_t slcan_cmd_status_resp_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_status_resp_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 3 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     int i;
@@ -364,13 +371,12 @@ static slcan_err_t slcan_cmd_status_resp_to_buf(const slcan_cmd_t* cmd, slcan_cm
 }
 
 
-static slcan_err_t slcan_cmd_status_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_status_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size == 1 + 1 /* EOM */){
-        return slcan_cmd_status_req_from_buf(cmd, buf);
+        return slcan_cmd_status_req_from_data(cmd, buf_data, buf_data_size);
     }else{
-        return slcan_cmd_status_resp_from_buf(cmd, buf);
+        return slcan_cmd_status_resp_from_data(cmd, buf_data, buf_data_size);
     }
 }
 
@@ -384,12 +390,10 @@ static slcan_err_t slcan_cmd_status_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf
 }
 
 
-static slcan_err_t slcan_cmd_set_auto_poll_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_set_auto_poll_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 2 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     uint8_t value = digit_hex_to_num(cmd_data[0]);
@@ -415,20 +419,54 @@ static slcan_err_t slcan_cmd_set_auto_poll_to_buf(const slcan_cmd_t* cmd, slcan_
 }
 
 
-static slcan_err_t slcan_cmd_setup_uart_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_setup_uart_custom_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
+{
+    (void) buf_data_size;
+
+    const uint8_t* cmd_data = &buf_data[1];
+
+    int i;
+
+    // check cmd data.
+    for(i = 0; i < 8; i ++){
+        if(!isxdigit(cmd_data[i])) return E_SLCAN_INVALID_DATA;
+    }
+
+    // most significant digit first.
+    uint32_t baud_rate = 0;
+    for(i = 0; i < 8; i ++){
+        baud_rate = (baud_rate << 4) | (digit_hex_to_num(cmd_data[i]) & 0x0f);
+    }
+
+    if(baud_rate == 0) return E_SLCAN_INVALID_DATA;
+
+    cmd->type = SLCAN_CMD_SETUP_UART;
+    cmd->mode = SLCAN_CMD_MODE_REQUEST;
+    cmd->setup_uart.baud = SLCAN_PORT_BAUD_CUSTOM;
+    cmd->setup_uart.baud_rate = baud_rate;
+
+    return E_SLCAN_NO_ERROR;
+}
+
+static slcan_err_t slcan_cmd_setup_uart_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+
+    // Uxxxxxxxx - custom baud rate.
+    if(buf_data_size == 9 + 1 /* EOM */) return slcan_cmd_setup_uart_custom_from_data(cmd, buf_data, buf_data_size);
+
     if(buf_data_size != 2 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
+    if(!isxdigit(cmd_data[0])) return E_SLCAN_INVALID_DATA;
+
     uint8_t uart_baud = digit_hex_to_num(cmd_data[0]);
-    if(/*uart_baud < 0 && */ uart_baud > 6) return E_SLCAN_INVALID_DATA;
+    if(uart_baud > SLCAN_PORT_BAUD_STD_MAX) return E_SLCAN_INVALID_DATA;
 
     cmd->type = SLCAN_CMD_SETUP_UART;
     cmd->mode = SLCAN_CMD_MODE_REQUEST;
     cmd->setup_uart.baud = uart_baud;
+    cmd->setup_uart.baud_rate = 0;
 
     return E_SLCAN_NO_ERROR;
 }
@@ -437,8 +475,19 @@ static slcan_err_t slcan_cmd_setup_uart_to_buf(const slcan_cmd_t* cmd, slcan_cmd
 {
     if(slcan_cmd_buf_put(buf, SLCAN_CMD_SETUP_UART) == 0) return E_SLCAN_OVERFLOW;
 
-    uint8_t uart_baud = digit_num_to_hex(cmd->setup_uart.baud);
-    if(slcan_cmd_buf_put(buf, uart_baud) == 0) return E_SLCAN_OVERFLOW;
+    int i;
+
+    if(cmd->setup_uart.baud == SLCAN_PORT_BAUD_CUSTOM){
+        // most significant digit first.
+        for(i = 7; i >= 0; i --){
+            if(slcan_cmd_buf_put(buf, digit_num_to_hex((cmd->setup_uart.baud_rate >> (i * 4)) & 0x0f)) == 0) return E_SLCAN_OVERFLOW;
+        }
+    }else{
+        if(cmd->setup_uart.baud > SLCAN_PORT_BAUD_STD_MAX) return E_SLCAN_INVALID_DATA;
+
+        uint8_t uart_baud = digit_num_to_hex(cmd->setup_uart.baud);
+        if(slcan_cmd_buf_put(buf, uart_baud) == 0) return E_SLCAN_OVERFLOW;
+    }
 
     if(slcan_cmd_buf_put(buf, SLCAN_CMD_OK) == 0) return E_SLCAN_OVERFLOW;
 
@@ -446,9 +495,10 @@ static slcan_err_t slcan_cmd_setup_uart_to_buf(const slcan_cmd_t* cmd, slcan_cmd
 }
 
 
-static slcan_err_t slcan_cmd_version_req_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_version_req_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_VERSION;
@@ -468,12 +518,10 @@ static slcan_err_t slcan_cmd_version_req_to_buf(const slcan_cmd_t* cmd, slcan_cm
 }
 
 
-static slcan_err_t slcan_cmd_version_resp_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_version_resp_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 5 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     int i;
@@ -511,13 +559,12 @@ static slcan_err_t slcan_cmd_version_resp_to_buf(const slcan_cmd_t* cmd, slcan_c
 }
 
 
-static slcan_err_t slcan_cmd_version_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_version_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size == 1 + 1 /* EOM */){
-        return slcan_cmd_version_req_from_buf(cmd, buf);
+        return slcan_cmd_version_req_from_data(cmd, buf_data, buf_data_size);
     }else{
-        return slcan_cmd_version_resp_from_buf(cmd, buf);
+        return slcan_cmd_version_resp_from_data(cmd, buf_data, buf_data_size);
     }
 }
 
@@ -531,9 +578,10 @@ static slcan_err_t slcan_cmd_version_to_buf(const slcan_cmd_t* cmd, slcan_cmd_bu
 }
 
 
-static slcan_err_t slcan_cmd_sn_req_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_sn_req_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
+    (void) buf_data;
+
     if(buf_data_size != 1 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
     cmd->type = SLCAN_CMD_SN;
@@ -553,12 +601,10 @@ static slcan_err_t slcan_cmd_sn_req_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf
 }
 
 
-static slcan_err_t slcan_cmd_sn_resp_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_sn_resp_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 5 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     int i;
@@ -595,13 +641,12 @@ static slcan_err_t slcan_cmd_sn_resp_to_buf(const slcan_cmd_t* cmd, slcan_cmd_bu
 }
 
 
-static slcan_err_t slcan_cmd_sn_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_sn_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size == 1 + 1 /* EOM */){
-        return slcan_cmd_sn_req_from_buf(cmd, buf);
+        return slcan_cmd_sn_req_from_data(cmd, buf_data, buf_data_size);
     }else{
-        return slcan_cmd_sn_resp_from_buf(cmd, buf);
+        return slcan_cmd_sn_resp_from_data(cmd, buf_data, buf_data_size);
     }
 }
 
@@ -615,12 +660,10 @@ static slcan_err_t slcan_cmd_sn_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t*
 }
 
 
-static slcan_err_t slcan_cmd_set_timestamp_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_set_timestamp_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 2 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     uint8_t value = digit_hex_to_num(cmd_data[0]);
@@ -646,12 +689,10 @@ static slcan_err_t slcan_cmd_set_timestamp_to_buf(const slcan_cmd_t* cmd, slcan_
 }
 
 
-static slcan_err_t slcan_cmd_set_acceptance_mask_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_set_acceptance_mask_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 9 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     int i;
@@ -696,12 +737,10 @@ static slcan_err_t slcan_cmd_set_acceptance_mask_to_buf(const slcan_cmd_t* cmd,
 }
 
 
-static slcan_err_t slcan_cmd_set_acceptance_filter_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_set_acceptance_filter_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    size_t buf_data_size = slcan_cmd_buf_size(buf);
     if(buf_data_size != 9 + 1 /* EOM */) return E_SLCAN_INVALID_SIZE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     const uint8_t* cmd_data = &buf_data[1];
 
     int i;
@@ -746,9 +785,9 @@ static slcan_err_t slcan_cmd_set_acceptance_filter_to_buf(const slcan_cmd_t* cmd
 }
 
 
-static slcan_err_t slcan_cmd_unknown_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+static slcan_err_t slcan_cmd_unknown_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
+    (void) buf_data_size;
 
     cmd->type = SLCAN_CMD_UNKNOWN;
     cmd->mode = SLCAN_CMD_MODE_REQUEST;
@@ -776,69 +815,75 @@ static bool slcan_cmd__to_buf(slcan_cmd_t* cmd, slcan_cmd_buf_t* buf)
 */
 
 
-slcan_err_t slcan_cmd_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+slcan_err_t slcan_cmd_from_data(slcan_cmd_t* cmd, const uint8_t* buf_data, size_t buf_data_size)
 {
     assert(cmd != NULL);
 
-    if(buf == NULL) return E_SLCAN_NULL_POINTER;
-    if(slcan_cmd_buf_size(buf) == 0) return E_SLCAN_INVALID_VALUE;
+    if(buf_data == NULL) return E_SLCAN_NULL_POINTER;
+    if(buf_data_size == 0) return E_SLCAN_INVALID_VALUE;
 
-    const uint8_t* buf_data = slcan_cmd_buf_data_const(buf);
     uint8_t cmd_type = buf_data[0];
 
     switch(cmd_type){
     default:
-        return slcan_cmd_unknown_from_buf(cmd, buf);
+        return slcan_cmd_unknown_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_OK:
-        return slcan_cmd_ok_from_buf(cmd, buf);
+        return slcan_cmd_ok_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_OK_AUTOPOLL:
-        return slcan_cmd_ok_z_from_buf(cmd, buf);
+        return slcan_cmd_ok_z_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_ERR:
-        return slcan_cmd_err_from_buf(cmd, buf);
+        return slcan_cmd_err_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_SETUP_CAN_STD:
-        return slcan_cmd_setup_can_std_from_buf(cmd, buf);
+        return slcan_cmd_setup_can_std_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_SETUP_CAN_BTR:
-        return slcan_cmd_setup_can_btr_from_buf(cmd, buf);
+        return slcan_cmd_setup_can_btr_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_OPEN:
-        return slcan_cmd_open_from_buf(cmd, buf);
+        return slcan_cmd_open_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_LISTEN:
-        return slcan_cmd_listen_from_buf(cmd, buf);
+        return slcan_cmd_listen_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_CLOSE:
-        return slcan_cmd_close_from_buf(cmd, buf);
+        return slcan_cmd_close_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_TRANSMIT:
     case SLCAN_CMD_TRANSMIT_EXT:
     case SLCAN_CMD_TRANSMIT_RTR:
     case SLCAN_CMD_TRANSMIT_RTR_EXT:
-        return slcan_cmd_transmit_from_buf(cmd, buf);
+        return slcan_cmd_transmit_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_POLL:
-        return slcan_cmd_poll_from_buf(cmd, buf);
+        return slcan_cmd_poll_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_POLL_ALL:
-        return slcan_cmd_poll_all_from_buf(cmd, buf);
+        return slcan_cmd_poll_all_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_STATUS:
-        return slcan_cmd_status_from_buf(cmd, buf);
+        return slcan_cmd_status_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_SET_AUTO_POLL:
-        return slcan_cmd_set_auto_poll_from_buf(cmd, buf);
+        return slcan_cmd_set_auto_poll_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_SETUP_UART:
-        return slcan_cmd_setup_uart_from_buf(cmd, buf);
+        return slcan_cmd_setup_uart_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_VERSION:
-        return slcan_cmd_version_from_buf(cmd, buf);
+        return slcan_cmd_version_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_SN:
-        return slcan_cmd_sn_from_buf(cmd, buf);
+        return slcan_cmd_sn_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_SET_TIMESTAMP: // SLCAN_CMD_OK_AUTOPOLL_EXT
-        if(slcan_cmd_buf_size(buf) == 2){
-            return slcan_cmd_ok_Z_from_buf(cmd, buf);
+        if(buf_data_size == 2){
+            return slcan_cmd_ok_Z_from_data(cmd, buf_data, buf_data_size);
         }else{
-            return slcan_cmd_set_timestamp_from_buf(cmd, buf);
+            return slcan_cmd_set_timestamp_from_data(cmd, buf_data, buf_data_size);
         }
     case SLCAN_CMD_SET_ACCEPTANCE_MASK:
-        return slcan_cmd_set_acceptance_mask_from_buf(cmd, buf);
+        return slcan_cmd_set_acceptance_mask_from_data(cmd, buf_data, buf_data_size);
     case SLCAN_CMD_SET_ACCEPTANCE_FILTER:
-        return slcan_cmd_set_acceptance_filter_from_buf(cmd, buf);
+        return slcan_cmd_set_acceptance_filter_from_data(cmd, buf_data, buf_data_size);
     }
 
     return E_SLCAN_NO_ERROR;
 }
 
+slcan_err_t slcan_cmd_from_buf(slcan_cmd_t* cmd, const slcan_cmd_buf_t* buf)
+{
+    if(buf == NULL) return E_SLCAN_NULL_POINTER;
+
+    return slcan_cmd_from_data(cmd, slcan_cmd_buf_data_const(buf), slcan_cmd_buf_size(buf));
+}
+
 slcan_err_t slcan_cmd_to_buf(const slcan_cmd_t* cmd, slcan_cmd_buf_t* buf)
 {
     assert(cmd != NULL);
@@ -89,6 +89,7 @@ typedef struct _Slcan_Cmd_Set_Auto_Poll {
 //! Тип команды настройки UART.
 typedef struct _Slcan_Cmd_Setup_Uart {
     slcan_port_baud_t baud; //!< Стандартная скорость UART.
+    uint32_t baud_rate; //!< Произвольная скорость UART (при baud == SLCAN_PORT_BAUD_CUSTOM).
 } slcan_cmd_setup_uart_t;
 
 //! Тип команды запроса получения версии.
@@ -208,6 +209,15 @@ typedef struct _Slcan_Cmd {
     };
 } slcan_cmd_t;
 
+/**
+ * Десериализует команду из данных.
+ * @param cmd Команда.
+ * @param data Данные команды, включая EOM.
+ * @param data_size Размер данных.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_cmd_from_data(slcan_cmd_t* cmd, const uint8_t* data, size_t data_size);
+
 /**
  * Десериализует команду из буфера.
  * @param cmd Команда.
@@ -0,0 +1,109 @@
+#include "slcan_future.h"
+#include "slcan_port.h"
+#include "slcan_utils.h"
+#include <assert.h>
+
+
+// Счётчик пробуждений ждущих будущих потоков.
+// Один на все будущие: ожидание любого из массива
+// будущих - ожидание изменения одного значения.
+static uint32_t slcan_future_wake_seq = 0;
+
+
+void slcan_future_wake(void)
+{
+    __atomic_fetch_add(&slcan_future_wake_seq, 1, __ATOMIC_SEQ_CST);
+
+    slcan_address_wake(&slcan_future_wake_seq);
+}
+
+// Отмечает ожидание выполняющегося будущего.
+// Возвращает флаг выполнения.
+static bool slcan_future_add_waiter(slcan_future_t* future)
+{
+    // acquire - the result of the done future is visible.
+    uint32_t state = __atomic_load_n(&future->state, __ATOMIC_ACQUIRE);
+
+    do{
+        if(!(state & SLCAN_FUTURE_STATE_RUNNING)) return false;
+        if(state & SLCAN_FUTURE_STATE_WAITERS) return true;
+    }while(!__atomic_compare_exchange_n(&future->state, &state, state | SLCAN_FUTURE_STATE_WAITERS, true,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+
+    return true;
+}
+
+// Ждёт окончания любого (all == false) или всех (all == true) будущих.
+static slcan_err_t slcan_future_wait_impl(slcan_future_t* const* futures, size_t count, bool all,
+                                          const struct timespec* tp_timeout, size_t* index)
+{
+    struct timespec tp_end, tp_cur, tp_wait;
+    const struct timespec* p_tp_wait = NULL;
+    uint32_t seq;
+    size_t i, running;
+
+    if(tp_timeout){
+        slcan_clock_gettime(&tp_cur);
+        slcan_timespec_add(&tp_cur, tp_timeout, &tp_end);
+    }else{
+        tp_end.tv_sec = 0;
+        tp_end.tv_nsec = 0;
+    }
+
+    for(;;){
+        // the counter is read before the states:
+        // any finish after the check changes it.
+        seq = __atomic_load_n(&slcan_future_wake_seq, __ATOMIC_SEQ_CST);
+
+        running = 0;
+        for(i = 0; i < count; i ++){
+            if(futures[i] == NULL) continue;
+
+            if(slcan_future_add_waiter(futures[i])){
+                running ++;
+            }else if(!all){
+                if(index) *index = i;
+                return E_SLCAN_NO_ERROR;
+            }
+        }
+
+        if(running == 0){
+            // nothing to wait for any.
+            if(!all) return E_SLCAN_INVALID_VALUE;
+            return E_SLCAN_NO_ERROR;
+        }
+
+        if(tp_timeout){
+            slcan_clock_gettime(&tp_cur);
+            if(!slcan_timespec_remain(&tp_end, &tp_cur, &tp_wait)) return E_SLCAN_TIMEOUT;
+            p_tp_wait = &tp_wait;
+        }
+
+        if(slcan_address_wait(&slcan_future_wake_seq, seq, slcan_timespec_to_poll_ms(p_tp_wait)) != SLCAN_IO_SUCCESS){
+            return E_SLCAN_IO_ERROR;
+        }
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
+slcan_err_t slcan_future_wait_for(slcan_future_t* future, const struct timespec* tp_timeout)
+{
+    assert(future != NULL);
+
+    return slcan_future_wait_impl(&future, 1, false, tp_timeout, NULL);
+}
+
+slcan_err_t slcan_future_wait_any(slcan_future_t* const* futures, size_t count, const struct timespec* tp_timeout, size_t* index)
+{
+    if(futures == NULL) return E_SLCAN_NULL_POINTER;
+
+    return slcan_future_wait_impl(futures, count, false, tp_timeout, index);
+}
+
+slcan_err_t slcan_future_wait_all(slcan_future_t* const* futures, size_t count, const struct timespec* tp_timeout)
+{
+    if(futures == NULL) return E_SLCAN_NULL_POINTER;
+
+    return slcan_future_wait_impl(futures, count, true, tp_timeout, NULL);
+}
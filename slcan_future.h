@@ -2,8 +2,10 @@
 #define SLCAN_FUTURE_H_
 
 
+#include <stdint.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <time.h>
 #include "slcan_defs.h"
 #include "slcan_err.h"
 
@@ -23,18 +25,62 @@
 #define SLCAN_FUTURE_RESULT_ERR(RES) ((slcan_err_t)SLCAN_FUTURE_RESULT_CAST(ptrdiff_t, RES))
 
 
+//! Флаг окончания.
+#define SLCAN_FUTURE_STATE_DONE 0x1
+//! Флаг выполнения.
+#define SLCAN_FUTURE_STATE_RUNNING 0x2
+//! Флаг ожидающих потоков - завершение будит их.
+#define SLCAN_FUTURE_STATE_WAITERS 0x4
+
+
 /**
  * Структура будущего.
+ * Поля изменяются атомарно: будущее можно завершать
+ * в одном потоке и ждать в других.
  */
 typedef struct _Slcan_Future {
     //! Результат.
-    void * volatile result;
-    //! Флаг окончания.
-    volatile bool done;
-    //! Флаг выполнения.
-    volatile bool running;
+    void* result;
+    //! Слово состояния (SLCAN_FUTURE_STATE_*).
+    uint32_t state;
 } slcan_future_t;
 
+
+/**
+ * Будит потоки, ждущие будущих.
+ * Вызывается при завершении будущего с ожидающими потоками.
+ */
+EXTERN void slcan_future_wake(void);
+
+/**
+ * Ждёт окончания выполнения будущего не дольше тайм-аута.
+ * @param future Будущее.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @return Код ошибки, E_SLCAN_TIMEOUT - если тайм-аут истёк.
+ */
+EXTERN slcan_err_t slcan_future_wait_for(slcan_future_t* future, const struct timespec* tp_timeout);
+
+/**
+ * Ждёт окончания выполнения любого из будущих не дольше тайм-аута.
+ * @param futures Будущие, NULL элементы пропускаются.
+ * @param count Число будущих.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @param index Индекс первого не выполняющегося будущего, может быть NULL.
+ * @return Код ошибки, E_SLCAN_TIMEOUT - если тайм-аут истёк,
+ * E_SLCAN_INVALID_VALUE - если будущих нет.
+ */
+EXTERN slcan_err_t slcan_future_wait_any(slcan_future_t* const* futures, size_t count, const struct timespec* tp_timeout, size_t* index);
+
+/**
+ * Ждёт окончания выполнения всех будущих не дольше тайм-аута.
+ * @param futures Будущие, NULL элементы пропускаются.
+ * @param count Число будущих.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @return Код ошибки, E_SLCAN_TIMEOUT - если тайм-аут истёк.
+ */
+EXTERN slcan_err_t slcan_future_wait_all(slcan_future_t* const* futures, size_t count, const struct timespec* tp_timeout);
+
+
 /**
  * Инициализирует будущее.
  * Незавершённое, невыполняющееся, с нулевым результатом.
@@ -42,9 +88,8 @@ typedef struct _Slcan_Future {
  */
 ALWAYS_INLINE static void slcan_future_init(slcan_future_t* future)
 {
-    future->result = NULL;
-    future->done = false;
-    future->running = false;
+    __atomic_store_n(&future->result, NULL, __ATOMIC_RELAXED);
+    __atomic_store_n(&future->state, 0, __ATOMIC_RELEASE);
 }
 
 /**
@@ -54,7 +99,7 @@ ALWAYS_INLINE static void slcan_future_init(slcan_future_t* future)
  */
 ALWAYS_INLINE static void* slcan_future_result(const slcan_future_t* future)
 {
-    return future->result;
+    return __atomic_load_n(&future->result, __ATOMIC_RELAXED);
 }
 
 /**
@@ -64,27 +109,29 @@ ALWAYS_INLINE static void* slcan_future_result(const slcan_future_t* future)
  */
 ALWAYS_INLINE static void slcan_future_set_result(slcan_future_t* future, void* result)
 {
-    future->result = result;
+    __atomic_store_n(&future->result, result, __ATOMIC_RELAXED);
 }
 
 /**
- * Получает флаг завершения.
+ * Получает слово состояния будущего.
+ * Загрузка с семантикой acquire - после окончания
+ * виден результат.
  * @param future Будущее.
- * @return Флаг завершения.
+ * @return Слово состояния.
  */
-ALWAYS_INLINE static bool slcan_future_done(const slcan_future_t* future)
+ALWAYS_INLINE static uint32_t slcan_future_state(const slcan_future_t* future)
 {
-    return future->done;
+    return __atomic_load_n(&future->state, __ATOMIC_ACQUIRE);
 }
 
 /**
- * Устанавливает флаг завершения.
+ * Получает флаг завершения.
  * @param future Будущее.
- * @param done Флаг завершения.
+ * @return Флаг завершения.
  */
-ALWAYS_INLINE static void slcan_future_set_done(slcan_future_t* future, bool done)
+ALWAYS_INLINE static bool slcan_future_done(const slcan_future_t* future)
 {
-    future->done = done;
+    return (slcan_future_state(future) & SLCAN_FUTURE_STATE_DONE) != 0;
 }
 
 /**
@@ -94,7 +141,35 @@ ALWAYS_INLINE static void slcan_future_set_done(slcan_future_t* future, bool don
  */
 ALWAYS_INLINE static bool slcan_future_running(const slcan_future_t* future)
 {
-    return future->running;
+    return (slcan_future_state(future) & SLCAN_FUTURE_STATE_RUNNING) != 0;
+}
+
+// Изменяет флаги состояния, будит ожидающих при окончании выполнения.
+ALWAYS_INLINE static void slcan_future_update_state(slcan_future_t* future, uint32_t clear, uint32_t set)
+{
+    uint32_t state = __atomic_load_n(&future->state, __ATOMIC_RELAXED);
+    uint32_t new_state;
+
+    do{
+        new_state = (state & ~clear) | set;
+    }while(!__atomic_compare_exchange_n(&future->state, &state, new_state, true,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+
+    if((state & SLCAN_FUTURE_STATE_WAITERS) &&
+       (state & SLCAN_FUTURE_STATE_RUNNING) && !(new_state & SLCAN_FUTURE_STATE_RUNNING)){
+        slcan_future_wake();
+    }
+}
+
+/**
+ * Устанавливает флаг завершения.
+ * @param future Будущее.
+ * @param done Флаг завершения.
+ */
+ALWAYS_INLINE static void slcan_future_set_done(slcan_future_t* future, bool done)
+{
+    if(done) slcan_future_update_state(future, 0, SLCAN_FUTURE_STATE_DONE);
+    else slcan_future_update_state(future, SLCAN_FUTURE_STATE_DONE, 0);
 }
 
 /**
@@ -104,7 +179,8 @@ ALWAYS_INLINE static bool slcan_future_running(const slcan_future_t* future)
  */
 ALWAYS_INLINE static void slcan_future_set_running(slcan_future_t* future, bool running)
 {
-    future->running = running;
+    if(running) slcan_future_update_state(future, 0, SLCAN_FUTURE_STATE_RUNNING);
+    else slcan_future_update_state(future, SLCAN_FUTURE_STATE_RUNNING, 0);
 }
 
 /**
@@ -113,35 +189,38 @@ ALWAYS_INLINE static void slcan_future_set_running(slcan_future_t* future, bool
  */
 ALWAYS_INLINE static void slcan_future_start(slcan_future_t* future)
 {
-    future->done = false;
-    future->running = true;
+    // waiters of the previous run are kept.
+    slcan_future_update_state(future, SLCAN_FUTURE_STATE_DONE, SLCAN_FUTURE_STATE_RUNNING);
 }
 
 /**
  * Завершает выполнение будущего (done = true; running = false;).
+ * Будит ожидающие будущее потоки.
  * @param future Будущее.
  * @param result Результат.
  */
 ALWAYS_INLINE static void slcan_future_finish(slcan_future_t* future, void* result)
 {
-    future->done = true;
-    future->running = false;
-    future->result = result;
+    uint32_t state;
+
+    __atomic_store_n(&future->result, result, __ATOMIC_RELAXED);
+
+    state = __atomic_exchange_n(&future->state, SLCAN_FUTURE_STATE_DONE, __ATOMIC_SEQ_CST);
+
+    if(state & SLCAN_FUTURE_STATE_WAITERS) slcan_future_wake();
 }
 
 /**
  * Ждёт окончания выполнения будущего.
+ * Поток блокируется до завершения будущего.
  * @param future Будущее.
  */
 ALWAYS_INLINE static void slcan_future_wait(const slcan_future_t* future)
 {
-    for(;;){
-        if(!slcan_future_running(future)) break;
-    }
-}
-
-
-
+    if(!slcan_future_running(future)) return;
 
+    // only the state word is changed - waiters flag.
+    slcan_future_wait_for((slcan_future_t*)future, NULL);
+}
 
 #endif /* SLCAN_FUTURE_H_ */
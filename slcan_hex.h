@@ -0,0 +1,131 @@
+/**
+ * @file slcan_hex.h
+ * Разбор и запись шестнадцатиричных чисел по таблицам.
+ */
+
+#ifndef SLCAN_HEX_H_
+#define SLCAN_HEX_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "slcan_defs.h"
+
+
+//! Значение таблицы для символа, не являющегося шестнадцатиричной цифрой.
+#define SLCAN_HEX_INVALID 0xff
+
+
+/**
+ * Таблица значений шестнадцатиричных цифр,
+ * SLCAN_HEX_INVALID - для остальных символов.
+ * Не зависит от локали.
+ */
+EXTERN const uint8_t slcan_hex_digit_values[256];
+
+/**
+ * Таблица шестнадцатиричной записи байт
+ * (две цифры в верхнем регистре, старшая первая).
+ */
+EXTERN const uint8_t slcan_hex_byte_chars[256][2];
+
+
+/**
+ * Получает значение шестнадцатиричной цифры.
+ * @param digit Цифра.
+ * @return Значение цифры, SLCAN_HEX_INVALID - если символ не цифра.
+ */
+ALWAYS_INLINE static uint8_t slcan_hex_digit_value(uint8_t digit)
+{
+    return slcan_hex_digit_values[digit];
+}
+
+/**
+ * Проверяет и разбирает за один проход
+ * шестнадцатиричное число (старшая цифра первая).
+ * @param hex Цифры.
+ * @param digits Число цифр, не более 8.
+ * @param value Значение.
+ * @return Маска неверных цифр (бит i - цифра i), 0 - если все цифры верны.
+ */
+ALWAYS_INLINE static uint32_t slcan_hex_decode(const uint8_t* hex, size_t digits, uint32_t* value)
+{
+    uint32_t res = 0;
+    uint32_t invalid = 0;
+    uint8_t digit;
+    size_t i;
+
+    for(i = 0; i < digits; i ++){
+        digit = slcan_hex_digit_values[hex[i]];
+        invalid |= (uint32_t)(digit >> 7) << i;
+        res = (res << 4) | (digit & 0x0f);
+    }
+
+    *value = res;
+
+    return invalid;
+}
+
+/**
+ * Проверяет и разбирает за один проход
+ * последовательность байт по две шестнадцатиричные цифры.
+ * @param hex Цифры, 2 * count.
+ * @param bytes Байты.
+ * @param count Число байт, не более 16.
+ * @return Маска неверных цифр (бит i - цифра i), 0 - если все цифры верны.
+ */
+ALWAYS_INLINE static uint32_t slcan_hex_decode_bytes(const uint8_t* hex, uint8_t* bytes, size_t count)
+{
+    uint32_t invalid = 0;
+    uint8_t hi, lo;
+    size_t i;
+
+    for(i = 0; i < count; i ++){
+        hi = slcan_hex_digit_values[hex[2 * i]];
+        lo = slcan_hex_digit_values[hex[2 * i + 1]];
+        invalid |= (uint32_t)((hi >> 7) | ((lo >> 7) << 1)) << (2 * i);
+        bytes[i] = (uint8_t)((hi << 4) | (lo & 0x0f));
+    }
+
+    return invalid;
+}
+
+/**
+ * Записывает шестнадцатиричное число (старшая цифра первая).
+ * @param hex Буфер для цифр.
+ * @param value Значение.
+ * @param digits Число цифр, не более 8.
+ */
+ALWAYS_INLINE static void slcan_hex_encode(uint8_t* hex, uint32_t value, size_t digits)
+{
+    size_t i;
+
+    // pairs of digits from the end.
+    for(i = digits; i >= 2; i -= 2){
+        hex[i - 2] = slcan_hex_byte_chars[value & 0xff][0];
+        hex[i - 1] = slcan_hex_byte_chars[value & 0xff][1];
+        value >>= 8;
+    }
+    // odd leading digit.
+    if(i == 1){
+        hex[0] = slcan_hex_byte_chars[value & 0x0f][1];
+    }
+}
+
+/**
+ * Записывает последовательность байт по две шестнадцатиричные цифры.
+ * @param hex Буфер для цифр, 2 * count.
+ * @param bytes Байты.
+ * @param count Число байт.
+ */
+ALWAYS_INLINE static void slcan_hex_encode_bytes(uint8_t* hex, const uint8_t* bytes, size_t count)
+{
+    size_t i;
+
+    for(i = 0; i < count; i ++){
+        hex[2 * i] = slcan_hex_byte_chars[bytes[i]][0];
+        hex[2 * i + 1] = slcan_hex_byte_chars[bytes[i]][1];
+    }
+}
+
+#endif /* SLCAN_HEX_H_ */
@@ -6,16 +6,33 @@
 
 void slcan_io_fifo_init(slcan_io_fifo_t* fifo)
 {
-    memset(fifo->buf, 0x0, SLCAN_IO_FIFO_SIZE);
-    fifo->wptr = 0;
-    fifo->rptr = 0;
-    fifo->count = 0;
+    slcan_io_fifo_init_buf(fifo, NULL, 0);
+}
+
+slcan_err_t slcan_io_fifo_init_buf(slcan_io_fifo_t* fifo, uint8_t* buf, size_t size)
+{
+    if(buf == NULL){
+        buf = fifo->default_buf;
+        size = SLCAN_IO_FIFO_SIZE;
+    }
+
+    if(!slcan_io_fifo_buf_valid(buf, size)) return E_SLCAN_INVALID_SIZE;
+
+    memset(buf, 0x0, size);
+
+    fifo->buf = buf;
+    fifo->size = size;
+    fifo->mask = size - 1;
+    slcan_fifo_index_store(fifo->wptr, 0);
+    slcan_fifo_index_store(fifo->rptr, 0);
+
+    return E_SLCAN_NO_ERROR;
 }
 
 size_t slcan_io_fifo_read_line_size(const slcan_io_fifo_t* fifo)
 {
     size_t size = slcan_io_fifo_avail(fifo);
-    size_t max_size = SLCAN_IO_FIFO_SIZE - fifo->rptr;
+    size_t max_size = fifo->size - (slcan_fifo_index_load_relaxed(fifo->rptr) & fifo->mask);
 
     size_t line_size = MIN(size, max_size);
 
@@ -25,22 +42,58 @@ size_t slcan_io_fifo_read_line_size(const slcan_io_fifo_t* fifo)
 size_t slcan_io_fifo_write_line_size(const slcan_io_fifo_t* fifo)
 {
     size_t size = slcan_io_fifo_remain(fifo);
-    size_t max_size = SLCAN_IO_FIFO_SIZE - fifo->wptr;
+    size_t max_size = fifo->size - (slcan_fifo_index_load_relaxed(fifo->wptr) & fifo->mask);
 
     size_t line_size = MIN(size, max_size);
 
     return line_size;
 }
 
+size_t slcan_io_fifo_read_spans(slcan_io_fifo_t* fifo, slcan_io_fifo_span_t* spans)
+{
+    size_t size = slcan_io_fifo_avail(fifo);
+    if(size == 0) return 0;
+
+    size_t max_line_size = fifo->size - (slcan_fifo_index_load_relaxed(fifo->rptr) & fifo->mask);
+    size_t line_size = MIN(size, max_line_size);
+
+    spans[0].data = slcan_io_fifo_data_to_read(fifo);
+    spans[0].size = line_size;
+
+    if(line_size == size) return 1;
+
+    // wrapped data.
+    spans[1].data = &fifo->buf[0];
+    spans[1].size = size - line_size;
+
+    return 2;
+}
+
+size_t slcan_io_fifo_write_spans(slcan_io_fifo_t* fifo, slcan_io_fifo_span_t* spans)
+{
+    size_t size = slcan_io_fifo_remain(fifo);
+    if(size == 0) return 0;
+
+    size_t max_line_size = fifo->size - (slcan_fifo_index_load_relaxed(fifo->wptr) & fifo->mask);
+    size_t line_size = MIN(size, max_line_size);
+
+    spans[0].data = slcan_io_fifo_data_to_write(fifo);
+    spans[0].size = line_size;
+
+    if(line_size == size) return 1;
+
+    // wrapped space.
+    spans[1].data = &fifo->buf[0];
+    spans[1].size = size - line_size;
+
+    return 2;
+}
+
 size_t slcan_io_fifo_put(slcan_io_fifo_t* fifo, uint8_t data)
 {
-    if(fifo->count < SLCAN_IO_FIFO_SIZE){
-        fifo->buf[fifo->wptr] = data;
-        fifo->count ++;
-        fifo->wptr ++;
-        if(fifo->wptr >= SLCAN_IO_FIFO_SIZE){
-            fifo->wptr = 0;
-        }
+    if(!slcan_io_fifo_full(fifo)){
+        *slcan_io_fifo_data_to_write(fifo) = data;
+        slcan_io_fifo_data_written(fifo, 1);
         return 1;
     }
     return 0;
@@ -48,13 +101,9 @@ size_t slcan_io_fifo_put(slcan_io_fifo_t* fifo, uint8_t data)
 
 size_t slcan_io_fifo_get(slcan_io_fifo_t* fifo, uint8_t* data)
 {
-    if(data && fifo->count > 0){
-        *data = fifo->buf[fifo->rptr];
-        fifo->count --;
-        fifo->rptr ++;
-        if(fifo->rptr >= SLCAN_IO_FIFO_SIZE){
-            fifo->rptr = 0;
-        }
+    if(data && !slcan_io_fifo_empty(fifo)){
+        *data = *slcan_io_fifo_data_to_read(fifo);
+        slcan_io_fifo_data_readed(fifo, 1);
         return 1;
     }
     return 0;
@@ -62,8 +111,8 @@ size_t slcan_io_fifo_get(slcan_io_fifo_t* fifo, uint8_t* data)
 
 size_t slcan_io_fifo_peek(const slcan_io_fifo_t* fifo, uint8_t* data)
 {
-    if(data && fifo->count > 0){
-        *data = fifo->buf[fifo->rptr];
+    if(data && !slcan_io_fifo_empty(fifo)){
+        *data = fifo->buf[slcan_fifo_index_load_relaxed(fifo->rptr) & fifo->mask];
         return 1;
     }
     return 0;
@@ -71,12 +120,18 @@ size_t slcan_io_fifo_peek(const slcan_io_fifo_t* fifo, uint8_t* data)
 
 size_t slcan_io_fifo_write(slcan_io_fifo_t* fifo, const uint8_t* data, size_t data_size)
 {
-    size_t count;
-    for(count = 0; count < data_size; count ++){
-        if(slcan_io_fifo_put(fifo, data[count]) == 0){
-            break;
-        }
-    }
+    // snapshot indices once, the reader may move them.
+    size_t remain = slcan_io_fifo_remain(fifo);
+    size_t count = MIN(data_size, remain);
+    size_t max_line_size = fifo->size - (slcan_fifo_index_load_relaxed(fifo->wptr) & fifo->mask);
+    size_t line_size = MIN(count, max_line_size);
+
+    memcpy(slcan_io_fifo_data_to_write(fifo), data, line_size);
+    // wrapped data.
+    memcpy(&fifo->buf[0], &data[line_size], count - line_size);
+
+    slcan_io_fifo_data_written(fifo, count);
+
     return count;
 }
 
@@ -84,25 +139,25 @@ bool slcan_io_fifo_write_block(slcan_io_fifo_t* fifo, const uint8_t* data, size_
 {
     if(slcan_io_fifo_remain(fifo) < data_size) return false;
 
-    size_t old_count = fifo->count;
-    size_t old_wptr = fifo->wptr;
+    slcan_io_fifo_write(fifo, data, data_size);
 
-    if(slcan_io_fifo_write(fifo, data, data_size) != data_size){
-        fifo->count = old_count;
-        fifo->wptr = old_wptr;
-        return false;
-    }
     return true;
 }
 
 size_t slcan_io_fifo_read(slcan_io_fifo_t* fifo, uint8_t* data, size_t data_size)
 {
-    size_t count;
-    for(count = 0; count < data_size; count ++){
-        if(slcan_io_fifo_get(fifo, &data[count]) == 0){
-            break;
-        }
-    }
+    // snapshot indices once, the writer may move them.
+    size_t avail = slcan_io_fifo_avail(fifo);
+    size_t count = MIN(data_size, avail);
+    size_t max_line_size = fifo->size - (slcan_fifo_index_load_relaxed(fifo->rptr) & fifo->mask);
+    size_t line_size = MIN(count, max_line_size);
+
+    memcpy(data, slcan_io_fifo_data_to_read(fifo), line_size);
+    // wrapped data.
+    memcpy(&data[line_size], &fifo->buf[0], count - line_size);
+
+    slcan_io_fifo_data_readed(fifo, count);
+
     return count;
 }
 
@@ -110,32 +165,19 @@ bool slcan_io_fifo_read_block(slcan_io_fifo_t* fifo, uint8_t* data, size_t data_
 {
     if(slcan_io_fifo_avail(fifo) < data_size) return false;
 
-    size_t old_count = fifo->count;
-    size_t old_rptr = fifo->rptr;
+    slcan_io_fifo_read(fifo, data, data_size);
 
-    if(slcan_io_fifo_read(fifo, data, data_size) != data_size){
-        fifo->count = old_count;
-        fifo->rptr = old_rptr;
-        return false;
-    }
     return true;
 }
 
 void slcan_io_fifo_data_readed(slcan_io_fifo_t* fifo, size_t data_size)
 {
-    fifo->count -= data_size;
-    fifo->rptr += data_size;
-    if(fifo->rptr >= SLCAN_IO_FIFO_SIZE){
-        fifo->rptr -= SLCAN_IO_FIFO_SIZE;
-    }
+    // publish free space to the writer.
+    slcan_fifo_index_store(fifo->rptr, slcan_fifo_index_load_relaxed(fifo->rptr) + data_size);
 }
 
 void slcan_io_fifo_data_written(slcan_io_fifo_t* fifo, size_t data_size)
 {
-    fifo->count += data_size;
-    fifo->wptr += data_size;
-    if(fifo->wptr >= SLCAN_IO_FIFO_SIZE){
-        fifo->wptr -= SLCAN_IO_FIFO_SIZE;
-    }
+    // publish written data to the reader.
+    slcan_fifo_index_store(fifo->wptr, slcan_fifo_index_load_relaxed(fifo->wptr) + data_size);
 }
-
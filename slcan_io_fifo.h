@@ -5,39 +5,91 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "slcan_defs.h"
+#include "slcan_err.h"
+#include "slcan_atomic.h"
 #include "slcan_conf.h"
 
 
-//! Количество данных.
+//! Количество данных во встроенном буфере.
 #ifndef SLCAN_IO_FIFO_SIZE
 #define SLCAN_IO_FIFO_SIZE SLCAN_IO_FIFO_DEFAULT_SIZE
 #endif
 
+#if (SLCAN_IO_FIFO_SIZE == 0) || ((SLCAN_IO_FIFO_SIZE & (SLCAN_IO_FIFO_SIZE - 1)) != 0)
+#error SLCAN_IO_FIFO_SIZE must be a power of two!
+#endif
+
 
 //! Тип фифо.
+//! При SLCAN_FIFO_SPSC == 1 фифо может использоваться
+//! одним пишущим и одним читающим потоком одновременно.
 typedef struct _Slcan_Io_Fifo {
-    uint8_t buf[SLCAN_IO_FIFO_SIZE]; //!< Данные.
-    size_t wptr; //!< Индекс для записи.
-    size_t rptr; //!< Индекс для чтения.
-    size_t count; //!< Количество данных.
+    uint8_t* buf; //!< Данные.
+    size_t size; //!< Размер буфера данных, степень двойки.
+    size_t mask; //!< Маска индексов.
+    slcan_fifo_index_t wptr SLCAN_FIFO_INDEX_ALIGN; //!< Свободно растущий индекс для записи.
+    slcan_fifo_index_t rptr SLCAN_FIFO_INDEX_ALIGN; //!< Свободно растущий индекс для чтения.
+    uint8_t default_buf[SLCAN_IO_FIFO_SIZE] SLCAN_FIFO_INDEX_ALIGN; //!< Встроенный буфер данных.
 } slcan_io_fifo_t;
 
+//! Структура непрерывного участка данных фифо.
+typedef struct _Slcan_Io_Fifo_Span {
+    uint8_t* data; //!< Данные.
+    size_t size; //!< Размер данных.
+} slcan_io_fifo_span_t;
+
+//! Максимальное число непрерывных участков данных фифо.
+#define SLCAN_IO_FIFO_SPANS_MAX 2
+
 
 /**
- * Инициализирует фифо.
+ * Инициализирует фифо со встроенным буфером.
  * @param fifo Фифо.
  */
 EXTERN void slcan_io_fifo_init(slcan_io_fifo_t* fifo);
 
+/**
+ * Проверяет буфер данных фифо.
+ * @param buf Буфер данных, NULL - встроенный буфер.
+ * @param size Размер буфера данных.
+ * @return Флаг допустимости буфера.
+ */
+ALWAYS_INLINE static bool slcan_io_fifo_buf_valid(const uint8_t* buf, size_t size)
+{
+    // built-in buffer.
+    if(buf == NULL) return true;
+
+    // size must be a power of two.
+    return size != 0 && (size & (size - 1)) == 0;
+}
+
+/**
+ * Инициализирует фифо с заданным буфером.
+ * @param fifo Фифо.
+ * @param buf Буфер данных, NULL - встроенный буфер.
+ * @param size Размер буфера данных, степень двойки.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_io_fifo_init_buf(slcan_io_fifo_t* fifo, uint8_t* buf, size_t size);
+
 /**
  * Сбрасывает фифо.
  * @param fifo Фифо.
  */
 ALWAYS_INLINE static void slcan_io_fifo_reset(slcan_io_fifo_t* fifo)
 {
-    fifo->wptr = 0;
-    fifo->rptr = 0;
-    fifo->count = 0;
+    slcan_fifo_index_store(fifo->wptr, 0);
+    slcan_fifo_index_store(fifo->rptr, 0);
+}
+
+/**
+ * Получает размер фифо.
+ * @param fifo Фифо.
+ * @return Размер фифо.
+ */
+ALWAYS_INLINE static size_t slcan_io_fifo_size(const slcan_io_fifo_t* fifo)
+{
+    return fifo->size;
 }
 
 /**
@@ -47,7 +99,7 @@ ALWAYS_INLINE static void slcan_io_fifo_reset(slcan_io_fifo_t* fifo)
  */
 ALWAYS_INLINE static uint8_t* slcan_io_fifo_data_to_read(slcan_io_fifo_t* fifo)
 {
-    return &fifo->buf[fifo->rptr];
+    return &fifo->buf[slcan_fifo_index_load_relaxed(fifo->rptr) & fifo->mask];
 }
 
 /**
@@ -57,7 +109,7 @@ ALWAYS_INLINE static uint8_t* slcan_io_fifo_data_to_read(slcan_io_fifo_t* fifo)
  */
 ALWAYS_INLINE static uint8_t* slcan_io_fifo_data_to_write(slcan_io_fifo_t* fifo)
 {
-    return &fifo->buf[fifo->wptr];
+    return &fifo->buf[slcan_fifo_index_load_relaxed(fifo->wptr) & fifo->mask];
 }
 
 /**
@@ -67,7 +119,7 @@ ALWAYS_INLINE static uint8_t* slcan_io_fifo_data_to_write(slcan_io_fifo_t* fifo)
  */
 ALWAYS_INLINE static size_t slcan_io_fifo_avail(const slcan_io_fifo_t* fifo)
 {
-    return fifo->count;
+    return slcan_fifo_index_load(fifo->wptr) - slcan_fifo_index_load(fifo->rptr);
 }
 
 /**
@@ -77,7 +129,7 @@ ALWAYS_INLINE static size_t slcan_io_fifo_avail(const slcan_io_fifo_t* fifo)
  */
 ALWAYS_INLINE static size_t slcan_io_fifo_remain(const slcan_io_fifo_t* fifo)
 {
-    return SLCAN_IO_FIFO_SIZE - fifo->count;
+    return fifo->size - slcan_io_fifo_avail(fifo);
 }
 
 /**
@@ -87,7 +139,7 @@ ALWAYS_INLINE static size_t slcan_io_fifo_remain(const slcan_io_fifo_t* fifo)
  */
 ALWAYS_INLINE static bool slcan_io_fifo_full(const slcan_io_fifo_t* fifo)
 {
-    return fifo->count == SLCAN_IO_FIFO_SIZE;
+    return slcan_io_fifo_avail(fifo) == fifo->size;
 }
 
 /**
@@ -97,7 +149,7 @@ ALWAYS_INLINE static bool slcan_io_fifo_full(const slcan_io_fifo_t* fifo)
  */
 ALWAYS_INLINE static bool slcan_io_fifo_empty(const slcan_io_fifo_t* fifo)
 {
-    return fifo->count == 0;
+    return slcan_io_fifo_avail(fifo) == 0;
 }
 
 /**
@@ -114,6 +166,24 @@ EXTERN size_t slcan_io_fifo_read_line_size(const slcan_io_fifo_t* fifo);
  */
 EXTERN size_t slcan_io_fifo_write_line_size(const slcan_io_fifo_t* fifo);
 
+/**
+ * Получает непрерывные участки данных для чтения из фифо.
+ * Чтение подтверждается вызовом slcan_io_fifo_data_readed.
+ * @param fifo Фифо.
+ * @param spans Массив из SLCAN_IO_FIFO_SPANS_MAX участков.
+ * @return Число участков данных, 0 - если фифо пустое.
+ */
+EXTERN size_t slcan_io_fifo_read_spans(slcan_io_fifo_t* fifo, slcan_io_fifo_span_t* spans);
+
+/**
+ * Получает свободные непрерывные участки для записи в фифо.
+ * Запись подтверждается вызовом slcan_io_fifo_data_written.
+ * @param fifo Фифо.
+ * @param spans Массив из SLCAN_IO_FIFO_SPANS_MAX участков.
+ * @return Число участков, 0 - если фифо полное.
+ */
+EXTERN size_t slcan_io_fifo_write_spans(slcan_io_fifo_t* fifo, slcan_io_fifo_span_t* spans);
+
 /**
  * Помещает данные в фифо.
  * @param fifo Фифо.
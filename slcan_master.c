@@ -10,6 +10,39 @@
 #include <assert.h>
 
 
+// Типы запросов настройки и открытия/закрытия CAN.
+static const uint8_t slcan_master_setup_types[] = {
+    SLCAN_CMD_SETUP_CAN_STD, SLCAN_CMD_SETUP_CAN_BTR, SLCAN_CMD_OPEN, SLCAN_CMD_LISTEN, SLCAN_CMD_CLOSE
+};
+
+// Типы запросов передачи сообщений CAN.
+static const uint8_t slcan_master_transmit_types[] = {
+    SLCAN_CMD_TRANSMIT, SLCAN_CMD_TRANSMIT_EXT, SLCAN_CMD_TRANSMIT_RTR, SLCAN_CMD_TRANSMIT_RTR_EXT
+};
+
+// Устанавливает тайм-аут запросов заданных типов.
+static void slcan_master_set_types_timeout_ns(slcan_master_t* scm, const uint8_t* types, size_t count, uint64_t timeout_ns)
+{
+    size_t i;
+
+    for(i = 0; i < count; i ++){
+        scm->timeouts_ns[types[i]] = timeout_ns;
+    }
+}
+
+// Получает тайм-аут запроса, нс.
+ALWAYS_INLINE static uint64_t slcan_master_type_timeout_ns(const slcan_master_t* scm, slcan_cmd_type_t type)
+{
+    return scm->timeouts_ns[(unsigned int)type % SLCAN_MASTER_CMD_TYPES_COUNT];
+}
+
+// Получает текущее время, нс - снимок цикла обработки
+// или время источника вне цикла.
+ALWAYS_INLINE static uint64_t slcan_master_now_ns(const slcan_master_t* scm)
+{
+    return slcan_now_ns(scm->sc);
+}
+
 slcan_err_t slcan_master_init(slcan_master_t* scm, slcan_t* sc)
 {
     assert(scm != NULL);
@@ -21,11 +54,27 @@ slcan_err_t slcan_master_init(slcan_master_t* scm, slcan_t* sc)
 
     slcan_resp_out_fifo_init(&scm->respoutfifo);
 
+    scm->window.adaptive = SLCAN_MASTER_WINDOW_ADAPTIVE_DEFAULT;
+    scm->window.limited = false;
+    scm->window.acks = 0;
+    scm->window.rtt_min_ns = 0;
+    scm->window.rtt_ns = 0;
+
     slcan_can_ext_fifo_init(&scm->rxcanfifo);
     slcan_can_fifo_init(&scm->txcanfifo);
 
+    slcan_timer_wheel_init(&scm->timers);
+
     scm->tp_timeout.tv_sec = SLCAN_MASTER_TIMEOUT_S_DEFAULT;
     scm->tp_timeout.tv_nsec = SLCAN_MASTER_TIMEOUT_NS_DEFAULT;
+    slcan_master_set_timeout(scm, &scm->tp_timeout);
+
+    // slow setup requests.
+    slcan_master_set_types_timeout_ns(scm, slcan_master_setup_types, sizeof(slcan_master_setup_types),
+            (uint64_t)SLCAN_MASTER_SETUP_TIMEOUT_S_DEFAULT * 1000000000ULL + SLCAN_MASTER_SETUP_TIMEOUT_NS_DEFAULT);
+    // fast transmit requests.
+    slcan_master_set_types_timeout_ns(scm, slcan_master_transmit_types, sizeof(slcan_master_transmit_types),
+            (uint64_t)SLCAN_MASTER_TRANSMIT_TIMEOUT_S_DEFAULT * 1000000000ULL + SLCAN_MASTER_TRANSMIT_TIMEOUT_NS_DEFAULT);
 
     return E_SLCAN_NO_ERROR;
 }
@@ -55,12 +104,128 @@ slcan_err_t slcan_master_set_timeout(slcan_master_t* scm, const struct timespec*
 
     if(tp_timeout == NULL) return E_SLCAN_NULL_POINTER;
 
+    uint64_t timeout_ns = slcan_timespec_to_ns(tp_timeout);
+    size_t i;
+
     scm->tp_timeout.tv_sec = tp_timeout->tv_sec;
     scm->tp_timeout.tv_nsec = tp_timeout->tv_nsec;
 
+    for(i = 0; i < SLCAN_MASTER_CMD_TYPES_COUNT; i ++){
+        scm->timeouts_ns[i] = timeout_ns;
+    }
+
     return E_SLCAN_NO_ERROR;
 }
 
+slcan_err_t slcan_master_cmd_timeout(const slcan_master_t* scm, slcan_cmd_type_t type, struct timespec* tp_timeout)
+{
+    assert(scm != NULL);
+
+    if(tp_timeout == NULL) return E_SLCAN_NULL_POINTER;
+    if((unsigned int)type >= SLCAN_MASTER_CMD_TYPES_COUNT) return E_SLCAN_INVALID_VALUE;
+
+    uint64_t timeout_ns = scm->timeouts_ns[type];
+
+    tp_timeout->tv_sec = (time_t)(timeout_ns / 1000000000ULL);
+    tp_timeout->tv_nsec = (long)(timeout_ns % 1000000000ULL);
+
+    return E_SLCAN_NO_ERROR;
+}
+
+slcan_err_t slcan_master_set_cmd_timeout(slcan_master_t* scm, slcan_cmd_type_t type, const struct timespec* tp_timeout)
+{
+    assert(scm != NULL);
+
+    if(tp_timeout == NULL) return E_SLCAN_NULL_POINTER;
+    if((unsigned int)type >= SLCAN_MASTER_CMD_TYPES_COUNT) return E_SLCAN_INVALID_VALUE;
+
+    scm->timeouts_ns[type] = slcan_timespec_to_ns(tp_timeout);
+
+    return E_SLCAN_NO_ERROR;
+}
+
+slcan_err_t slcan_master_set_resp_buffer(slcan_master_t* scm, slcan_resp_out_t* buf, size_t size)
+{
+    assert(scm != NULL);
+
+    if(!slcan_resp_out_fifo_empty(&scm->respoutfifo)) return E_SLCAN_STATE;
+
+    return slcan_resp_out_fifo_init_buf(&scm->respoutfifo, buf, size);
+}
+
+size_t slcan_master_window(const slcan_master_t* scm)
+{
+    assert(scm != NULL);
+
+    return slcan_resp_out_fifo_window(&scm->respoutfifo);
+}
+
+void slcan_master_set_window(slcan_master_t* scm, size_t window)
+{
+    assert(scm != NULL);
+
+    slcan_resp_out_fifo_set_window(&scm->respoutfifo, window);
+
+    scm->window.acks = 0;
+}
+
+bool slcan_master_window_adaptive(const slcan_master_t* scm)
+{
+    assert(scm != NULL);
+
+    return scm->window.adaptive;
+}
+
+void slcan_master_set_window_adaptive(slcan_master_t* scm, bool adaptive)
+{
+    assert(scm != NULL);
+
+    scm->window.adaptive = adaptive;
+    scm->window.limited = false;
+    scm->window.acks = 0;
+    scm->window.rtt_min_ns = 0;
+    scm->window.rtt_ns = 0;
+}
+
+// Учитывает ответ на запрос в адаптивном окне.
+static void slcan_master_window_ack(slcan_master_t* scm, const slcan_resp_out_t* resp_out)
+{
+    slcan_master_window_t* wnd = &scm->window;
+    size_t window = slcan_resp_out_fifo_window(&scm->respoutfifo);
+    uint64_t cur_ns, rtt_ns;
+
+    if(!wnd->adaptive) return;
+
+    // one round - one window of answers.
+    if(++ wnd->acks < window) return;
+    wnd->acks = 0;
+
+    cur_ns = slcan_master_now_ns(scm);
+    rtt_ns = (cur_ns > resp_out->sent_ns) ? cur_ns - resp_out->sent_ns : 0;
+
+    if(wnd->rtt_min_ns == 0 || rtt_ns < wnd->rtt_min_ns) wnd->rtt_min_ns = rtt_ns;
+    wnd->rtt_ns = (wnd->rtt_ns == 0) ? rtt_ns : wnd->rtt_ns - wnd->rtt_ns / 4 + rtt_ns / 4;
+
+    // the window limits sending and the link is not queued - grow.
+    if(wnd->limited && wnd->rtt_ns <= 2 * wnd->rtt_min_ns){
+        slcan_resp_out_fifo_set_window(&scm->respoutfifo, window + 1);
+    }
+    wnd->limited = false;
+}
+
+// Уменьшает адаптивное окно при тайм-аутах запросов.
+static void slcan_master_window_timeout(slcan_master_t* scm)
+{
+    slcan_master_window_t* wnd = &scm->window;
+
+    if(!wnd->adaptive) return;
+
+    slcan_resp_out_fifo_set_window(&scm->respoutfifo, slcan_resp_out_fifo_window(&scm->respoutfifo) / 2);
+
+    wnd->limited = false;
+    wnd->acks = 0;
+}
+
 bool slcan_master_no_answers(const slcan_master_t* scm)
 {
     return scm->no_answers;
@@ -85,6 +250,36 @@ ALWAYS_INLINE static void slcan_master_future_end(slcan_future_t* future, slcan_
     }
 }
 
+// Получает флаг запроса передачи сообщения CAN.
+ALWAYS_INLINE static bool slcan_master_req_is_transmit(slcan_cmd_type_t req_type)
+{
+    return req_type == SLCAN_CMD_TRANSMIT || req_type == SLCAN_CMD_TRANSMIT_EXT ||
+           req_type == SLCAN_CMD_TRANSMIT_RTR || req_type == SLCAN_CMD_TRANSMIT_RTR_EXT;
+}
+
+// Завершает будущее запроса.
+// Общее будущее группы завершается последним запросом группы
+// с первой ошибкой запросов группы.
+static void slcan_master_resp_out_end(const slcan_resp_out_t* resp_out, slcan_err_t res_err)
+{
+    slcan_future_t* future = resp_out->future;
+    slcan_err_t group_err;
+
+    if(future == NULL) return;
+
+    if(slcan_master_req_is_transmit(resp_out->req_type) && resp_out->transmit.group){
+        group_err = SLCAN_FUTURE_RESULT_ERR(slcan_future_result(future));
+        if(group_err != E_SLCAN_NO_ERROR) res_err = group_err;
+
+        if(!resp_out->transmit.group_last){
+            slcan_future_set_result(future, SLCAN_FUTURE_RESULT(res_err));
+            return;
+        }
+    }
+
+    slcan_future_finish(future, SLCAN_FUTURE_RESULT(res_err));
+}
+
 static slcan_err_t slcan_master_process_resp_transmit(slcan_master_t* scm, slcan_resp_out_t* resp_out, slcan_cmd_t* cmd)
 {
     assert(scm != NULL);
@@ -97,7 +292,7 @@ static slcan_err_t slcan_master_process_resp_transmit(slcan_master_t* scm, slcan
         err = E_SLCAN_OVERRUN;
     }
 
-    if(resp_out != NULL) slcan_master_future_end(resp_out->future, err);
+    if(resp_out != NULL) slcan_master_resp_out_end(resp_out, err);
 
     return err;
 }
@@ -117,7 +312,7 @@ static slcan_err_t slcan_master_process_resp_poll_all(slcan_master_t* scm, slcan
         res_err = E_SLCAN_EXEC_FAIL;
     }
 
-    slcan_master_future_end(resp_out->future, res_err);
+    slcan_master_resp_out_end(resp_out, res_err);
 
     return res_err;
 }
@@ -137,7 +332,7 @@ static slcan_err_t slcan_master_process_resp_ok_fail(slcan_master_t* scm, slcan_
         res_err = E_SLCAN_EXEC_FAIL;
     }
 
-    slcan_master_future_end(resp_out->future, res_err);
+    slcan_master_resp_out_end(resp_out, res_err);
 
     return res_err;
 }
@@ -161,7 +356,7 @@ static slcan_err_t slcan_master_process_resp_ok_fail_autopoll(slcan_master_t* sc
         res_err = E_SLCAN_EXEC_FAIL;
     }
 
-    slcan_master_future_end(resp_out->future, res_err);
+    slcan_master_resp_out_end(resp_out, res_err);
 
     return res_err;
 }
@@ -185,7 +380,7 @@ static slcan_err_t slcan_master_process_resp_status(slcan_master_t* scm, slcan_r
         res_err = E_SLCAN_EXEC_FAIL;
     }
 
-    slcan_master_future_end(resp_out->future, res_err);
+    slcan_master_resp_out_end(resp_out, res_err);
 
     return res_err;
 }
@@ -212,7 +407,7 @@ static slcan_err_t slcan_master_process_resp_version(slcan_master_t* scm, slcan_
         res_err = E_SLCAN_EXEC_FAIL;
     }
 
-    slcan_master_future_end(resp_out->future, res_err);
+    slcan_master_resp_out_end(resp_out, res_err);
 
     return res_err;
 }
@@ -236,11 +431,25 @@ static slcan_err_t slcan_master_process_resp_sn(slcan_master_t* scm, slcan_resp_
         res_err = E_SLCAN_EXEC_FAIL;
     }
 
-    slcan_master_future_end(resp_out->future, res_err);
+    slcan_master_resp_out_end(resp_out, res_err);
 
     return res_err;
 }
 
+// Удаляет первый запрос из фифо и его срок из колеса.
+static void slcan_master_resp_out_remove(slcan_master_t* scm)
+{
+    slcan_resp_out_t* head = slcan_resp_out_fifo_head(&scm->respoutfifo);
+
+    if(head == NULL) return;
+
+    if(slcan_timer_pending(&head->timer)){
+        slcan_timer_wheel_del(&scm->timers, &head->timer);
+    }
+
+    slcan_resp_out_fifo_data_readed(&scm->respoutfifo, 1);
+}
+
 static slcan_err_t slcan_master_process_result(slcan_master_t* scm, slcan_cmd_t* cmd)
 {
     assert(scm != NULL);
@@ -267,8 +476,22 @@ static slcan_err_t slcan_master_process_result(slcan_master_t* scm, slcan_cmd_t*
 
     slcan_cmd_type_t req_type = resp_out.req_type;
 
+    // auto polled message before the answer to the request,
+    // the request is still waiting for its answer.
+    if(res_cmd_is_transmit && req_type != SLCAN_CMD_POLL && req_type != SLCAN_CMD_POLL_ALL){
+        return slcan_master_process_resp_transmit(scm, NULL, cmd);
+    }
+
     if(!res_cmd_is_transmit || req_type == SLCAN_CMD_POLL){
-        slcan_resp_out_fifo_data_readed(&scm->respoutfifo, 1);
+        slcan_master_resp_out_remove(scm);
+
+        // late answer - future is already done.
+        if(resp_out.expired){
+            if(res_cmd_is_transmit) return slcan_master_process_resp_transmit(scm, NULL, cmd);
+            return E_SLCAN_NO_ERROR;
+        }
+
+        slcan_master_window_ack(scm, &resp_out);
     }
 
     switch(req_type){
@@ -313,7 +536,33 @@ static slcan_err_t slcan_master_process_result(slcan_master_t* scm, slcan_cmd_t*
     return E_SLCAN_NO_ERROR;
 }
 
-static slcan_err_t slcan_master_send_request(slcan_master_t* scm, slcan_cmd_t* cmd, slcan_resp_out_t* resp_out)
+// Помещает запрос в фифо и его срок в колесо.
+static bool slcan_master_resp_out_put(slcan_master_t* scm, const slcan_resp_out_t* resp_out, uint64_t timeout_ns)
+{
+    slcan_resp_out_t* tail;
+
+    if(slcan_resp_out_fifo_put(&scm->respoutfifo, resp_out) == 0) return false;
+
+    tail = slcan_resp_out_fifo_tail(&scm->respoutfifo);
+
+    slcan_timer_init(&tail->timer);
+    slcan_timer_wheel_add(&scm->timers, &tail->timer, resp_out->sent_ns + timeout_ns, resp_out->sent_ns);
+
+    return true;
+}
+
+// Удаляет последний запрос из фифо и его срок из колеса.
+static void slcan_master_resp_out_unput(slcan_master_t* scm)
+{
+    slcan_resp_out_t* tail = slcan_resp_out_fifo_tail(&scm->respoutfifo);
+
+    if(tail == NULL) return;
+
+    slcan_timer_wheel_del(&scm->timers, &tail->timer);
+    slcan_resp_out_fifo_unput(&scm->respoutfifo);
+}
+
+static slcan_err_t slcan_master_send_request_timeout(slcan_master_t* scm, const slcan_cmd_t* cmd, slcan_resp_out_t* resp_out, uint64_t timeout_ns)
 {
     assert(scm != 0);
 
@@ -325,11 +574,12 @@ static slcan_err_t slcan_master_send_request(slcan_master_t* scm, slcan_cmd_t* c
 
     slcan_err_t err;
 
-    slcan_clock_gettime(&resp_out->tp_req);
-    slcan_timespec_add(&resp_out->tp_req, &scm->tp_timeout, &resp_out->tp_req);
+    resp_out->sent_ns = slcan_master_now_ns(scm);
+    resp_out->expired = false;
 
     if(!scm->no_answers){
-        if(slcan_resp_out_fifo_put(&scm->respoutfifo, resp_out) == 0){
+        if(!slcan_master_resp_out_put(scm, resp_out, timeout_ns)){
+            scm->window.limited = true;
             return E_SLCAN_OVERRUN;
         }
     }
@@ -337,17 +587,26 @@ static slcan_err_t slcan_master_send_request(slcan_master_t* scm, slcan_cmd_t* c
     err = slcan_put_cmd(scm->sc, cmd);
     if(err != E_SLCAN_NO_ERROR){
         // remove from resp out queue.
-        slcan_resp_out_fifo_unput(&scm->respoutfifo);
+        if(!scm->no_answers) slcan_master_resp_out_unput(scm);
         return err;
     }
 
     if(scm->no_answers){
-        slcan_master_future_end(resp_out->future, E_SLCAN_NO_ERROR);
+        slcan_master_resp_out_end(resp_out, E_SLCAN_NO_ERROR);
     }
 
     return E_SLCAN_NO_ERROR;
 }
 
+static slcan_err_t slcan_master_send_request(slcan_master_t* scm, const slcan_cmd_t* cmd, slcan_resp_out_t* resp_out)
+{
+    assert(scm != 0);
+
+    if(cmd == NULL) return E_SLCAN_NULL_POINTER;
+
+    return slcan_master_send_request_timeout(scm, cmd, resp_out, slcan_master_type_timeout_ns(scm, cmd->type));
+}
+
 static slcan_err_t slcan_master_send_can_msg_req(slcan_master_t* scm, slcan_can_msg_t* can_msg, slcan_future_t* future)
 {
     assert(scm != NULL);
@@ -369,6 +628,8 @@ static slcan_err_t slcan_master_send_can_msg_req(slcan_master_t* scm, slcan_can_
 
     resp_out.req_type = cmd.type;
     resp_out.future = future;
+    resp_out.transmit.group = false;
+    resp_out.transmit.group_last = false;
 
     slcan_err_t err = slcan_master_send_request(scm, &cmd, &resp_out);
     if(err != E_SLCAN_NO_ERROR) return err;
@@ -409,112 +670,186 @@ static void slcan_master_process_timeouts(slcan_master_t* scm)
 {
     assert(scm != NULL);
 
-    slcan_resp_out_t resp_out;
-    struct timespec tp_cur;
-
-    slcan_clock_gettime(&tp_cur);
-
-    while(slcan_resp_out_fifo_peek(&scm->respoutfifo, &resp_out)){
-        // if timeout.
-        if(slcan_timespec_cmp(&resp_out.tp_req, &tp_cur, <)){
-            // remove msg from fifo.
-            slcan_resp_out_fifo_data_readed(&scm->respoutfifo, 1);
-            // future done.
-            slcan_master_future_end(resp_out.future, E_SLCAN_TIMEOUT);
-            // next msg.
-            continue;
+    slcan_resp_out_t* resp_out;
+    slcan_timer_t* timer;
+    uint64_t now_ns = slcan_master_now_ns(scm);
+    bool timedout = false;
+
+    // requests in order of deadlines.
+    while((timer = slcan_timer_wheel_expire(&scm->timers, now_ns)) != NULL){
+        resp_out = (slcan_resp_out_t*)((uint8_t*)timer - offsetof(slcan_resp_out_t, timer));
+        resp_out->expired = true;
+        // future done.
+        slcan_master_resp_out_end(resp_out, E_SLCAN_TIMEOUT);
+        timedout = true;
+    }
+
+    // answers are matched in order of requests,
+    // expired requests are removed from the head only.
+    while((resp_out = slcan_resp_out_fifo_head(&scm->respoutfifo)) != NULL && resp_out->expired){
+        slcan_resp_out_fifo_data_readed(&scm->respoutfifo, 1);
+    }
+
+    // shrink the window once per timed out batch.
+    if(timedout) slcan_master_window_timeout(scm);
+}
+
+// Обрабатывает полученные ответы, тайм-ауты и отправку сообщений.
+static slcan_err_t slcan_master_process_cycle(slcan_master_t* scm)
+{
+    slcan_err_t err, get_err, process_err;
+    slcan_cmd_t cmds[SLCAN_CMDS_BATCH_SIZE];
+    size_t i, n;
+
+    for(;;){
+        get_err = slcan_get_cmds(scm->sc, cmds, SLCAN_CMDS_BATCH_SIZE, &n);
+
+        // received commands are processed anyway,
+        // the first error is returned after the batch.
+        process_err = E_SLCAN_NO_ERROR;
+        for(i = 0; i < n; i ++){
+            err = slcan_master_process_result(scm, &cmds[i]);
+            // failed response - in future result.
+            if(err != E_SLCAN_NO_ERROR && err != E_SLCAN_EXEC_FAIL &&
+               process_err == E_SLCAN_NO_ERROR){
+                process_err = err;
+            }
         }
-        // done.
-        break;
+        if(process_err != E_SLCAN_NO_ERROR) return process_err;
+
+        // commands fifo empty.
+        if(get_err == E_SLCAN_UNDERFLOW || get_err == E_SLCAN_UNDERRUN) break;
+        if(get_err != E_SLCAN_NO_ERROR) return get_err;
+        // all commands processed.
+        if(n < SLCAN_CMDS_BATCH_SIZE) break;
     }
+
+    slcan_master_process_timeouts(scm);
+
+    err = slcan_master_send_existing_can_msgs(scm);
+    if(err != E_SLCAN_NO_ERROR) return err;
+
+    return E_SLCAN_NO_ERROR;
 }
 
-slcan_err_t slcan_master_poll(slcan_master_t* scm)
+slcan_err_t slcan_master_process(slcan_master_t* scm)
 {
     assert(scm != 0);
 
+    if(scm->sc == NULL) return E_SLCAN_NULL_POINTER;
+
     slcan_err_t err;
 
+    // one clock read per cycle.
+    slcan_update_now(scm->sc);
+
+    err = slcan_master_process_cycle(scm);
+
+    slcan_release_now(scm->sc);
+
+    return err;
+}
+
+slcan_err_t slcan_master_poll(slcan_master_t* scm)
+{
+    assert(scm != 0);
+
 #if defined(SLCAN_MASTER_POLL_SLCAN) && SLCAN_MASTER_POLL_SLCAN == 1
+    slcan_err_t err;
+
     err = slcan_poll(scm->sc);
     if(err != E_SLCAN_NO_ERROR) return err;
 #endif
 
-    slcan_cmd_t cmd;
+    return slcan_master_process(scm);
+}
 
-    for(;;){
-        err = slcan_get_cmd(scm->sc, &cmd);
-        // commands fifo empty.
-        if(err == E_SLCAN_UNDERFLOW || err == E_SLCAN_UNDERRUN) break;
-        if(err != E_SLCAN_NO_ERROR) return err;
+bool slcan_master_next_timeout(slcan_master_t* scm, struct timespec* tp_timeout)
+{
+    assert(scm != 0);
 
-        err = slcan_master_process_result(scm, &cmd);
-        if(err != E_SLCAN_NO_ERROR){
-            // failed response - in future result.
-            if(err != E_SLCAN_EXEC_FAIL){
-                return err;
-            }
+    if(tp_timeout == NULL) return false;
+
+    uint64_t deadline_ns, now_ns, wait_ns = 0;
+
+    if(!slcan_timer_wheel_next(&scm->timers, &deadline_ns)) return false;
+
+    now_ns = slcan_master_now_ns(scm);
+    if(deadline_ns > now_ns) wait_ns = deadline_ns - now_ns;
+
+    tp_timeout->tv_sec = (time_t)(wait_ns / 1000000000ULL);
+    tp_timeout->tv_nsec = (long)(wait_ns % 1000000000ULL);
+
+    return true;
+}
+
+slcan_err_t slcan_master_wait(slcan_master_t* scm, const struct timespec* tp_timeout)
+{
+    assert(scm != 0);
+
+    slcan_err_t err;
+    struct timespec tp_wait;
+    const struct timespec* p_tp_wait = tp_timeout;
+
+    // wait not longer than the nearest request timeout.
+    if(slcan_master_next_timeout(scm, &tp_wait)){
+        if(p_tp_wait == NULL || slcan_timespec_cmp(&tp_wait, p_tp_wait, <)){
+            p_tp_wait = &tp_wait;
         }
     }
 
-    slcan_master_process_timeouts(scm);
-
-    err = slcan_master_send_existing_can_msgs(scm);
+    err = slcan_wait(scm->sc, p_tp_wait);
     if(err != E_SLCAN_NO_ERROR) return err;
 
-    return E_SLCAN_NO_ERROR;
+    return slcan_master_process(scm);
 }
 
 slcan_err_t slcan_master_flush(slcan_master_t* scm, struct timespec* tp_timeout)
 {
     assert(scm != 0);
 
-    struct timespec tp_end, tp_cur;
-    struct timespec tp_flush, *p_tp_flush;
+    struct timespec tp_end, tp_cur, tp_wait;
+    struct timespec* p_tp_wait = NULL;
 
     if(tp_timeout){
         slcan_clock_gettime(&tp_cur);
         slcan_timespec_add(&tp_cur, tp_timeout, &tp_end);
-        tp_flush.tv_sec = tp_timeout->tv_sec;
-        tp_flush.tv_nsec = tp_timeout->tv_nsec;
-        p_tp_flush = &tp_flush;
     }else{
         tp_end.tv_sec = 0;
         tp_end.tv_nsec = 0;
-    	tp_flush.tv_sec = 0;
-    	tp_flush.tv_nsec = 0;
-    	p_tp_flush = NULL;
     }
 
     slcan_err_t err;
 
     while(!slcan_resp_out_fifo_empty(&scm->respoutfifo)){
+        if(tp_timeout){
+            slcan_clock_gettime(&tp_cur);
+            slcan_timespec_remain(&tp_end, &tp_cur, &tp_wait);
+            p_tp_wait = &tp_wait;
+        }
 
-        err = slcan_flush(scm->sc, p_tp_flush);
-        if(err != E_SLCAN_NO_ERROR) return err;
-
-        err = slcan_master_poll(scm);
+        // send requests and wait for responses.
+        err = slcan_master_wait(scm, p_tp_wait);
         if(err != E_SLCAN_OVERFLOW && err != E_SLCAN_OVERRUN){
-        	if(err != E_SLCAN_NO_ERROR) return err;
+            if(err != E_SLCAN_NO_ERROR) return err;
         }
 
-        if(tp_timeout){
+        if(tp_timeout && !slcan_resp_out_fifo_empty(&scm->respoutfifo)){
             slcan_clock_gettime(&tp_cur);
 
-            if(slcan_timespec_cmp(&tp_cur, &tp_end, >)){
+            if(!slcan_timespec_cmp(&tp_cur, &tp_end, <)){
                 return E_SLCAN_TIMEOUT;
             }
         }
-
-		if(p_tp_flush){
-			slcan_timespec_sub(&tp_end, &tp_cur, p_tp_flush);
-		}
     }
 
-    err = slcan_flush(scm->sc, p_tp_flush);
-    if(err != E_SLCAN_NO_ERROR) return err;
+    if(tp_timeout){
+        slcan_clock_gettime(&tp_cur);
+        slcan_timespec_remain(&tp_end, &tp_cur, &tp_wait);
+        p_tp_wait = &tp_wait;
+    }
 
-    return E_SLCAN_NO_ERROR;
+    return slcan_flush(scm->sc, p_tp_wait);
 }
 
 static void slcan_master_finish_all_reqs(slcan_master_t* scm)
@@ -522,8 +857,10 @@ static void slcan_master_finish_all_reqs(slcan_master_t* scm)
     slcan_resp_out_t resp_out;
 
     while(slcan_resp_out_fifo_get(&scm->respoutfifo, &resp_out) != 0){
-        slcan_master_future_end(resp_out.future, E_SLCAN_CANCELED);
+        if(!resp_out.expired) slcan_master_resp_out_end(&resp_out, E_SLCAN_CANCELED);
     }
+
+    slcan_timer_wheel_init(&scm->timers);
 }
 
 void slcan_master_reset(slcan_master_t* scm)
@@ -536,6 +873,9 @@ void slcan_master_reset(slcan_master_t* scm)
 
     // finish all reqs.
     slcan_master_finish_all_reqs(scm);
+    // new round of the window.
+    scm->window.limited = false;
+    scm->window.acks = 0;
     // reset req fifo.
     // cleared in slcan_master_finish_all_reqs(...).
     //slcan_resp_out_fifo_reset(&scm->respoutfifo);
@@ -766,6 +1106,34 @@ slcan_err_t slcan_master_cmd_setup_uart(slcan_master_t* scm, slcan_port_baud_t b
     cmd.type = SLCAN_CMD_SETUP_UART;
     cmd.mode = SLCAN_CMD_MODE_REQUEST;
     cmd.setup_uart.baud = baud;
+    cmd.setup_uart.baud_rate = 0;
+
+    resp_out.req_type = cmd.type;
+    resp_out.future = future;
+
+    slcan_master_future_start(future);
+
+    slcan_err_t err = slcan_master_send_request(scm, &cmd, &resp_out);
+    if(err != E_SLCAN_NO_ERROR){
+        slcan_master_future_end(future, err);
+    }
+
+    return err;
+}
+
+slcan_err_t slcan_master_cmd_setup_uart_custom(slcan_master_t* scm, uint32_t baud_rate, slcan_future_t* future)
+{
+    assert(scm != 0);
+
+    if(baud_rate == 0) return E_SLCAN_INVALID_VALUE;
+
+    slcan_cmd_t cmd;
+    slcan_resp_out_t resp_out;
+
+    cmd.type = SLCAN_CMD_SETUP_UART;
+    cmd.mode = SLCAN_CMD_MODE_REQUEST;
+    cmd.setup_uart.baud = SLCAN_PORT_BAUD_CUSTOM;
+    cmd.setup_uart.baud_rate = baud_rate;
 
     resp_out.req_type = cmd.type;
     resp_out.future = future;
@@ -901,6 +1269,33 @@ slcan_err_t slcan_master_cmd_set_acceptance_filter(slcan_master_t* scm, uint32_t
     return err;
 }
 
+slcan_err_t slcan_master_request(slcan_master_t* scm, const slcan_cmd_t* cmd, const struct timespec* tp_timeout, slcan_future_t* future)
+{
+    assert(scm != NULL);
+
+    if(cmd == NULL) return E_SLCAN_NULL_POINTER;
+
+    slcan_resp_out_t resp_out;
+    uint64_t timeout_ns;
+
+    // no pointers for answers data.
+    memset(&resp_out, 0x0, sizeof(slcan_resp_out_t));
+
+    resp_out.req_type = cmd->type;
+    resp_out.future = future;
+
+    timeout_ns = tp_timeout ? slcan_timespec_to_ns(tp_timeout) : slcan_master_type_timeout_ns(scm, cmd->type);
+
+    slcan_master_future_start(future);
+
+    slcan_err_t err = slcan_master_send_request_timeout(scm, cmd, &resp_out, timeout_ns);
+    if(err != E_SLCAN_NO_ERROR){
+        slcan_master_future_end(future, err);
+    }
+
+    return err;
+}
+
 slcan_err_t slcan_master_send_can_msg(slcan_master_t* scm, slcan_can_msg_t* can_msg, slcan_future_t* future)
 {
     assert(scm != NULL);
@@ -929,6 +1324,100 @@ slcan_err_t slcan_master_send_can_msg(slcan_master_t* scm, slcan_can_msg_t* can_
     return E_SLCAN_NO_ERROR;
 }
 
+slcan_err_t slcan_master_send_can_msgs(slcan_master_t* scm, const slcan_can_msg_t* can_msgs, size_t count, size_t* sent, slcan_future_t* future)
+{
+    assert(scm != NULL);
+
+    if(can_msgs == NULL) return E_SLCAN_NULL_POINTER;
+    if(sent == NULL) return E_SLCAN_NULL_POINTER;
+
+    slcan_err_t err;
+    slcan_resp_out_t resp_out;
+    size_t max, n, i;
+    uint64_t timeout_ns = 0;
+
+    *sent = 0;
+
+    slcan_master_future_start(future);
+    // the first error of the group.
+    if(future) slcan_future_set_result(future, SLCAN_FUTURE_RESULT(E_SLCAN_NO_ERROR));
+
+    if(!slcan_opened(scm->sc)){
+        slcan_master_future_end(future, E_SLCAN_STATE);
+        return E_SLCAN_STATE;
+    }
+
+    if(count == 0){
+        slcan_master_future_end(future, E_SLCAN_NO_ERROR);
+        return E_SLCAN_NO_ERROR;
+    }
+
+    // keep order with queued msgs.
+    if(!slcan_can_fifo_empty(&scm->txcanfifo)){
+        err = slcan_master_send_existing_can_msgs(scm);
+        if(err != E_SLCAN_NO_ERROR){
+            slcan_master_future_end(future, err);
+            return err;
+        }
+    }
+
+    // admission by free requests slots.
+    max = count;
+    if(!scm->no_answers){
+        if(slcan_resp_out_fifo_remain(&scm->respoutfifo) < count){
+            scm->window.limited = true;
+        }
+        max = MIN(max, slcan_resp_out_fifo_remain(&scm->respoutfifo));
+        if(max == 0){
+            slcan_master_future_end(future, E_SLCAN_OVERRUN);
+            return E_SLCAN_OVERRUN;
+        }
+    }
+
+    // send valid msgs only.
+    for(i = 0; i < max; i ++){
+        if(slcan_cmd_type_for_can_msg(&can_msgs[i]) == SLCAN_CMD_UNKNOWN) break;
+    }
+    if(i == 0){
+        slcan_master_future_end(future, E_SLCAN_INVALID_DATA);
+        return E_SLCAN_INVALID_DATA;
+    }
+    max = i;
+
+    err = slcan_put_can_msgs(scm->sc, can_msgs, max, &n);
+    if(n == 0){
+        slcan_master_future_end(future, err);
+        return err;
+    }
+
+    *sent = n;
+
+    if(scm->no_answers){
+        slcan_master_future_end(future, E_SLCAN_NO_ERROR);
+        return E_SLCAN_NO_ERROR;
+    }
+
+    // the same deadline for the whole group.
+    for(i = 0; i < n; i ++){
+        timeout_ns = MAX(timeout_ns, slcan_master_type_timeout_ns(scm, slcan_cmd_type_for_can_msg(&can_msgs[i])));
+    }
+
+    resp_out.sent_ns = slcan_master_now_ns(scm);
+    resp_out.expired = false;
+    resp_out.future = future;
+    resp_out.transmit.group = future != NULL;
+
+    for(i = 0; i < n; i ++){
+        resp_out.req_type = slcan_cmd_type_for_can_msg(&can_msgs[i]);
+        resp_out.transmit.group_last = (i == n - 1);
+
+        // +1 ns per msg - the group expires in order of msgs.
+        slcan_master_resp_out_put(scm, &resp_out, timeout_ns + i);
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
 slcan_err_t slcan_master_recv_can_msg(slcan_master_t* scm, slcan_can_msg_t* can_msg, slcan_can_msg_extdata_t* extdata)
 {
     assert(scm != NULL);
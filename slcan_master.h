@@ -6,9 +6,14 @@
 #include "slcan_can_fifo.h"
 #include "slcan_can_ext_fifo.h"
 #include "slcan_slave_status.h"
+#include "slcan_timer_wheel.h"
 #include "slcan_conf.h"
 
 
+//! Размер таблицы тайм-аутов по типам запросов.
+#define SLCAN_MASTER_CMD_TYPES_COUNT 128
+
+
 // Тип структуры будущего.
 typedef struct _Slcan_Future slcan_future_t;
 
@@ -16,13 +21,25 @@ typedef struct _Slcan_Future slcan_future_t;
 struct timespec;
 
 
+//! Структура адаптивного окна запросов.
+typedef struct _Slcan_Master_Window {
+    bool adaptive; //!< Флаг адаптивного размера окна.
+    bool limited; //!< Флаг ограничения отправки окном в текущем раунде.
+    size_t acks; //!< Число ответов в текущем раунде.
+    uint64_t rtt_min_ns; //!< Наименьшее время приёма-передачи, нс.
+    uint64_t rtt_ns; //!< Сглаженное время приёма-передачи, нс.
+} slcan_master_window_t;
+
 //! Структура ведущего устройства.
 typedef struct _Slcan_Master {
     slcan_t* sc; //!< Последовательный интерфейс.
     slcan_resp_out_fifo_t respoutfifo; //!< Фифо запросов.
+    slcan_master_window_t window; //!< Адаптивное окно запросов.
+    slcan_timer_wheel_t timers; //!< Колесо сроков ответов на запросы.
     slcan_can_ext_fifo_t rxcanfifo; //!< Фифо полученных сообщений CAN.
     slcan_can_fifo_t txcanfifo; //!< Фифо передаваемых сообщений CAN.
     struct timespec tp_timeout; //!< Тайм-аут запросов.
+    uint64_t timeouts_ns[SLCAN_MASTER_CMD_TYPES_COUNT]; //!< Тайм-ауты по типам запросов, нс.
     bool no_answers; //!< Китайские USB CAN переходники не отвечают.
 } slcan_master_t;
 
@@ -65,13 +82,76 @@ EXTERN size_t slcan_master_received_can_msgs_count(slcan_master_t* scm);
 EXTERN size_t slcan_master_send_can_msgs_avail(slcan_master_t* scm);
 
 /**
- * Устанавливает тайм-аут запросов.
+ * Устанавливает тайм-аут запросов всех типов.
  * @param scm Ведущее устройство.
  * @param tp_timeout Тайм-аут.
  * @return Код ошибки.
  */
 EXTERN slcan_err_t slcan_master_set_timeout(slcan_master_t* scm, const struct timespec* tp_timeout);
 
+/**
+ * Получает тайм-аут запросов заданного типа.
+ * @param scm Ведущее устройство.
+ * @param type Тип запроса.
+ * @param tp_timeout Тайм-аут.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_master_cmd_timeout(const slcan_master_t* scm, slcan_cmd_type_t type, struct timespec* tp_timeout);
+
+/**
+ * Устанавливает тайм-аут запросов заданного типа.
+ * @param scm Ведущее устройство.
+ * @param type Тип запроса.
+ * @param tp_timeout Тайм-аут.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_master_set_cmd_timeout(slcan_master_t* scm, slcan_cmd_type_t type, const struct timespec* tp_timeout);
+
+/**
+ * Устанавливает буфер отправленных запросов.
+ * Размер буфера ограничивает окно - наибольшее
+ * число ожидающих ответа запросов.
+ * Окно устанавливается равным размеру буфера.
+ * @param scm Ведущее устройство.
+ * @param buf Буфер запросов, NULL - встроенный буфер.
+ * @param size Размер буфера запросов.
+ * @return Код ошибки, E_SLCAN_STATE - если есть ожидающие ответа запросы.
+ */
+EXTERN slcan_err_t slcan_master_set_resp_buffer(slcan_master_t* scm, slcan_resp_out_t* buf, size_t size);
+
+/**
+ * Получает окно запросов.
+ * @param scm Ведущее устройство.
+ * @return Наибольшее число ожидающих ответа запросов.
+ */
+EXTERN size_t slcan_master_window(const slcan_master_t* scm);
+
+/**
+ * Устанавливает окно запросов.
+ * @param scm Ведущее устройство.
+ * @param window Наибольшее число ожидающих ответа запросов,
+ * от 1 до размера буфера запросов.
+ */
+EXTERN void slcan_master_set_window(slcan_master_t* scm, size_t window);
+
+/**
+ * Получает флаг адаптивного окна запросов.
+ * @param scm Ведущее устройство.
+ * @return Флаг адаптивного окна запросов.
+ */
+EXTERN bool slcan_master_window_adaptive(const slcan_master_t* scm);
+
+/**
+ * Устанавливает флаг адаптивного окна запросов.
+ * Адаптивное окно увеличивается на единицу за раунд ответов,
+ * пока окно ограничивает отправку, а время приёма-передачи
+ * не превышает удвоенного наименьшего (линия не загружена),
+ * и уменьшается вдвое при тайм-аутах запросов.
+ * @param scm Ведущее устройство.
+ * @param adaptive Флаг адаптивного окна запросов.
+ */
+EXTERN void slcan_master_set_window_adaptive(slcan_master_t* scm, bool adaptive);
+
 /**
  * Получает отсутствие ответов.
  * @param scm Ведущее устройство.
@@ -93,6 +173,32 @@ EXTERN void slcan_master_set_no_answers(slcan_master_t* scm, bool no_answers);
  */
 EXTERN slcan_err_t slcan_master_poll(slcan_master_t* scm);
 
+/**
+ * Ждёт не более чем заданный тайм-аут событий ввода-вывода
+ * и обрабатывает события ведущего устройства.
+ * Ожидание также ограничено ближайшим тайм-аутом запросов.
+ * @param scm Ведущее устройство.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_master_wait(slcan_master_t* scm, const struct timespec* tp_timeout);
+
+/**
+ * Обрабатывает принятые команды и тайм-ауты запросов
+ * без ввода-вывода последовательного интерфейса.
+ * @param scm Ведущее устройство.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_master_process(slcan_master_t* scm);
+
+/**
+ * Получает точное время до ближайшего тайм-аута запросов.
+ * @param scm Ведущее устройство.
+ * @param tp_timeout Время до тайм-аута.
+ * @return Флаг наличия ожидающих ответа запросов.
+ */
+EXTERN bool slcan_master_next_timeout(slcan_master_t* scm, struct timespec* tp_timeout);
+
 /**
  * Ждёт не более чем заданный тайм-аут
  * завершения имеющихся запросов.
@@ -194,6 +300,15 @@ EXTERN slcan_err_t slcan_master_cmd_set_auto_poll(slcan_master_t* scm, bool enab
  */
 EXTERN slcan_err_t slcan_master_cmd_setup_uart(slcan_master_t* scm, slcan_port_baud_t baud, slcan_future_t* future);
 
+/**
+ * Отправляет запрос на настройку UART на произвольную скорость.
+ * @param scm Ведущее устройство.
+ * @param baud_rate Скорость, бод.
+ * @param future Будущее.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_master_cmd_setup_uart_custom(slcan_master_t* scm, uint32_t baud_rate, slcan_future_t* future);
+
 /**
  * Отправляет запрос на получение версии.
  * @param scm Ведущее устройство.
@@ -240,6 +355,17 @@ EXTERN slcan_err_t slcan_master_cmd_set_acceptance_mask(slcan_master_t* scm, uin
  */
 EXTERN slcan_err_t slcan_master_cmd_set_acceptance_filter(slcan_master_t* scm, uint32_t value, slcan_future_t* future);
 
+/**
+ * Отправляет произвольный запрос с заданным тайм-аутом.
+ * Данные ответов на запросы F, V, N не сохраняются.
+ * @param scm Ведущее устройство.
+ * @param cmd Запрос.
+ * @param tp_timeout Тайм-аут, NULL - тайм-аут для типа запроса.
+ * @param future Будущее. Может быть NULL.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_master_request(slcan_master_t* scm, const slcan_cmd_t* cmd, const struct timespec* tp_timeout, slcan_future_t* future);
+
 /**
  * Отправляет запрос на передачу сообщения CAN.
  * @param scm Ведущее устройство.
@@ -249,6 +375,21 @@ EXTERN slcan_err_t slcan_master_cmd_set_acceptance_filter(slcan_master_t* scm, u
  */
 EXTERN slcan_err_t slcan_master_send_can_msg(slcan_master_t* scm, slcan_can_msg_t* can_msg, slcan_future_t* future);
 
+/**
+ * Отправляет запросы на передачу сообщений CAN.
+ * Сообщения записываются подряд в фифо передачи без очереди
+ * сообщений CAN, но не более числа свободных мест для запросов.
+ * Общее будущее завершается после ответа на последнее
+ * отправленное сообщение с первой ошибкой в группе.
+ * @param scm Ведущее устройство.
+ * @param can_msgs Массив сообщений CAN.
+ * @param count Число сообщений CAN.
+ * @param sent Число отправленных сообщений CAN.
+ * @param future Общее будущее. Может быть NULL.
+ * @return Код ошибки, если не отправлено ни одно сообщение.
+ */
+EXTERN slcan_err_t slcan_master_send_can_msgs(slcan_master_t* scm, const slcan_can_msg_t* can_msgs, size_t count, size_t* sent, slcan_future_t* future);
+
 /**
  * Получает принятое сообщение CAN.
  * @param scm Ведущее устройство.
@@ -0,0 +1,88 @@
+#include "slcan_port.h"
+#include "slcan_port_ops.h"
+
+
+
+static int slcan_port_default_open(void* ctx, const char* name, slcan_serial_handle_t* serial_port)
+{
+    (void) ctx;
+
+    return slcan_serial_open(name, serial_port);
+}
+
+static void slcan_port_default_close(void* ctx, slcan_serial_handle_t serial_port)
+{
+    (void) ctx;
+
+    slcan_serial_close(serial_port);
+}
+
+static slcan_port_caps_t slcan_port_default_caps(void* ctx, slcan_serial_handle_t serial_port)
+{
+    (void) ctx;
+
+    return slcan_serial_caps(serial_port);
+}
+
+static int slcan_port_default_configure(void* ctx, slcan_serial_handle_t serial_port, const slcan_port_conf_t* conf)
+{
+    (void) ctx;
+
+    return slcan_serial_configure(serial_port, conf);
+}
+
+static int slcan_port_default_read(void* ctx, slcan_serial_handle_t serial_port, void* data, size_t data_size)
+{
+    (void) ctx;
+
+    return slcan_serial_read(serial_port, data, data_size);
+}
+
+static int slcan_port_default_write(void* ctx, slcan_serial_handle_t serial_port, const void* data, size_t data_size)
+{
+    (void) ctx;
+
+    return slcan_serial_write(serial_port, data, data_size);
+}
+
+static int slcan_port_default_writev(void* ctx, slcan_serial_handle_t serial_port, const slcan_serial_iovec_t* iov, size_t iovcnt)
+{
+    (void) ctx;
+
+    return slcan_serial_writev(serial_port, iov, iovcnt);
+}
+
+static int slcan_port_default_poll(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, int timeout)
+{
+    (void) ctx;
+
+    return slcan_serial_poll(serial_port, events, revents, timeout);
+}
+
+static int slcan_port_default_poll_event(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, slcan_event_handle_t event, bool* signaled, int timeout)
+{
+    (void) ctx;
+
+    return slcan_serial_poll_event(serial_port, events, revents, event, signaled, timeout);
+}
+
+static int slcan_port_default_nbytes(void* ctx, slcan_serial_handle_t serial_port, size_t* size)
+{
+    (void) ctx;
+
+    return slcan_serial_nbytes(serial_port, size);
+}
+
+
+const slcan_port_ops_t slcan_port_default_ops = {
+    .open = slcan_port_default_open,
+    .close = slcan_port_default_close,
+    .caps = slcan_port_default_caps,
+    .configure = slcan_port_default_configure,
+    .read = slcan_port_default_read,
+    .write = slcan_port_default_write,
+    .writev = slcan_port_default_writev,
+    .poll = slcan_port_default_poll,
+    .poll_event = slcan_port_default_poll_event,
+    .nbytes = slcan_port_default_nbytes,
+};
@@ -3,6 +3,8 @@
 
 
 #include <time.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include "slcan_defs.h"
 #include "slcan_serial_io.h"
 
@@ -14,6 +16,15 @@
  */
 EXTERN int slcan_clock_gettime (struct timespec *tp);
 
+/**
+ * Получает текущую грубую отметку времени
+ * (точность порядка миллисекунд, быстрое чтение).
+ * Если грубое время не поддерживается - равна slcan_clock_gettime().
+ * @param tp Отметка времени.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_clock_gettime_coarse (struct timespec *tp);
+
 
 /**
  * Открывает последовательный порт.
@@ -23,6 +34,13 @@ EXTERN int slcan_clock_gettime (struct timespec *tp);
  */
 EXTERN int slcan_serial_open(const char* serial_port_name, slcan_serial_handle_t* serial_port);
 
+/**
+ * Получает возможности последовательного порта.
+ * @param serial_port Идентификатор последовательного порта.
+ * @return Возможности порта (slcan_port_cap_t).
+ */
+EXTERN slcan_port_caps_t slcan_serial_caps(slcan_serial_handle_t serial_port);
+
 /**
  * Настраивает последовательный порт.
  * @param serial_port Идентификатор последовательного порта.
@@ -55,6 +73,17 @@ EXTERN int slcan_serial_read(slcan_serial_handle_t serial_port, void* data, size
  */
 EXTERN int slcan_serial_write(slcan_serial_handle_t serial_port, const void* data, size_t data_size);
 
+/**
+ * Записывает несколько участков данных одним вызовом.
+ * Используется только при наличии у порта
+ * возможности SLCAN_PORT_CAP_WRITEV.
+ * @param serial_port Идентификатор последовательного порта.
+ * @param iov Участки данных.
+ * @param iovcnt Число участков данных.
+ * @return Число записанных байт в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_serial_writev(slcan_serial_handle_t serial_port, const slcan_serial_iovec_t* iov, size_t iovcnt);
+
 /**
  * Ждёт окончания передачи.
  * @param serial_port Идентификатор последовательного порта.
@@ -81,4 +110,131 @@ EXTERN int slcan_serial_poll(slcan_serial_handle_t serial_port, int events, int*
 EXTERN int slcan_serial_nbytes(slcan_serial_handle_t serial_port, size_t* size);
 
 
+
+/**
+ * Ждёт событий порта или сигнала события.
+ * Сигнал события сбрасывается.
+ * @param serial_port Идентификатор последовательного порта.
+ * @param events События порта для ожидания.
+ * @param revents Возникшие события порта.
+ * @param event Идентификатор события.
+ * @param signaled Флаг возникшего сигнала события, может быть NULL.
+ * @param timeout Тайм-аут в миллисекундах, -1 - бесконечное ожидание.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_serial_poll_event(slcan_serial_handle_t serial_port, int events, int* revents, slcan_event_handle_t event, bool* signaled, int timeout);
+
+
+/**
+ * Открывает ожидание событий множества портов.
+ * @param poller Возвращаемый идентификатор ожидания событий.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_poller_open(slcan_poller_handle_t* poller);
+
+/**
+ * Закрывает ожидание событий множества портов.
+ * @param poller Идентификатор ожидания событий.
+ */
+EXTERN void slcan_poller_close(slcan_poller_handle_t poller);
+
+/**
+ * Добавляет порт в ожидание событий.
+ * События сообщаются только при изменении готовности порта
+ * (edge-triggered), поэтому после события данные
+ * необходимо читать и передавать до исчерпания готовности.
+ * @param poller Идентификатор ожидания событий.
+ * @param serial_port Идентификатор последовательного порта.
+ * @param events События для ожидания.
+ * @param user_data Данные пользователя, возвращаемые с событиями порта.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_poller_add(slcan_poller_handle_t poller, slcan_serial_handle_t serial_port, int events, void* user_data);
+
+/**
+ * Удаляет порт из ожидания событий.
+ * @param poller Идентификатор ожидания событий.
+ * @param serial_port Идентификатор последовательного порта.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_poller_del(slcan_poller_handle_t poller, slcan_serial_handle_t serial_port);
+
+/**
+ * Ждёт событий портов.
+ * @param poller Идентификатор ожидания событий.
+ * @param events Массив для возникших событий.
+ * @param max_events Размер массива событий.
+ * @param count Возвращаемое число возникших событий.
+ * @param timeout Тайм-аут в миллисекундах, -1 - бесконечное ожидание.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_poller_wait(slcan_poller_handle_t poller, slcan_poller_event_t* events, size_t max_events, size_t* count, int timeout);
+
+
+
+/**
+ * Открывает событие для пробуждения потока.
+ * @param event Возвращаемый идентификатор события.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_event_open(slcan_event_handle_t* event);
+
+/**
+ * Закрывает событие.
+ * @param event Идентификатор события.
+ */
+EXTERN void slcan_event_close(slcan_event_handle_t event);
+
+/**
+ * Сигнализирует событие.
+ * Может вызываться из любого потока.
+ * @param event Идентификатор события.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_event_signal(slcan_event_handle_t event);
+
+/**
+ * Ждёт сигнала события и сбрасывает его.
+ * @param event Идентификатор события.
+ * @param timeout Тайм-аут в миллисекундах, -1 - бесконечное ожидание.
+ * @return SLCAN_IO_SUCCESS в случае успеха (в том числе по тайм-ауту), иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_event_wait(slcan_event_handle_t event, int timeout);
+
+
+/**
+ * Ждёт изменения значения по адресу (futex).
+ * Может завершаться без изменения значения,
+ * вызывающий должен проверить его сам.
+ * @param addr Адрес значения.
+ * @param value Ожидаемое значение - ожидание только при совпадении.
+ * @param timeout Тайм-аут в миллисекундах, -1 - бесконечное ожидание.
+ * @return SLCAN_IO_SUCCESS в случае успеха (в том числе по тайм-ауту), иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_address_wait(uint32_t* addr, uint32_t value, int timeout);
+
+/**
+ * Будит все потоки, ждущие изменения значения по адресу.
+ * Может вызываться из любого потока.
+ * @param addr Адрес значения.
+ */
+EXTERN void slcan_address_wake(uint32_t* addr);
+
+
+/**
+ * Создаёт поток.
+ * @param thread Возвращаемый идентификатор потока.
+ * @param func Функция потока.
+ * @param arg Аргумент функции потока.
+ * @return SLCAN_IO_SUCCESS в случае успеха, иначе SLCAN_IO_FAIL.
+ */
+EXTERN int slcan_thread_create(slcan_thread_handle_t* thread, slcan_thread_func_t func, void* arg);
+
+/**
+ * Ждёт завершения потока.
+ * @param thread Идентификатор потока.
+ */
+EXTERN void slcan_thread_join(slcan_thread_handle_t thread);
+
+
 #endif /* SLCAN_PORT_H_ */
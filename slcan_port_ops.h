@@ -0,0 +1,52 @@
+/**
+ * @file slcan_port_ops.h
+ * Таблица функций транспорта последовательного интерфейса.
+ */
+
+#ifndef SLCAN_PORT_OPS_H_
+#define SLCAN_PORT_OPS_H_
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "slcan_defs.h"
+#include "slcan_serial_io.h"
+
+
+/**
+ * Таблица функций транспорта.
+ * Функции получают контекст, переданный при открытии порта,
+ * и возвращают значения как соответствующие функции slcan_port.h.
+ * Необязательные функции могут быть NULL.
+ */
+typedef struct _Slcan_Port_Ops {
+    //! Открывает порт.
+    int (*open)(void* ctx, const char* name, slcan_serial_handle_t* serial_port);
+    //! Закрывает порт.
+    void (*close)(void* ctx, slcan_serial_handle_t serial_port);
+    //! Получает возможности порта (необязательно, по-умолчанию - нет возможностей).
+    slcan_port_caps_t (*caps)(void* ctx, slcan_serial_handle_t serial_port);
+    //! Настраивает порт (необязательно).
+    int (*configure)(void* ctx, slcan_serial_handle_t serial_port, const slcan_port_conf_t* conf);
+    //! Читает данные.
+    int (*read)(void* ctx, slcan_serial_handle_t serial_port, void* data, size_t data_size);
+    //! Записывает данные.
+    int (*write)(void* ctx, slcan_serial_handle_t serial_port, const void* data, size_t data_size);
+    //! Записывает несколько участков данных (необязательно).
+    int (*writev)(void* ctx, slcan_serial_handle_t serial_port, const slcan_serial_iovec_t* iov, size_t iovcnt);
+    //! Ждёт событий порта.
+    int (*poll)(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, int timeout);
+    //! Ждёт событий порта или сигнала события (необязательно, для потока ввода-вывода и реактора,
+    //! задаётся только транспортами с файловым дескриптором порта).
+    int (*poll_event)(void* ctx, slcan_serial_handle_t serial_port, int events, int* revents, slcan_event_handle_t event, bool* signaled, int timeout);
+    //! Получает число доступных для чтения байт (необязательно при SLCAN_PORT_CAP_NONBLOCK_READ).
+    int (*nbytes)(void* ctx, slcan_serial_handle_t serial_port, size_t* size);
+} slcan_port_ops_t;
+
+
+/**
+ * Таблица функций транспорта по-умолчанию,
+ * вызывает функции slcan_serial_* порта.
+ */
+EXTERN const slcan_port_ops_t slcan_port_default_ops;
+
+#endif /* SLCAN_PORT_OPS_H_ */
@@ -0,0 +1,312 @@
+#include "slcan_reactor.h"
+#include "slcan_utils.h"
+#include "slcan_port.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <assert.h>
+
+
+
+slcan_err_t slcan_reactor_init(slcan_reactor_t* reactor)
+{
+    assert(reactor != NULL);
+
+    size_t i;
+    for(i = 0; i < SLCAN_REACTOR_SIZE; i ++){
+        reactor->entries[i].type = SLCAN_REACTOR_ENTRY_NONE;
+        reactor->entries[i].master = NULL;
+        reactor->entries[i].sc = NULL;
+        reactor->entries[i].revents = 0;
+    }
+
+    reactor->count = 0;
+    reactor->budget = SLCAN_REACTOR_BUDGET_DEFAULT;
+    reactor->on_error = NULL;
+    reactor->user_data = NULL;
+
+    int res = slcan_poller_open(&reactor->poller);
+    if(res == SLCAN_IO_FAIL){
+        reactor->poller = SLCAN_POLLER_INVALID_HANDLE;
+        return E_SLCAN_IO_ERROR;
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
+void slcan_reactor_deinit(slcan_reactor_t* reactor)
+{
+    assert(reactor != NULL);
+
+    if(reactor->poller != SLCAN_POLLER_INVALID_HANDLE){
+        slcan_poller_close(reactor->poller);
+    }
+
+    reactor->poller = SLCAN_POLLER_INVALID_HANDLE;
+    reactor->count = 0;
+}
+
+static slcan_reactor_entry_t* slcan_reactor_find_entry(slcan_reactor_t* reactor, slcan_t* sc)
+{
+    assert(reactor != NULL);
+
+    size_t i;
+    for(i = 0; i < reactor->count; i ++){
+        if(reactor->entries[i].type != SLCAN_REACTOR_ENTRY_NONE &&
+           reactor->entries[i].sc == sc){
+            return &reactor->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+static slcan_reactor_entry_t* slcan_reactor_alloc_entry(slcan_reactor_t* reactor)
+{
+    assert(reactor != NULL);
+
+    size_t i;
+    for(i = 0; i < SLCAN_REACTOR_SIZE; i ++){
+        if(reactor->entries[i].type == SLCAN_REACTOR_ENTRY_NONE){
+            if(i >= reactor->count) reactor->count = i + 1;
+            return &reactor->entries[i];
+        }
+    }
+
+    return NULL;
+}
+
+static slcan_err_t slcan_reactor_add(slcan_reactor_t* reactor, slcan_reactor_entry_type_t type, void* dev, slcan_t* sc)
+{
+    assert(reactor != NULL);
+
+    if(dev == NULL) return E_SLCAN_NULL_POINTER;
+    if(sc == NULL) return E_SLCAN_NULL_POINTER;
+
+    if(reactor->poller == SLCAN_POLLER_INVALID_HANDLE) return E_SLCAN_STATE;
+    if(!slcan_opened(sc)) return E_SLCAN_STATE;
+    // transport handle isn't a pollable descriptor.
+    if(sc->port_ops->poll_event == NULL) return E_SLCAN_STATE;
+    if(slcan_reactor_find_entry(reactor, sc) != NULL) return E_SLCAN_INVALID_VALUE;
+
+    slcan_reactor_entry_t* entry = slcan_reactor_alloc_entry(reactor);
+    if(entry == NULL) return E_SLCAN_OVERFLOW;
+
+    int res = slcan_poller_add(reactor->poller, slcan_serial_port(sc), SLCAN_POLLIN | SLCAN_POLLOUT, entry);
+    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    entry->type = type;
+    if(type == SLCAN_REACTOR_ENTRY_MASTER){
+        entry->master = (slcan_master_t*)dev;
+    }else{
+        entry->slave = (slcan_slave_t*)dev;
+    }
+    entry->sc = sc;
+    // events are edge-triggered - assume the port is ready
+    // until the data is drained.
+    entry->revents = SLCAN_POLLIN | SLCAN_POLLOUT;
+
+    return E_SLCAN_NO_ERROR;
+}
+
+slcan_err_t slcan_reactor_add_master(slcan_reactor_t* reactor, slcan_master_t* scm)
+{
+    assert(reactor != NULL);
+
+    if(scm == NULL) return E_SLCAN_NULL_POINTER;
+
+    return slcan_reactor_add(reactor, SLCAN_REACTOR_ENTRY_MASTER, scm, slcan_master_slcan(scm));
+}
+
+slcan_err_t slcan_reactor_add_slave(slcan_reactor_t* reactor, slcan_slave_t* scs)
+{
+    assert(reactor != NULL);
+
+    if(scs == NULL) return E_SLCAN_NULL_POINTER;
+
+    return slcan_reactor_add(reactor, SLCAN_REACTOR_ENTRY_SLAVE, scs, slcan_slave_slcan(scs));
+}
+
+slcan_err_t slcan_reactor_remove(slcan_reactor_t* reactor, slcan_t* sc)
+{
+    assert(reactor != NULL);
+
+    if(sc == NULL) return E_SLCAN_NULL_POINTER;
+
+    slcan_reactor_entry_t* entry = slcan_reactor_find_entry(reactor, sc);
+    if(entry == NULL) return E_SLCAN_INVALID_VALUE;
+
+    int res = slcan_poller_del(reactor->poller, slcan_serial_port(sc));
+
+    entry->type = SLCAN_REACTOR_ENTRY_NONE;
+    entry->master = NULL;
+    entry->sc = NULL;
+    entry->revents = 0;
+
+    // shrink used entries.
+    while(reactor->count != 0 &&
+          reactor->entries[reactor->count - 1].type == SLCAN_REACTOR_ENTRY_NONE){
+        reactor->count --;
+    }
+
+    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    return E_SLCAN_NO_ERROR;
+}
+
+ALWAYS_INLINE static void slcan_reactor_error(slcan_reactor_t* reactor, slcan_reactor_entry_t* entry, slcan_err_t err)
+{
+    if(reactor->on_error){
+        reactor->on_error(entry->sc, err, reactor->user_data);
+    }
+}
+
+ALWAYS_INLINE static bool slcan_reactor_entry_has_work(const slcan_reactor_entry_t* entry)
+{
+    // not all incoming data readed.
+    if(entry->revents & SLCAN_POLLIN) return true;
+    // port is ready and there is data to send.
+    if((entry->revents & SLCAN_POLLOUT) && !slcan_io_fifo_empty(&entry->sc->txiofifo)) return true;
+
+    return false;
+}
+
+ALWAYS_INLINE static slcan_err_t slcan_reactor_entry_process(slcan_reactor_entry_t* entry)
+{
+    if(entry->type == SLCAN_REACTOR_ENTRY_MASTER){
+        return slcan_master_process(entry->master);
+    }
+    return slcan_slave_process(entry->slave);
+}
+
+// Обрабатывает устройство и сообщает об ошибках обработки.
+static void slcan_reactor_entry_process_report(slcan_reactor_t* reactor, slcan_reactor_entry_t* entry)
+{
+    unsigned long dropped = slcan_rx_stats(entry->sc)->dropped_bytes;
+    slcan_err_t err;
+
+    err = slcan_reactor_entry_process(entry);
+    if(err == E_SLCAN_NO_ERROR) return;
+
+    // tx fifos are full - try again later,
+    // but received data loss is reported.
+    if((err == E_SLCAN_OVERFLOW || err == E_SLCAN_OVERRUN) &&
+       slcan_rx_stats(entry->sc)->dropped_bytes == dropped) return;
+
+    slcan_reactor_error(reactor, entry, err);
+}
+
+static void slcan_reactor_entry_step(slcan_reactor_t* reactor, slcan_reactor_entry_t* entry)
+{
+    slcan_err_t err;
+    int revents;
+
+    err = slcan_process_io(entry->sc, &entry->revents);
+    if(err != E_SLCAN_NO_ERROR){
+        // wait for the next readiness.
+        entry->revents = 0;
+        slcan_reactor_error(reactor, entry, err);
+        return;
+    }
+
+    slcan_reactor_entry_process_report(reactor, entry);
+
+    // send answers and messages without waiting.
+    if(!(entry->revents & SLCAN_POLLOUT)) return;
+
+    revents = SLCAN_POLLOUT;
+
+    err = slcan_process_io(entry->sc, &revents);
+    if(err != E_SLCAN_NO_ERROR){
+        entry->revents = 0;
+        slcan_reactor_error(reactor, entry, err);
+        return;
+    }
+
+    if(revents & SLCAN_POLLOUT){
+        // tx fifo is drained - put the remaining messages.
+        slcan_reactor_entry_process_report(reactor, entry);
+    }else{
+        entry->revents &= ~SLCAN_POLLOUT;
+    }
+}
+
+slcan_err_t slcan_reactor_run_once(slcan_reactor_t* reactor, const struct timespec* tp_timeout)
+{
+    assert(reactor != NULL);
+
+    if(reactor->poller == SLCAN_POLLER_INVALID_HANDLE) return E_SLCAN_STATE;
+
+    slcan_poller_event_t events[SLCAN_REACTOR_SIZE];
+    slcan_reactor_entry_t* entry;
+    struct timespec tp_wait, tp_next;
+    const struct timespec* p_tp_wait = tp_timeout;
+    size_t i, count;
+    int res;
+
+    for(i = 0; i < reactor->count; i ++){
+        entry = &reactor->entries[i];
+
+        if(entry->type == SLCAN_REACTOR_ENTRY_NONE) continue;
+
+        // put messages queued since the last run.
+        if((entry->revents & SLCAN_POLLOUT) && slcan_io_fifo_empty(&entry->sc->txiofifo)){
+            slcan_reactor_entry_process_report(reactor, entry);
+        }
+
+        // not exhausted readiness - do not sleep.
+        if(slcan_reactor_entry_has_work(entry)){
+            tp_wait.tv_sec = 0;
+            tp_wait.tv_nsec = 0;
+            p_tp_wait = &tp_wait;
+            continue;
+        }
+
+        // wait not longer than the nearest request timeout.
+        if(entry->type == SLCAN_REACTOR_ENTRY_MASTER &&
+           slcan_master_next_timeout(entry->master, &tp_next)){
+            if(p_tp_wait == NULL || slcan_timespec_cmp(&tp_next, p_tp_wait, <)){
+                tp_wait.tv_sec = tp_next.tv_sec;
+                tp_wait.tv_nsec = tp_next.tv_nsec;
+                p_tp_wait = &tp_wait;
+            }
+        }
+    }
+
+    res = slcan_poller_wait(reactor->poller, events, SLCAN_REACTOR_SIZE, &count, slcan_timespec_to_poll_ms(p_tp_wait));
+    if(res == SLCAN_IO_FAIL) return E_SLCAN_IO_ERROR;
+
+    for(i = 0; i < count; i ++){
+        entry = (slcan_reactor_entry_t*)events[i].user_data;
+
+        if(entry == NULL || entry->type == SLCAN_REACTOR_ENTRY_NONE) continue;
+
+        if(events[i].revents & SLCAN_POLLERR){
+            slcan_reactor_error(reactor, entry, E_SLCAN_IO_ERROR);
+        }
+
+        entry->revents |= events[i].revents & (SLCAN_POLLIN | SLCAN_POLLOUT);
+    }
+
+    size_t steps;
+
+    for(i = 0; i < reactor->count; i ++){
+        entry = &reactor->entries[i];
+
+        if(entry->type == SLCAN_REACTOR_ENTRY_NONE) continue;
+
+        // limit work per device per wakeup.
+        for(steps = 0; steps < reactor->budget && slcan_reactor_entry_has_work(entry); steps ++){
+            slcan_reactor_entry_step(reactor, entry);
+        }
+
+        // process expired requests of idle master.
+        if(steps == 0 && entry->type == SLCAN_REACTOR_ENTRY_MASTER &&
+           slcan_master_next_timeout(entry->master, &tp_next) &&
+           tp_next.tv_sec == 0 && tp_next.tv_nsec == 0){
+            slcan_reactor_entry_step(reactor, entry);
+        }
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
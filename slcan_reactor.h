@@ -0,0 +1,148 @@
+#ifndef SLCAN_REACTOR_H_
+#define SLCAN_REACTOR_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "slcan.h"
+#include "slcan_master.h"
+#include "slcan_slave.h"
+#include "slcan_serial_io.h"
+#include "slcan_err.h"
+#include "slcan_defs.h"
+#include "slcan_conf.h"
+
+
+//! Максимальное число интерфейсов.
+#ifndef SLCAN_REACTOR_SIZE
+#define SLCAN_REACTOR_SIZE SLCAN_REACTOR_DEFAULT_SIZE
+#endif
+
+//! Число шагов обработки интерфейса за одно пробуждение.
+#ifndef SLCAN_REACTOR_BUDGET_DEFAULT
+#define SLCAN_REACTOR_BUDGET_DEFAULT 4
+#endif
+
+
+// Структура отметки времени.
+struct timespec;
+
+
+//! Тип коллбэка ошибки обработки интерфейса.
+typedef void (*slcan_reactor_on_error_t)(slcan_t* sc, slcan_err_t err, void* user_data);
+
+
+//! Перечисление типов устройств реактора.
+typedef enum _Slcan_Reactor_Entry_Type {
+    SLCAN_REACTOR_ENTRY_NONE = 0, //!< Свободная запись.
+    SLCAN_REACTOR_ENTRY_MASTER = 1, //!< Ведущее устройство.
+    SLCAN_REACTOR_ENTRY_SLAVE = 2, //!< Ведомое устройство.
+} slcan_reactor_entry_type_t;
+
+//! Структура записи устройства реактора.
+typedef struct _Slcan_Reactor_Entry {
+    slcan_reactor_entry_type_t type; //!< Тип устройства.
+    union {
+        slcan_master_t* master; //!< Ведущее устройство.
+        slcan_slave_t* slave; //!< Ведомое устройство.
+    };
+    slcan_t* sc; //!< Последовательный интерфейс.
+    int revents; //!< Неисчерпанная готовность порта.
+} slcan_reactor_entry_t;
+
+//! Структура реактора.
+typedef struct _Slcan_Reactor {
+    slcan_poller_handle_t poller; //!< Идентификатор ожидания событий.
+    slcan_reactor_entry_t entries[SLCAN_REACTOR_SIZE]; //!< Устройства.
+    size_t count; //!< Число используемых записей.
+    size_t budget; //!< Число шагов обработки за одно пробуждение.
+    slcan_reactor_on_error_t on_error; //!< Коллбэк ошибки.
+    void* user_data; //!< Данные пользователя.
+} slcan_reactor_t;
+
+
+/**
+ * Инициализирует реактор.
+ * @param reactor Реактор.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_reactor_init(slcan_reactor_t* reactor);
+
+/**
+ * Деинициализирует реактор.
+ * @param reactor Реактор.
+ */
+EXTERN void slcan_reactor_deinit(slcan_reactor_t* reactor);
+
+/**
+ * Добавляет ведущее устройство в реактор.
+ * Транспорт интерфейса должен работать через файловый
+ * дескриптор и поддерживать ожидание событий (poll_event).
+ * @param reactor Реактор.
+ * @param scm Ведущее устройство.
+ * @return Код ошибки, E_SLCAN_STATE - если транспорт не поддерживается.
+ */
+EXTERN slcan_err_t slcan_reactor_add_master(slcan_reactor_t* reactor, slcan_master_t* scm);
+
+/**
+ * Добавляет ведомое устройство в реактор.
+ * Транспорт интерфейса должен работать через файловый
+ * дескриптор и поддерживать ожидание событий (poll_event).
+ * @param reactor Реактор.
+ * @param scs Ведомое устройство.
+ * @return Код ошибки, E_SLCAN_STATE - если транспорт не поддерживается.
+ */
+EXTERN slcan_err_t slcan_reactor_add_slave(slcan_reactor_t* reactor, slcan_slave_t* scs);
+
+/**
+ * Удаляет устройство из реактора.
+ * @param reactor Реактор.
+ * @param sc Последовательный интерфейс устройства.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_reactor_remove(slcan_reactor_t* reactor, slcan_t* sc);
+
+/**
+ * Ждёт не более чем заданный тайм-аут событий портов
+ * и обрабатывает готовые устройства.
+ * Ожидание также ограничено ближайшим тайм-аутом
+ * запросов ведущих устройств.
+ * @param reactor Реактор.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_reactor_run_once(slcan_reactor_t* reactor, const struct timespec* tp_timeout);
+
+/**
+ * Получает число шагов обработки устройства за одно пробуждение.
+ * @param reactor Реактор.
+ * @return Число шагов обработки.
+ */
+ALWAYS_INLINE static size_t slcan_reactor_budget(const slcan_reactor_t* reactor)
+{
+    return reactor->budget;
+}
+
+/**
+ * Устанавливает число шагов обработки устройства за одно пробуждение.
+ * @param reactor Реактор.
+ * @param budget Число шагов обработки, не менее 1.
+ */
+ALWAYS_INLINE static void slcan_reactor_set_budget(slcan_reactor_t* reactor, size_t budget)
+{
+    reactor->budget = (budget != 0) ? budget : 1;
+}
+
+/**
+ * Устанавливает коллбэк ошибки обработки устройства.
+ * @param reactor Реактор.
+ * @param on_error Коллбэк.
+ * @param user_data Данные пользователя.
+ */
+ALWAYS_INLINE static void slcan_reactor_set_on_error(slcan_reactor_t* reactor, slcan_reactor_on_error_t on_error, void* user_data)
+{
+    reactor->on_error = on_error;
+    reactor->user_data = user_data;
+}
+
+#endif /* SLCAN_REACTOR_H_ */
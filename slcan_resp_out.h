@@ -3,8 +3,10 @@
 
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <time.h>
 #include "slcan_future.h"
+#include "slcan_timer_wheel.h"
 #include "slcan_cmd.h"
 #include "slcan_slave_status.h"
 
@@ -31,6 +33,8 @@ typedef struct _Slcan_Resp_Out_Close {
 
 //! Структура данных отправленного запроса передачи сообщения CAN.
 typedef struct _Slcan_Resp_Out_Transmit {
+    bool group; //!< Флаг запроса из группы с общим будущим.
+    bool group_last; //!< Флаг последнего запроса группы.
 } slcan_resp_out_transmit_t;
 
 //! Структура данных отправленного запроса получения принятого сообщения CAN.
@@ -74,7 +78,9 @@ typedef struct _Slcan_Resp_Out_Set_Timestamp {
 typedef struct _Slcan_Resp_Out {
     slcan_cmd_type_t req_type; //!< Тип запроса (@see slcan_cmd_type_t).
     slcan_future_t* future; //!< Указатель на будущее для сигнализации о завершении запроса.
-    struct timespec tp_req; //!< Время истечения тайм-аута.
+    slcan_timer_t timer; //!< Таймер срока ответа.
+    uint64_t sent_ns; //!< Время отправки, нс.
+    bool expired; //!< Флаг истёкшего срока, будущее уже завершено.
     //! Объединение всех видов отправленных запросов.
     union {
         slcan_resp_out_setup_can_std_t setup_can_std;
@@ -5,19 +5,37 @@
 
 void slcan_resp_out_fifo_init(slcan_resp_out_fifo_t* fifo)
 {
-    memset(fifo->buf, 0x0, SLCAN_RESP_OUT_FIFO_SIZE * sizeof(slcan_resp_out_t));
+    slcan_resp_out_fifo_init_buf(fifo, NULL, 0);
+}
+
+slcan_err_t slcan_resp_out_fifo_init_buf(slcan_resp_out_fifo_t* fifo, slcan_resp_out_t* buf, size_t size)
+{
+    if(buf == NULL){
+        buf = fifo->default_buf;
+        size = SLCAN_RESP_OUT_FIFO_SIZE;
+    }
+
+    if(size == 0) return E_SLCAN_INVALID_SIZE;
+
+    memset(buf, 0x0, size * sizeof(slcan_resp_out_t));
+
+    fifo->buf = buf;
+    fifo->size = size;
+    fifo->window = size;
     fifo->wptr = 0;
     fifo->rptr = 0;
     fifo->count = 0;
+
+    return E_SLCAN_NO_ERROR;
 }
 
 size_t slcan_resp_out_fifo_put(slcan_resp_out_fifo_t* fifo, const slcan_resp_out_t* resp_out)
 {
-    if(fifo->count < SLCAN_RESP_OUT_FIFO_SIZE){
+    if(fifo->count < fifo->window){
         memcpy(&fifo->buf[fifo->wptr], resp_out, sizeof(slcan_resp_out_t));
         fifo->count ++;
         fifo->wptr ++;
-        if(fifo->wptr >= SLCAN_RESP_OUT_FIFO_SIZE){
+        if(fifo->wptr >= fifo->size){
             fifo->wptr = 0;
         }
         return 1;
@@ -30,7 +48,7 @@ void slcan_resp_out_fifo_unput(slcan_resp_out_fifo_t* fifo)
     if(fifo->count > 0){
         fifo->count --;
         if(fifo->wptr == 0){
-            fifo->wptr = SLCAN_RESP_OUT_FIFO_SIZE - 1;
+            fifo->wptr = fifo->size - 1;
         }else{
             fifo->wptr --;
         }
@@ -43,7 +61,7 @@ size_t slcan_resp_out_fifo_get(slcan_resp_out_fifo_t* fifo, slcan_resp_out_t* re
         memcpy(resp_out, &fifo->buf[fifo->rptr], sizeof(slcan_resp_out_t));
         fifo->count --;
         fifo->rptr ++;
-        if(fifo->rptr >= SLCAN_RESP_OUT_FIFO_SIZE){
+        if(fifo->rptr >= fifo->size){
             fifo->rptr = 0;
         }
         return 1;
@@ -64,8 +82,8 @@ void slcan_resp_out_fifo_data_readed(slcan_resp_out_fifo_t* fifo, size_t data_si
 {
     fifo->count -= data_size;
     fifo->rptr += data_size;
-    if(fifo->rptr >= SLCAN_RESP_OUT_FIFO_SIZE){
-        fifo->rptr -= SLCAN_RESP_OUT_FIFO_SIZE;
+    if(fifo->rptr >= fifo->size){
+        fifo->rptr -= fifo->size;
     }
 }
 
@@ -73,7 +91,7 @@ void slcan_resp_out_fifo_data_written(slcan_resp_out_fifo_t* fifo, size_t data_s
 {
     fifo->count += data_size;
     fifo->wptr += data_size;
-    if(fifo->wptr >= SLCAN_RESP_OUT_FIFO_SIZE){
-        fifo->wptr -= SLCAN_RESP_OUT_FIFO_SIZE;
+    if(fifo->wptr >= fifo->size){
+        fifo->wptr -= fifo->size;
     }
 }
@@ -5,24 +5,45 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include "slcan_defs.h"
+#include "slcan_err.h"
 #include "slcan_resp_out.h"
+#include "slcan_conf.h"
 
 
+//! Количество запросов во встроенном буфере.
 #ifndef SLCAN_RESP_OUT_FIFO_SIZE
-#define SLCAN_RESP_OUT_FIFO_SIZE 32
+#define SLCAN_RESP_OUT_FIFO_SIZE SLCAN_RESP_OUT_FIFO_DEFAULT_SIZE
 #endif
 
 
+//! Тип фифо отправленных запросов.
 typedef struct _Slcan_Resp_Out_Fifo {
-    slcan_resp_out_t buf[SLCAN_RESP_OUT_FIFO_SIZE];
-    size_t wptr;
-    size_t rptr;
-    size_t count;
+    slcan_resp_out_t* buf; //!< Запросы.
+    size_t size; //!< Размер буфера запросов.
+    size_t window; //!< Окно - наибольшее число запросов в фифо, не более size.
+    size_t wptr; //!< Индекс для записи.
+    size_t rptr; //!< Индекс для чтения.
+    size_t count; //!< Число запросов.
+    slcan_resp_out_t default_buf[SLCAN_RESP_OUT_FIFO_SIZE]; //!< Встроенный буфер запросов.
 } slcan_resp_out_fifo_t;
 
 
+/**
+ * Инициализирует фифо со встроенным буфером.
+ * @param fifo Фифо.
+ */
 EXTERN void slcan_resp_out_fifo_init(slcan_resp_out_fifo_t* fifo);
 
+/**
+ * Инициализирует фифо с заданным буфером.
+ * Окно устанавливается равным размеру буфера.
+ * @param fifo Фифо.
+ * @param buf Буфер запросов, NULL - встроенный буфер.
+ * @param size Размер буфера запросов.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_resp_out_fifo_init_buf(slcan_resp_out_fifo_t* fifo, slcan_resp_out_t* buf, size_t size);
+
 ALWAYS_INLINE static void slcan_resp_out_fifo_reset(slcan_resp_out_fifo_t* fifo)
 {
     fifo->wptr = 0;
@@ -30,6 +51,40 @@ ALWAYS_INLINE static void slcan_resp_out_fifo_reset(slcan_resp_out_fifo_t* fifo)
     fifo->count = 0;
 }
 
+/**
+ * Получает размер буфера фифо.
+ * @param fifo Фифо.
+ * @return Размер буфера фифо.
+ */
+ALWAYS_INLINE static size_t slcan_resp_out_fifo_size(const slcan_resp_out_fifo_t* fifo)
+{
+    return fifo->size;
+}
+
+/**
+ * Получает окно фифо.
+ * @param fifo Фифо.
+ * @return Окно фифо.
+ */
+ALWAYS_INLINE static size_t slcan_resp_out_fifo_window(const slcan_resp_out_fifo_t* fifo)
+{
+    return fifo->window;
+}
+
+/**
+ * Устанавливает окно фифо.
+ * Уменьшение окна не удаляет запросы из фифо.
+ * @param fifo Фифо.
+ * @param window Окно, от 1 до размера буфера.
+ */
+ALWAYS_INLINE static void slcan_resp_out_fifo_set_window(slcan_resp_out_fifo_t* fifo, size_t window)
+{
+    if(window == 0) window = 1;
+    if(window > fifo->size) window = fifo->size;
+
+    fifo->window = window;
+}
+
 ALWAYS_INLINE static size_t slcan_resp_out_fifo_avail(const slcan_resp_out_fifo_t* fifo)
 {
     return fifo->count;
@@ -37,12 +92,12 @@ ALWAYS_INLINE static size_t slcan_resp_out_fifo_avail(const slcan_resp_out_fifo_
 
 ALWAYS_INLINE static size_t slcan_resp_out_fifo_remain(const slcan_resp_out_fifo_t* fifo)
 {
-    return SLCAN_RESP_OUT_FIFO_SIZE - fifo->count;
+    return (fifo->count < fifo->window) ? fifo->window - fifo->count : 0;
 }
 
 ALWAYS_INLINE static bool slcan_resp_out_fifo_full(const slcan_resp_out_fifo_t* fifo)
 {
-    return fifo->count == SLCAN_RESP_OUT_FIFO_SIZE;
+    return fifo->count >= fifo->window;
 }
 
 ALWAYS_INLINE static bool slcan_resp_out_fifo_empty(const slcan_resp_out_fifo_t* fifo)
@@ -50,6 +105,28 @@ ALWAYS_INLINE static bool slcan_resp_out_fifo_empty(const slcan_resp_out_fifo_t*
     return fifo->count == 0;
 }
 
+/**
+ * Получает первый запрос фифо без копирования.
+ * @param fifo Фифо.
+ * @return Первый запрос, NULL - если фифо пусто.
+ */
+ALWAYS_INLINE static slcan_resp_out_t* slcan_resp_out_fifo_head(slcan_resp_out_fifo_t* fifo)
+{
+    return (fifo->count != 0) ? &fifo->buf[fifo->rptr] : NULL;
+}
+
+/**
+ * Получает последний помещённый запрос фифо без копирования.
+ * @param fifo Фифо.
+ * @return Последний запрос, NULL - если фифо пусто.
+ */
+ALWAYS_INLINE static slcan_resp_out_t* slcan_resp_out_fifo_tail(slcan_resp_out_fifo_t* fifo)
+{
+    if(fifo->count == 0) return NULL;
+
+    return &fifo->buf[(fifo->wptr == 0) ? fifo->size - 1 : fifo->wptr - 1];
+}
+
 EXTERN size_t slcan_resp_out_fifo_put(slcan_resp_out_fifo_t* fifo, const slcan_resp_out_t* resp_out);
 
 EXTERN void slcan_resp_out_fifo_unput(slcan_resp_out_fifo_t* fifo);
@@ -0,0 +1,144 @@
+#include "slcan_scan.h"
+#include "slcan.h"
+#if SLCAN_SCAN_X86 == 1
+#include <immintrin.h>
+#endif
+
+
+
+// Побайтово ищет концы команд в данных с позиции pos.
+ALWAYS_INLINE static size_t slcan_scan_put_bytes(const uint8_t* data, size_t size, size_t pos,
+                                                 size_t* ends, size_t count, size_t max)
+{
+    for(; pos < size && count < max; pos ++){
+        if(data[pos] == SLCAN_EOM_BYTE || data[pos] == SLCAN_ERR_BYTE){
+            ends[count ++] = pos;
+        }
+    }
+
+    return count;
+}
+
+size_t slcan_scan_ends_scalar(const uint8_t* data, size_t size, size_t* ends, size_t max)
+{
+    return slcan_scan_put_bytes(data, size, 0, ends, 0, max);
+}
+
+
+#if SLCAN_SCAN_X86 == 1
+
+// Помещает в массив смещения битов маски найденных байт.
+ALWAYS_INLINE static size_t slcan_scan_put_mask(uint32_t mask, size_t base, size_t* ends, size_t count, size_t max)
+{
+    while(mask != 0 && count < max){
+        ends[count ++] = base + (size_t)__builtin_ctz(mask);
+        mask &= mask - 1;
+    }
+
+    return count;
+}
+
+__attribute__((target("sse2")))
+size_t slcan_scan_ends_sse2(const uint8_t* data, size_t size, size_t* ends, size_t max)
+{
+    const __m128i eom = _mm_set1_epi8(SLCAN_EOM_BYTE);
+    const __m128i err = _mm_set1_epi8(SLCAN_ERR_BYTE);
+
+    __m128i block;
+    uint32_t mask;
+    size_t count = 0;
+    size_t i = 0;
+
+    for(; i + 16 <= size && count < max; i += 16){
+        block = _mm_loadu_si128((const __m128i*)&data[i]);
+        mask = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, eom),
+                                                        _mm_cmpeq_epi8(block, err)));
+        count = slcan_scan_put_mask(mask, i, ends, count, max);
+    }
+
+    // tail.
+    return slcan_scan_put_bytes(data, size, i, ends, count, max);
+}
+
+__attribute__((target("avx2")))
+size_t slcan_scan_ends_avx2(const uint8_t* data, size_t size, size_t* ends, size_t max)
+{
+    const __m256i eom = _mm256_set1_epi8(SLCAN_EOM_BYTE);
+    const __m256i err = _mm256_set1_epi8(SLCAN_ERR_BYTE);
+
+    __m256i block;
+    __m128i half;
+    uint32_t mask;
+    size_t count = 0;
+    size_t i = 0;
+
+    for(; i + 32 <= size && count < max; i += 32){
+        block = _mm256_loadu_si256((const __m256i*)&data[i]);
+        mask = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(block, eom),
+                                                              _mm256_cmpeq_epi8(block, err)));
+        count = slcan_scan_put_mask(mask, i, ends, count, max);
+    }
+
+    // tail, the same encoding as the main loop
+    // to avoid AVX-SSE transitions.
+    if(i + 16 <= size && count < max){
+        half = _mm_loadu_si128((const __m128i*)&data[i]);
+        mask = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(half, _mm256_castsi256_si128(eom)),
+                                                        _mm_cmpeq_epi8(half, _mm256_castsi256_si128(err))));
+        count = slcan_scan_put_mask(mask, i, ends, count, max);
+        i += 16;
+    }
+
+    return slcan_scan_put_bytes(data, size, i, ends, count, max);
+}
+
+#endif
+
+
+// Выбирает реализацию по возможностям процессора.
+static slcan_scan_ends_t slcan_scan_select(void)
+{
+#if SLCAN_SCAN_X86 == 1
+    __builtin_cpu_init();
+
+    if(__builtin_cpu_supports("avx2")) return slcan_scan_ends_avx2;
+    if(__builtin_cpu_supports("sse2")) return slcan_scan_ends_sse2;
+#endif
+
+    return slcan_scan_ends_scalar;
+}
+
+static size_t slcan_scan_ends_resolve(const uint8_t* data, size_t size, size_t* ends, size_t max);
+
+// Выбранная реализация.
+static slcan_scan_ends_t slcan_scan_ends_impl = slcan_scan_ends_resolve;
+
+static size_t slcan_scan_ends_resolve(const uint8_t* data, size_t size, size_t* ends, size_t max)
+{
+    slcan_scan_ends_t impl = slcan_scan_select();
+
+    // any thread selects the same implementation.
+    __atomic_store_n(&slcan_scan_ends_impl, impl, __ATOMIC_RELAXED);
+
+    return impl(data, size, ends, max);
+}
+
+size_t slcan_scan_ends(const uint8_t* data, size_t size, size_t* ends, size_t max)
+{
+    slcan_scan_ends_t impl = __atomic_load_n(&slcan_scan_ends_impl, __ATOMIC_RELAXED);
+
+    return impl(data, size, ends, max);
+}
+
+const char* slcan_scan_impl_name(void)
+{
+    slcan_scan_ends_t impl = slcan_scan_select();
+
+#if SLCAN_SCAN_X86 == 1
+    if(impl == slcan_scan_ends_avx2) return "avx2";
+    if(impl == slcan_scan_ends_sse2) return "sse2";
+#endif
+    (void) impl;
+
+    return "scalar";
+}
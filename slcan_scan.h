@@ -0,0 +1,82 @@
+#ifndef SLCAN_SCAN_H_
+#define SLCAN_SCAN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "slcan_defs.h"
+#include "slcan_conf.h"
+
+
+//! Поддержка SSE2/AVX2 (x86, GCC или Clang).
+#if defined(SLCAN_SCAN_SIMD) && SLCAN_SCAN_SIMD == 1 &&\
+    (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SLCAN_SCAN_X86 1
+#else
+#define SLCAN_SCAN_X86 0
+#endif
+
+
+/**
+ * Тип функции поиска границ команд.
+ * @param data Данные.
+ * @param size Размер данных.
+ * @param ends Массив для смещений концов команд (EOM или ERR).
+ * @param max Размер массива смещений.
+ * @return Число найденных концов команд.
+ */
+typedef size_t (*slcan_scan_ends_t)(const uint8_t* data, size_t size, size_t* ends, size_t max);
+
+
+/**
+ * Находит смещения всех концов команд (EOM или ERR)
+ * в блоке данных, но не более max.
+ * Реализация выбирается при первом вызове по возможностям процессора.
+ * @param data Данные.
+ * @param size Размер данных.
+ * @param ends Массив для смещений концов команд.
+ * @param max Размер массива смещений.
+ * @return Число найденных концов команд.
+ */
+EXTERN size_t slcan_scan_ends(const uint8_t* data, size_t size, size_t* ends, size_t max);
+
+/**
+ * Получает имя выбранной реализации поиска границ команд.
+ * @return Имя реализации ("scalar", "sse2", "avx2").
+ */
+EXTERN const char* slcan_scan_impl_name(void);
+
+/**
+ * Побайтовая реализация поиска границ команд.
+ * @param data Данные.
+ * @param size Размер данных.
+ * @param ends Массив для смещений концов команд.
+ * @param max Размер массива смещений.
+ * @return Число найденных концов команд.
+ */
+EXTERN size_t slcan_scan_ends_scalar(const uint8_t* data, size_t size, size_t* ends, size_t max);
+
+#if SLCAN_SCAN_X86 == 1
+/**
+ * Реализация поиска границ команд на SSE2.
+ * @param data Данные.
+ * @param size Размер данных.
+ * @param ends Массив для смещений концов команд.
+ * @param max Размер массива смещений.
+ * @return Число найденных концов команд.
+ */
+EXTERN size_t slcan_scan_ends_sse2(const uint8_t* data, size_t size, size_t* ends, size_t max);
+
+/**
+ * Реализация поиска границ команд на AVX2.
+ * Вызывается только при поддержке AVX2 процессором.
+ * @param data Данные.
+ * @param size Размер данных.
+ * @param ends Массив для смещений концов команд.
+ * @param max Размер массива смещений.
+ * @return Число найденных концов команд.
+ */
+EXTERN size_t slcan_scan_ends_avx2(const uint8_t* data, size_t size, size_t* ends, size_t max);
+#endif
+
+#endif /* SLCAN_SCAN_H_ */
@@ -2,6 +2,8 @@
 #define SLCAN_SERIAL_IO_H_
 
 #include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 
 //! Тип идентификатора ввода-вывода последовательного порта.
@@ -11,6 +13,30 @@ typedef void* slcan_serial_handle_t;
 #define SLCAN_IO_INVALID_HANDLE ((slcan_serial_handle_t)(long)(-1))
 
 
+//! Тип идентификатора ожидания событий множества портов.
+typedef void* slcan_poller_handle_t;
+
+//! Значение недействительного идентификатора ожидания событий.
+#define SLCAN_POLLER_INVALID_HANDLE ((slcan_poller_handle_t)(long)(-1))
+
+
+//! Тип идентификатора события для пробуждения потока.
+typedef void* slcan_event_handle_t;
+
+//! Значение недействительного идентификатора события.
+#define SLCAN_EVENT_INVALID_HANDLE ((slcan_event_handle_t)(long)(-1))
+
+
+//! Тип идентификатора потока.
+typedef void* slcan_thread_handle_t;
+
+//! Значение недействительного идентификатора потока.
+#define SLCAN_THREAD_INVALID_HANDLE ((slcan_thread_handle_t)(long)(-1))
+
+//! Тип функции потока.
+typedef void* (*slcan_thread_func_t)(void* arg);
+
+
 //! Значение, возвращаемое при неудачном вызове.
 #define SLCAN_IO_FAIL (-1)
 
@@ -34,26 +60,76 @@ typedef enum _Slcan_Port_Baud {
     SLCAN_PORT_BAUD_19200 = 4, //!< 19200
     SLCAN_PORT_BAUD_9600 = 5, //!< 9600
     SLCAN_PORT_BAUD_2400 = 6, //!< 2400
+    SLCAN_PORT_BAUD_460800 = 7, //!< 460800
+    SLCAN_PORT_BAUD_921600 = 8, //!< 921600
+    SLCAN_PORT_BAUD_1000000 = 9, //!< 1000000
+    SLCAN_PORT_BAUD_1500000 = 10, //!< 1500000
+    SLCAN_PORT_BAUD_2000000 = 11, //!< 2000000
+    SLCAN_PORT_BAUD_3000000 = 12, //!< 3000000
+    SLCAN_PORT_BAUD_4000000 = 13, //!< 4000000
+    SLCAN_PORT_BAUD_CUSTOM = 14, //!< Произвольная скорость (baud_rate).
 } slcan_port_baud_t;
 
+//! Максимальная стандартная скорость последовательного порта.
+#define SLCAN_PORT_BAUD_STD_MAX SLCAN_PORT_BAUD_4000000
+
 //! Перечисление числа стоповых бит порта.
 typedef enum _Slcan_Port_Stop_Bits {
     SLCAN_PORT_STOP_BITS_1 = 0,
     SLCAN_PORT_STOP_BITS_2 = 1,
 } slcan_port_stop_bits_t;
 
+//! Перечисление режимов управления потоком порта.
+typedef enum _Slcan_Port_Flow_Control {
+    SLCAN_PORT_FLOW_CONTROL_NONE = 0, //!< Без управления потоком.
+    SLCAN_PORT_FLOW_CONTROL_RTS_CTS = 1, //!< Аппаратное управление потоком RTS/CTS.
+} slcan_port_flow_control_t;
+
 //! Структура конфигурации порта.
 typedef struct _Slcan_Port_Conf {
     slcan_port_parity_t parity; //!< Чётность.
     slcan_port_baud_t baud; //!< Скорость.
+    uint32_t baud_rate; //!< Произвольная скорость, бод (при baud == SLCAN_PORT_BAUD_CUSTOM).
     slcan_port_stop_bits_t stop_bits; //!< Стоповые биты.
+    slcan_port_flow_control_t flow_control; //!< Управление потоком.
+    bool low_latency; //!< Режим низкой задержки драйвера порта (ASYNC_LOW_LATENCY).
+    //! Значение VMIN терминала. Порт всегда неблокирующий (O_NONBLOCK),
+    //! поэтому оно определяет только результат чтения пустого порта:
+    //! 0 - чтение возвращает 0, иначе - ошибку EAGAIN.
+    uint8_t vmin;
+    //! Значение VTIME терминала, десятые доли секунды.
+    //! Неблокирующим портом не используется.
+    uint8_t vtime;
 } slcan_port_conf_t;
 
+//! Перечисление возможностей порта.
+typedef enum _Slcan_Port_Cap {
+    SLCAN_PORT_CAP_NONE = 0, //!< Нет возможностей.
+    SLCAN_PORT_CAP_NONBLOCK_READ = 1, //!< Неблокирующее чтение без запроса числа доступных байт.
+    SLCAN_PORT_CAP_WRITEV = 2, //!< Запись нескольких участков данных одним вызовом.
+} slcan_port_cap_t;
+
+//! Тип возможностей порта.
+typedef int slcan_port_caps_t;
+
+//! Структура участка данных для записи.
+typedef struct _Slcan_Serial_Iovec {
+    const void* data; //!< Данные.
+    size_t size; //!< Размер данных.
+} slcan_serial_iovec_t;
+
 //! Перечисление флагов для poll (events & revents).
 typedef enum _Slcan_Poll {
     SLCAN_POLLIN = 1, //!< Входящие данные.
-    SLCAN_POLLOUT = 4 //!< Готовность передавать новые данные.
+    SLCAN_POLLOUT = 4, //!< Готовность передавать новые данные.
+    SLCAN_POLLERR = 8 //!< Ошибка или отключение порта.
 } slcan_poll_t;
 
+//! Структура события ожидания множества портов.
+typedef struct _Slcan_Poller_Event {
+    void* user_data; //!< Данные пользователя порта.
+    int revents; //!< Возникшие события.
+} slcan_poller_event_t;
+
 
 #endif /* SLCAN_SERIAL_IO_H_ */
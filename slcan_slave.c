@@ -363,14 +363,21 @@ static slcan_err_t slcan_slave_on_setup_uart(slcan_slave_t* scs, slcan_cmd_t* cm
     assert(scs != NULL);
 
     if(cmd == NULL) return E_SLCAN_NULL_POINTER;
-    if(!scs->cb || !scs->cb->on_setup_uart) return slcan_slave_send_answer_err(scs);
     if(scs->flags & SLCAN_SLAVE_FLAG_OPENED) return slcan_slave_send_answer_err(scs);
 
     slcan_port_baud_t baud = cmd->setup_uart.baud;
 
     slcan_err_t err;
 
-    err = scs->cb->on_setup_uart(baud, scs->user_data);
+    if(baud == SLCAN_PORT_BAUD_CUSTOM){
+        if(!scs->cb || !scs->cb->on_setup_uart_custom) return slcan_slave_send_answer_err(scs);
+
+        err = scs->cb->on_setup_uart_custom(cmd->setup_uart.baud_rate, scs->user_data);
+    }else{
+        if(!scs->cb || !scs->cb->on_setup_uart) return slcan_slave_send_answer_err(scs);
+
+        err = scs->cb->on_setup_uart(baud, scs->user_data);
+    }
 
     // fail
     if(err != E_SLCAN_NO_ERROR){
@@ -667,91 +674,132 @@ ALWAYS_INLINE static bool slcan_slave_can_send_existing_messages(slcan_slave_t*
     return scs->flags & (SLCAN_SLAVE_FLAG_OPENED | SLCAN_SLAVE_FLAG_AUTO_POLL);
 }
 
-slcan_err_t slcan_slave_poll(slcan_slave_t* scs)
+// Обрабатывает полученные команды и отправку сообщений.
+static slcan_err_t slcan_slave_process_cycle(slcan_slave_t* scs)
+{
+    slcan_err_t err, get_err, dispatch_err;
+    slcan_cmd_t cmds[SLCAN_CMDS_BATCH_SIZE];
+    size_t i, n;
+
+    for(;;){
+        get_err = slcan_get_cmds(scs->sc, cmds, SLCAN_CMDS_BATCH_SIZE, &n);
+
+        // received commands are dispatched anyway,
+        // the first error is returned after the batch.
+        dispatch_err = E_SLCAN_NO_ERROR;
+        for(i = 0; i < n; i ++){
+            err = slcan_slave_dispatch(scs, &cmds[i]);
+            if(err != E_SLCAN_NO_ERROR && dispatch_err == E_SLCAN_NO_ERROR){
+                dispatch_err = err;
+            }
+        }
+        if(dispatch_err != E_SLCAN_NO_ERROR) return dispatch_err;
+
+        // if no incoming commands.
+        if(get_err == E_SLCAN_UNDERFLOW || get_err == E_SLCAN_UNDERRUN) break;
+        if(get_err != E_SLCAN_NO_ERROR) return get_err;
+        // all commands processed.
+        if(n < SLCAN_CMDS_BATCH_SIZE) break;
+    }
+
+    if(slcan_slave_can_send_existing_messages(scs)){
+        err = slcan_slave_send_existing_can_msgs(scs);
+        if(err != E_SLCAN_NO_ERROR) return err;
+    }
+
+    return E_SLCAN_NO_ERROR;
+}
+
+slcan_err_t slcan_slave_process(slcan_slave_t* scs)
 {
     assert(scs != 0);
 
+    if(scs->sc == NULL) return E_SLCAN_NULL_POINTER;
+
     slcan_err_t err;
 
+    // one clock read per cycle.
+    slcan_update_now(scs->sc);
+
+    err = slcan_slave_process_cycle(scs);
+
+    slcan_release_now(scs->sc);
+
+    return err;
+}
+
+slcan_err_t slcan_slave_poll(slcan_slave_t* scs)
+{
+    assert(scs != 0);
+
 #if defined(SLCAN_SLAVE_POLL_SLCAN) && SLCAN_SLAVE_POLL_SLCAN == 1
+    slcan_err_t err;
+
     err = slcan_poll(scs->sc);
     if(err != E_SLCAN_NO_ERROR) return err;
 #endif
 
-    slcan_cmd_t cmd;
+    return slcan_slave_process(scs);
+}
 
-    for(;;){
-        err = slcan_get_cmd(scs->sc, &cmd);
-        // if no incoming commands.
-        if(err == E_SLCAN_UNDERFLOW || err == E_SLCAN_UNDERRUN) break;
-        if(err != E_SLCAN_NO_ERROR) return err;
+slcan_err_t slcan_slave_wait(slcan_slave_t* scs, const struct timespec* tp_timeout)
+{
+    assert(scs != 0);
 
-        err = slcan_slave_dispatch(scs, &cmd);
-        if(err != E_SLCAN_NO_ERROR) return err;
-    }
+    slcan_err_t err;
 
-    if(slcan_slave_can_send_existing_messages(scs)){
-        err = slcan_slave_send_existing_can_msgs(scs);
-        if(err != E_SLCAN_NO_ERROR) return err;
-    }
+    err = slcan_wait(scs->sc, tp_timeout);
+    if(err != E_SLCAN_NO_ERROR) return err;
 
-    return E_SLCAN_NO_ERROR;
+    return slcan_slave_process(scs);
 }
 
 slcan_err_t slcan_slave_flush(slcan_slave_t* scs, struct timespec* tp_timeout)
 {
     assert(scs != 0);
 
-    struct timespec tp_end, tp_cur;
-    struct timespec tp_flush, *p_tp_flush;
+    struct timespec tp_end, tp_cur, tp_wait;
+    struct timespec* p_tp_wait = NULL;
 
     if(tp_timeout){
         slcan_clock_gettime(&tp_cur);
         slcan_timespec_add(&tp_cur, tp_timeout, &tp_end);
-        tp_flush.tv_sec = tp_timeout->tv_sec;
-        tp_flush.tv_nsec = tp_timeout->tv_nsec;
-        p_tp_flush = &tp_flush;
     }else{
         tp_end.tv_sec = 0;
         tp_end.tv_nsec = 0;
-    	tp_flush.tv_sec = 0;
-    	tp_flush.tv_nsec = 0;
-    	p_tp_flush = NULL;
     }
 
     slcan_err_t err;
 
     while(slcan_slave_can_send_existing_messages(scs) && !slcan_can_ext_fifo_empty(&scs->rxcanfifo)){
+        if(tp_timeout){
+            slcan_clock_gettime(&tp_cur);
+            slcan_timespec_remain(&tp_end, &tp_cur, &tp_wait);
+            p_tp_wait = &tp_wait;
+        }
 
-        err = slcan_flush(scs->sc, p_tp_flush);
-        if(err != E_SLCAN_NO_ERROR) return err;
-
-#if defined(SLCAN_SLAVE_POLL_SLCAN) && SLCAN_SLAVE_POLL_SLCAN == 1
-        err = slcan_poll_out(scs->sc);
-        if(err != E_SLCAN_NO_ERROR) return err;
-#endif
-        err = slcan_slave_send_existing_can_msgs(scs);
+        // send data and put remaining frames.
+        err = slcan_slave_wait(scs, p_tp_wait);
         if(err != E_SLCAN_OVERFLOW && err != E_SLCAN_OVERRUN){
-        	if(err != E_SLCAN_NO_ERROR) return err;
+            if(err != E_SLCAN_NO_ERROR) return err;
         }
 
-        if(tp_timeout){
+        if(tp_timeout && !slcan_can_ext_fifo_empty(&scs->rxcanfifo)){
             slcan_clock_gettime(&tp_cur);
 
-            if(slcan_timespec_cmp(&tp_cur, &tp_end, >)){
+            if(!slcan_timespec_cmp(&tp_cur, &tp_end, <)){
                 return E_SLCAN_TIMEOUT;
             }
         }
-
-		if(p_tp_flush){
-			slcan_timespec_sub(&tp_end, &tp_cur, p_tp_flush);
-		}
     }
 
-    err = slcan_flush(scs->sc, p_tp_flush);
-    if(err != E_SLCAN_NO_ERROR) return err;
+    if(tp_timeout){
+        slcan_clock_gettime(&tp_cur);
+        slcan_timespec_remain(&tp_end, &tp_cur, &tp_wait);
+        p_tp_wait = &tp_wait;
+    }
 
-    return E_SLCAN_NO_ERROR;
+    return slcan_flush(scs->sc, p_tp_wait);
 }
 
 void slcan_slave_reset(slcan_slave_t* scs)
@@ -768,15 +816,12 @@ void slcan_slave_reset(slcan_slave_t* scs)
     slcan_reset(scs->sc);
 }
 
-static uint16_t slcan_slave_get_timestamp(void)
+static uint16_t slcan_slave_get_timestamp(slcan_slave_t* scs)
 {
-    struct timespec ts;
-
-    if(slcan_clock_gettime(&ts) != 0) return 0;
-
-    uint16_t timestamp = ts.tv_sec % 60 + ts.tv_nsec / 1000000;
+    // milliseconds in a minute.
+    uint64_t ms = slcan_now_ns(scs->sc) / 1000000;
 
-    return timestamp;
+    return (uint16_t)(ms % 60000);
 }
 
 slcan_err_t slcan_slave_send_can_msg(slcan_slave_t* scs, slcan_can_msg_t* can_msg, slcan_future_t* future)
@@ -791,7 +836,7 @@ slcan_err_t slcan_slave_send_can_msg(slcan_slave_t* scs, slcan_can_msg_t* can_ms
 
     extdata.autopoll_flag = false;
     extdata.has_timestamp = false;
-    extdata.timestamp = slcan_slave_get_timestamp();
+    extdata.timestamp = slcan_slave_get_timestamp(scs);
 
     slcan_slave_future_start(future);
 
@@ -27,6 +27,8 @@ typedef slcan_err_t (*slcan_on_listen_t)(void* user_data);
 typedef slcan_err_t (*slcan_on_close_t)(void* user_data);
 //! Тип коллбэка настройки UART.
 typedef slcan_err_t (*slcan_on_setup_uart_t)(slcan_port_baud_t baud, void* user_data);
+//! Тип коллбэка настройки UART на произвольную скорость.
+typedef slcan_err_t (*slcan_on_setup_uart_custom_t)(uint32_t baud_rate, void* user_data);
 //! Тип коллбэка установки маски фильтра CAN.
 typedef slcan_err_t (*slcan_on_set_acceptance_mask_t)(uint32_t value, void* user_data);
 //! Тип коллбэка установки значения фильтра CAN.
@@ -41,6 +43,7 @@ typedef struct _Slcan_Slave_Callbacks {
     slcan_on_listen_t on_listen;
     slcan_on_close_t on_close;
     slcan_on_setup_uart_t on_setup_uart;
+    slcan_on_setup_uart_custom_t on_setup_uart_custom;
     slcan_on_set_acceptance_mask_t on_set_acceptance_mask;
     slcan_on_set_acceptance_filter_t on_set_acceptance_filter;
 } slcan_slave_callbacks_t;
@@ -149,6 +152,23 @@ EXTERN size_t slcan_slave_send_can_msgs_avail(slcan_slave_t* scs);
  */
 EXTERN slcan_err_t slcan_slave_poll(slcan_slave_t* scs);
 
+/**
+ * Ждёт не более чем заданный тайм-аут событий ввода-вывода
+ * и обрабатывает события ведомого устройства.
+ * @param scs Ведомое устройство.
+ * @param tp_timeout Тайм-аут, NULL - бесконечное ожидание.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_slave_wait(slcan_slave_t* scs, const struct timespec* tp_timeout);
+
+/**
+ * Обрабатывает принятые команды
+ * без ввода-вывода последовательного интерфейса.
+ * @param scs Ведомое устройство.
+ * @return Код ошибки.
+ */
+EXTERN slcan_err_t slcan_slave_process(slcan_slave_t* scs);
+
 /**
  * Ждёт не более чем заданный тайм-аут
  * отправки полученных фреймов.
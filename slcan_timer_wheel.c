@@ -0,0 +1,218 @@
+#include "slcan_timer_wheel.h"
+#include <string.h>
+#include <assert.h>
+
+
+// Число тиков, охватываемых уровнями до level включительно.
+#define SLCAN_TIMER_WHEEL_SPAN(level) ((uint64_t)1 << (SLCAN_TIMER_WHEEL_BITS * ((level) + 1)))
+
+
+void slcan_timer_wheel_init(slcan_timer_wheel_t* wheel)
+{
+    assert(wheel != NULL);
+
+    memset(wheel, 0x0, sizeof(slcan_timer_wheel_t));
+}
+
+// Помещает таймер в слот по сроку относительно текущего тика.
+static void slcan_timer_wheel_insert(slcan_timer_wheel_t* wheel, slcan_timer_t* timer)
+{
+    uint64_t expires = timer->deadline_ns >> SLCAN_TIMER_WHEEL_TICK_SHIFT;
+    uint64_t delta;
+    unsigned int level, index;
+    slcan_timer_t** slot;
+
+    // overdue - to the current slot.
+    if(expires < wheel->tick) expires = wheel->tick;
+
+    delta = expires - wheel->tick;
+
+    for(level = 0; level < SLCAN_TIMER_WHEEL_LEVELS - 1; level ++){
+        if(delta < SLCAN_TIMER_WHEEL_SPAN(level)) break;
+    }
+    // too far - postpone to the last slot.
+    if(delta >= SLCAN_TIMER_WHEEL_SPAN(level)){
+        expires = wheel->tick + SLCAN_TIMER_WHEEL_SPAN(level) - 1;
+    }
+
+    index = (unsigned int)(expires >> (SLCAN_TIMER_WHEEL_BITS * level)) & SLCAN_TIMER_WHEEL_MASK;
+    slot = &wheel->slots[level][index];
+
+    timer->next = *slot;
+    if(timer->next) timer->next->pprev = &timer->next;
+    timer->pprev = slot;
+    timer->slot = level * SLCAN_TIMER_WHEEL_SLOTS + index;
+    *slot = timer;
+
+    wheel->bitmap[level] |= (uint64_t)1 << index;
+    wheel->count ++;
+}
+
+void slcan_timer_wheel_add(slcan_timer_wheel_t* wheel, slcan_timer_t* timer, uint64_t deadline_ns, uint64_t now_ns)
+{
+    assert(wheel != NULL);
+    assert(timer != NULL);
+    assert(!slcan_timer_pending(timer));
+
+    // idle wheel - skip to now.
+    if(wheel->count == 0){
+        wheel->tick = now_ns >> SLCAN_TIMER_WHEEL_TICK_SHIFT;
+    }
+
+    timer->deadline_ns = deadline_ns;
+
+    slcan_timer_wheel_insert(wheel, timer);
+}
+
+void slcan_timer_wheel_del(slcan_timer_wheel_t* wheel, slcan_timer_t* timer)
+{
+    assert(wheel != NULL);
+    assert(timer != NULL);
+    assert(slcan_timer_pending(timer));
+
+    unsigned int level = timer->slot / SLCAN_TIMER_WHEEL_SLOTS;
+    unsigned int index = timer->slot % SLCAN_TIMER_WHEEL_SLOTS;
+
+    *timer->pprev = timer->next;
+    if(timer->next) timer->next->pprev = timer->pprev;
+
+    if(wheel->slots[level][index] == NULL){
+        wheel->bitmap[level] &= ~((uint64_t)1 << index);
+    }
+
+    timer->next = NULL;
+    timer->pprev = NULL;
+
+    wheel->count --;
+}
+
+// Переносит таймеры верхних уровней на границе блока тиков.
+static void slcan_timer_wheel_cascade(slcan_timer_wheel_t* wheel)
+{
+    slcan_timer_t* timer;
+    slcan_timer_t* next;
+    unsigned int level, index;
+
+    for(level = 1; level < SLCAN_TIMER_WHEEL_LEVELS; level ++){
+        index = (unsigned int)(wheel->tick >> (SLCAN_TIMER_WHEEL_BITS * level)) & SLCAN_TIMER_WHEEL_MASK;
+
+        timer = wheel->slots[level][index];
+        wheel->slots[level][index] = NULL;
+        wheel->bitmap[level] &= ~((uint64_t)1 << index);
+
+        for(; timer != NULL; timer = next){
+            next = timer->next;
+            wheel->count --;
+            slcan_timer_wheel_insert(wheel, timer);
+        }
+
+        // upper level is not at the block boundary.
+        if(index != 0) break;
+    }
+}
+
+// Продвигает текущий тик к следующему непустому слоту,
+// границе блока тиков или тику now_tick.
+static void slcan_timer_wheel_step(slcan_timer_wheel_t* wheel, uint64_t now_tick)
+{
+    unsigned int index = (unsigned int)wheel->tick & SLCAN_TIMER_WHEEL_MASK;
+    uint64_t next = (wheel->tick | SLCAN_TIMER_WHEEL_MASK) + 1;
+    uint64_t bits;
+
+    // next non-empty slot in the current block.
+    if(index != SLCAN_TIMER_WHEEL_MASK){
+        bits = wheel->bitmap[0] >> (index + 1);
+        if(bits != 0) next = wheel->tick + 1 + (uint64_t)__builtin_ctzll(bits);
+    }
+
+    if(next > now_tick) next = now_tick;
+
+    wheel->tick = next;
+
+    if((next & SLCAN_TIMER_WHEEL_MASK) == 0){
+        slcan_timer_wheel_cascade(wheel);
+    }
+}
+
+slcan_timer_t* slcan_timer_wheel_expire(slcan_timer_wheel_t* wheel, uint64_t now_ns)
+{
+    assert(wheel != NULL);
+
+    uint64_t now_tick = now_ns >> SLCAN_TIMER_WHEEL_TICK_SHIFT;
+    unsigned int index;
+    slcan_timer_t* timer;
+    slcan_timer_t* first;
+
+    for(;;){
+        // idle wheel - skip to now.
+        if(wheel->count == 0){
+            if(wheel->tick < now_tick) wheel->tick = now_tick;
+            return NULL;
+        }
+
+        index = (unsigned int)wheel->tick & SLCAN_TIMER_WHEEL_MASK;
+
+        // exact deadlines within the tick,
+        // the earliest one first.
+        first = NULL;
+        for(timer = wheel->slots[0][index]; timer != NULL; timer = timer->next){
+            if(timer->deadline_ns <= now_ns && (first == NULL || timer->deadline_ns <= first->deadline_ns)){
+                first = timer;
+            }
+        }
+        if(first != NULL){
+            slcan_timer_wheel_del(wheel, first);
+            return first;
+        }
+
+        if(wheel->tick >= now_tick) return NULL;
+
+        slcan_timer_wheel_step(wheel, now_tick);
+    }
+
+    return NULL;
+}
+
+bool slcan_timer_wheel_next(const slcan_timer_wheel_t* wheel, uint64_t* deadline_ns)
+{
+    assert(wheel != NULL);
+    assert(deadline_ns != NULL);
+
+    const slcan_timer_t* timer;
+    uint64_t deadline = UINT64_MAX;
+    uint64_t bits;
+    unsigned int level, start, index;
+
+    if(wheel->count == 0) return false;
+
+    for(level = 0; level < SLCAN_TIMER_WHEEL_LEVELS - 1; level ++){
+        bits = wheel->bitmap[level];
+        if(bits == 0) continue;
+
+        // slots in order of ticks: from the current one on level 0,
+        // from the next block on the upper levels.
+        start = (unsigned int)(wheel->tick >> (SLCAN_TIMER_WHEEL_BITS * level)) & SLCAN_TIMER_WHEEL_MASK;
+        if(level != 0) start = (start + 1) & SLCAN_TIMER_WHEEL_MASK;
+
+        bits = (bits >> start) | (bits << ((SLCAN_TIMER_WHEEL_SLOTS - start) & SLCAN_TIMER_WHEEL_MASK));
+        index = (start + (unsigned int)__builtin_ctzll(bits)) & SLCAN_TIMER_WHEEL_MASK;
+
+        // the earliest slot of the level.
+        for(timer = wheel->slots[level][index]; timer != NULL; timer = timer->next){
+            if(timer->deadline_ns < deadline) deadline = timer->deadline_ns;
+        }
+    }
+
+    // postponed timers break the order of the top level - check all slots.
+    for(bits = wheel->bitmap[level]; bits != 0; bits &= bits - 1){
+        index = (unsigned int)__builtin_ctzll(bits);
+
+        for(timer = wheel->slots[level][index]; timer != NULL; timer = timer->next){
+            if(timer->deadline_ns < deadline) deadline = timer->deadline_ns;
+        }
+    }
+
+    *deadline_ns = deadline;
+
+    return true;
+}
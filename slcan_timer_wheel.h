@@ -0,0 +1,133 @@
+/**
+ * @file slcan_timer_wheel.h
+ * Иерархическое колесо таймеров со сроками в наносекундах.
+ */
+
+#ifndef SLCAN_TIMER_WHEEL_H_
+#define SLCAN_TIMER_WHEEL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "slcan_defs.h"
+#include "slcan_conf.h"
+
+
+//! Длительность тика колеса - степень двойки наносекунд.
+#ifndef SLCAN_TIMER_WHEEL_TICK_SHIFT
+#define SLCAN_TIMER_WHEEL_TICK_SHIFT SLCAN_TIMER_WHEEL_TICK_SHIFT_DEFAULT
+#endif
+
+//! Число бит индекса слота уровня.
+#define SLCAN_TIMER_WHEEL_BITS 6
+//! Число слотов уровня.
+#define SLCAN_TIMER_WHEEL_SLOTS (1U << SLCAN_TIMER_WHEEL_BITS)
+//! Маска индекса слота уровня.
+#define SLCAN_TIMER_WHEEL_MASK (SLCAN_TIMER_WHEEL_SLOTS - 1)
+//! Число уровней.
+//! Более дальние сроки откладываются на последний слот верхнего уровня.
+#define SLCAN_TIMER_WHEEL_LEVELS 4
+
+
+//! Структура таймера.
+typedef struct _Slcan_Timer {
+    struct _Slcan_Timer* next; //!< Следующий таймер слота.
+    struct _Slcan_Timer** pprev; //!< Ссылка на таймер, NULL - таймер не в колесе.
+    uint64_t deadline_ns; //!< Срок, нс.
+    unsigned int slot; //!< Уровень и индекс слота.
+} slcan_timer_t;
+
+//! Структура колеса таймеров.
+typedef struct _Slcan_Timer_Wheel {
+    uint64_t tick; //!< Текущий тик.
+    size_t count; //!< Число таймеров.
+    uint64_t bitmap[SLCAN_TIMER_WHEEL_LEVELS]; //!< Битовые карты непустых слотов.
+    slcan_timer_t* slots[SLCAN_TIMER_WHEEL_LEVELS][SLCAN_TIMER_WHEEL_SLOTS]; //!< Слоты.
+} slcan_timer_wheel_t;
+
+
+/**
+ * Инициализирует таймер.
+ * @param timer Таймер.
+ */
+ALWAYS_INLINE static void slcan_timer_init(slcan_timer_t* timer)
+{
+    timer->next = NULL;
+    timer->pprev = NULL;
+    timer->deadline_ns = 0;
+    timer->slot = 0;
+}
+
+/**
+ * Получает флаг нахождения таймера в колесе.
+ * @param timer Таймер.
+ * @return Флаг нахождения таймера в колесе.
+ */
+ALWAYS_INLINE static bool slcan_timer_pending(const slcan_timer_t* timer)
+{
+    return timer->pprev != NULL;
+}
+
+/**
+ * Получает срок таймера.
+ * @param timer Таймер.
+ * @return Срок, нс.
+ */
+ALWAYS_INLINE static uint64_t slcan_timer_deadline(const slcan_timer_t* timer)
+{
+    return timer->deadline_ns;
+}
+
+/**
+ * Инициализирует пустое колесо таймеров.
+ * @param wheel Колесо таймеров.
+ */
+EXTERN void slcan_timer_wheel_init(slcan_timer_wheel_t* wheel);
+
+/**
+ * Получает число таймеров в колесе.
+ * @param wheel Колесо таймеров.
+ * @return Число таймеров.
+ */
+ALWAYS_INLINE static size_t slcan_timer_wheel_count(const slcan_timer_wheel_t* wheel)
+{
+    return wheel->count;
+}
+
+/**
+ * Добавляет таймер в колесо.
+ * @param wheel Колесо таймеров.
+ * @param timer Таймер, не находящийся в колесе.
+ * @param deadline_ns Срок, нс.
+ * @param now_ns Текущее время, нс,
+ * используется только для пустого колеса.
+ */
+EXTERN void slcan_timer_wheel_add(slcan_timer_wheel_t* wheel, slcan_timer_t* timer, uint64_t deadline_ns, uint64_t now_ns);
+
+/**
+ * Удаляет таймер из колеса.
+ * @param wheel Колесо таймеров.
+ * @param timer Таймер в колесе.
+ */
+EXTERN void slcan_timer_wheel_del(slcan_timer_wheel_t* wheel, slcan_timer_t* timer);
+
+/**
+ * Продвигает колесо до текущего времени
+ * и извлекает один истёкший таймер.
+ * Таймеры извлекаются в порядке сроков.
+ * Пустые участки колеса пропускаются по битовым картам.
+ * @param wheel Колесо таймеров.
+ * @param now_ns Текущее время, нс.
+ * @return Истёкший таймер, NULL - если истёкших таймеров нет.
+ */
+EXTERN slcan_timer_t* slcan_timer_wheel_expire(slcan_timer_wheel_t* wheel, uint64_t now_ns);
+
+/**
+ * Получает точный ближайший срок таймеров.
+ * @param wheel Колесо таймеров.
+ * @param deadline_ns Ближайший срок, нс.
+ * @return Флаг наличия таймеров.
+ */
+EXTERN bool slcan_timer_wheel_next(const slcan_timer_wheel_t* wheel, uint64_t* deadline_ns);
+
+#endif /* SLCAN_TIMER_WHEEL_H_ */
@@ -7,6 +7,9 @@
 #define SLCAN_UTILS_H_
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <time.h>
 #include "slcan_defs.h"
 
 
@@ -92,5 +95,50 @@ ALWAYS_INLINE static uint8_t digit_hex_to_num(uint8_t digit)
                 ((TPU)->tv_nsec cmp (TPV)->tv_nsec) :\
                 ((TPU)->tv_sec cmp (TPV)->tv_sec))
 
+/**
+ * Преобразует метку времени в наносекунды.
+ * @param tp Метка времени.
+ * @return Число наносекунд.
+ */
+ALWAYS_INLINE static uint64_t slcan_timespec_to_ns(const struct timespec* tp)
+{
+    return (uint64_t)tp->tv_sec * 1000000000ULL + (uint64_t)tp->tv_nsec;
+}
+
+/**
+ * Преобразует тайм-аут в миллисекунды для poll
+ * с округлением вверх.
+ * @param tp Тайм-аут, NULL - бесконечное ожидание.
+ * @return Тайм-аут в миллисекундах, -1 - бесконечное ожидание.
+ */
+ALWAYS_INLINE static int slcan_timespec_to_poll_ms(const struct timespec* tp)
+{
+    if(tp == NULL) return -1;
+    if(tp->tv_sec < 0) return 0;
+    if(tp->tv_sec >= INT_MAX / 1000 - 1) return INT_MAX;
+
+    return (int)(tp->tv_sec * 1000 + (tp->tv_nsec + 999999) / 1000000);
+}
+
+/**
+ * Вычисляет оставшееся до срока время.
+ * @param tp_end Срок.
+ * @param tp_cur Текущее время.
+ * @param tp_remain Оставшееся время, нулевое после наступления срока.
+ * @return Флаг ненаступившего срока.
+ */
+ALWAYS_INLINE static bool slcan_timespec_remain(const struct timespec* tp_end, const struct timespec* tp_cur, struct timespec* tp_remain)
+{
+    if(slcan_timespec_cmp(tp_cur, tp_end, <)){
+        slcan_timespec_sub(tp_end, tp_cur, tp_remain);
+        return true;
+    }
+
+    tp_remain->tv_sec = 0;
+    tp_remain->tv_nsec = 0;
+
+    return false;
+}
+
 
 #endif /* SLCAN_UTILS_H_ */